@@ -0,0 +1,302 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "benchmark/benchmark.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+#include "core/Memory.h"
+#include "core/SubCircuit.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief Circuits shared by the benchmarks
+ *
+ * Each Build*() function adds a complete circuit to an empty Circuit: a Counter
+ * driving the circuit's inputs with a new, deterministic pattern every tick, and a
+ * Sink reading all of its outputs, so that every run of a benchmark does the same
+ * work. Build*() returns the number of components ticked per circuit tick.
+ */
+
+namespace bench
+{
+
+// outputs the bits of a counter that increments every tick
+class Counter final : public Component
+{
+public:
+    Counter( int bitCount )
+        : bitCount_( bitCount )
+    {
+        SetOutputCount( bitCount );
+    }
+
+protected:
+    virtual void Process( SignalBus const&, SignalBus& outputs ) override
+    {
+        for ( int i = 0; i < bitCount_; ++i )
+        {
+            // each group of 64 bits sees a different multiple of the count
+            onebit bit;
+            bit.value = ( ( count_ * ( 2 * ( i / 64 ) + 1 ) ) >> ( i % 64 ) ) & 1;
+            outputs.SetValue( i, bit );
+        }
+
+        // a large odd step flips high bits as often as low ones
+        count_ += 0x9E3779B97F4A7C15;
+    }
+
+private:
+    int bitCount_;
+    uint64_t count_ = 0;
+};
+
+// reads all of its inputs every tick
+class Sink final : public Component
+{
+public:
+    Sink( int bitCount )
+        : bitCount_( bitCount )
+    {
+        SetInputCount( bitCount );
+    }
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& ) override
+    {
+        int ones = 0;
+        for ( int i = 0; i < bitCount_; ++i )
+        {
+            auto bit = inputs.GetValue( i );
+            ones += bit != nullptr && bit->value;
+        }
+        benchmark::DoNotOptimize( ones );
+    }
+
+private:
+    int bitCount_;
+};
+
+// sum = a ^ b ^ cin, cout = ( a & b ) | ( cin & ( a ^ b ) )
+inline std::shared_ptr<SubCircuit> MakeFullAdder()
+{
+    auto adder = std::make_shared<SubCircuit>( std::vector<std::string>{ "a", "b", "cin" },
+                                               std::vector<std::string>{ "sum", "cout" } );
+
+    auto xor0 = std::make_shared<XorGate>();
+    auto xor1 = std::make_shared<XorGate>();
+    auto and0 = std::make_shared<AndGate>();
+    auto and1 = std::make_shared<AndGate>();
+    auto or0 = std::make_shared<OrGate>();
+
+    for ( auto gate : std::vector<std::shared_ptr<Component>>{ xor0, xor1, and0, and1, or0 } )
+    {
+        adder->AddComponent( gate );
+    }
+
+    adder->ConnectInToIn( "a", xor0, 0 );
+    adder->ConnectInToIn( "b", xor0, 1 );
+    adder->ConnectInToIn( "a", and0, 0 );
+    adder->ConnectInToIn( "b", and0, 1 );
+    adder->ConnectOutToIn( xor0, 0, xor1, 0 );
+    adder->ConnectInToIn( "cin", xor1, 1 );
+    adder->ConnectOutToIn( xor0, 0, and1, 0 );
+    adder->ConnectInToIn( "cin", and1, 1 );
+    adder->ConnectOutToIn( and0, 0, or0, 0 );
+    adder->ConnectOutToIn( and1, 0, or0, 1 );
+    adder->ConnectOutToOut( xor1, 0, "sum" );
+    adder->ConnectOutToOut( or0, 0, "cout" );
+
+    return adder;
+}
+
+// a bitCount-bit ripple-carry adder of full adder sub-circuits
+inline int BuildRippleCarryAdder( Circuit& circuit, int bitCount )
+{
+    auto counter = std::make_shared<Counter>( bitCount * 2 );
+    auto sink = std::make_shared<Sink>( bitCount + 1 );
+
+    circuit.AddComponent( counter );
+    circuit.AddComponent( sink );
+
+    auto fullAdder = MakeFullAdder();
+
+    std::shared_ptr<SubCircuit> previous;
+    for ( int i = 0; i < bitCount; ++i )
+    {
+        auto adder = fullAdder->Instantiate();
+        circuit.AddComponent( adder );
+
+        circuit.ConnectOutToIn( counter, i, adder, 0 );
+        circuit.ConnectOutToIn( counter, bitCount + i, adder, 1 );
+        if ( previous )
+        {
+            circuit.ConnectOutToIn( previous, 1, adder, 2 );
+        }
+        circuit.ConnectOutToIn( adder, 0, sink, i );
+
+        previous = adder;
+    }
+    circuit.ConnectOutToIn( previous, 1, sink, bitCount );
+
+    return 2 + bitCount * fullAdder->GetComponentCount();
+}
+
+// registerCount registers of width bits, with one write port and one read port (whose write
+// enable is tied to 0 by an unconnected AND gate if writeProtected)
+inline int BuildRegisterFile( Circuit& circuit, int registerCount, int width, bool writeProtected = false )
+{
+    int addressBits = 0;
+    while ( ( 1 << addressBits ) < registerCount )
+    {
+        ++addressBits;
+    }
+
+    // counter bits: data, write address, read address, write enable
+    int writeAddress = width;
+    int readAddress = writeAddress + addressBits;
+    int writeEnable = readAddress + addressBits;
+
+    auto counter = std::make_shared<Counter>( writeEnable + 1 );
+    auto sink = std::make_shared<Sink>( width );
+
+    circuit.AddComponent( counter );
+    circuit.AddComponent( sink );
+
+    int componentCount = 2;
+
+    auto add = [&circuit, &componentCount]( std::shared_ptr<Component> const& component ) {
+        circuit.AddComponent( component );
+        ++componentCount;
+        return component;
+    };
+
+    std::shared_ptr<Component> writeEnabler = counter;
+    if ( writeProtected )
+    {
+        writeEnabler = add( std::make_shared<AndGate>() );
+    }
+
+    std::vector<std::shared_ptr<Component>> addressNots;
+    for ( int i = 0; i < addressBits * 2; ++i )
+    {
+        auto notGate = add( std::make_shared<NotGate>() );
+        circuit.ConnectOutToIn( counter, writeAddress + i, notGate, 0 );
+        addressNots.emplace_back( notGate );
+    }
+
+    // ANDs the address bits (or their inverse) selecting register r onto select
+    auto decode = [&]( std::shared_ptr<Component> select, int selectOutput, int address, int r ) {
+        for ( int i = 0; i < addressBits; ++i )
+        {
+            auto andGate = add( std::make_shared<AndGate>() );
+            circuit.ConnectOutToIn( select, selectOutput, andGate, 0 );
+            if ( ( r >> i ) & 1 )
+            {
+                circuit.ConnectOutToIn( counter, address + i, andGate, 1 );
+            }
+            else
+            {
+                circuit.ConnectOutToIn( addressNots[address - writeAddress + i], 0, andGate, 1 );
+            }
+            select = andGate;
+            selectOutput = 0;
+        }
+        return select;
+    };
+
+    std::vector<std::shared_ptr<Component>> readBits( width );
+
+    for ( int r = 0; r < registerCount; ++r )
+    {
+        auto writeSelect = decode( writeEnabler, writeProtected ? 0 : writeEnable, writeAddress, r );
+        auto writeNotSelect = add( std::make_shared<NotGate>() );
+        circuit.ConnectOutToIn( writeSelect, 0, writeNotSelect, 0 );
+
+        auto readEnable = add( std::make_shared<BufGate>() );
+        circuit.ConnectOutToIn( counter, writeEnable, readEnable, 0 );
+        auto readSelect = decode( readEnable, 0, readAddress, r );
+
+        for ( int b = 0; b < width; ++b )
+        {
+            // q = ( select & d ) | ( !select & q )
+            auto load = add( std::make_shared<AndGate>() );
+            auto hold = add( std::make_shared<AndGate>() );
+            auto q = add( std::make_shared<OrGate>() );
+
+            circuit.ConnectOutToIn( writeSelect, 0, load, 0 );
+            circuit.ConnectOutToIn( counter, b, load, 1 );
+            circuit.ConnectOutToIn( writeNotSelect, 0, hold, 0 );
+            circuit.ConnectOutToIn( q, 0, hold, 1 );
+            circuit.ConnectOutToIn( load, 0, q, 0 );
+            circuit.ConnectOutToIn( hold, 0, q, 1 );
+
+            // read port: OR together every register's bit b ANDed with its read select
+            auto read = add( std::make_shared<AndGate>() );
+            circuit.ConnectOutToIn( readSelect, 0, read, 0 );
+            circuit.ConnectOutToIn( q, 0, read, 1 );
+
+            if ( readBits[b] )
+            {
+                auto orGate = add( std::make_shared<OrGate>() );
+                circuit.ConnectOutToIn( readBits[b], 0, orGate, 0 );
+                circuit.ConnectOutToIn( read, 0, orGate, 1 );
+                readBits[b] = orGate;
+            }
+            else
+            {
+                readBits[b] = read;
+            }
+        }
+    }
+
+    for ( int b = 0; b < width; ++b )
+    {
+        circuit.ConnectOutToIn( readBits[b], 0, sink, b );
+    }
+
+    return componentCount;
+}
+
+// a native Memory of registerCount words of width bits, with a single address port
+inline int BuildMemory( Circuit& circuit, int registerCount, int width )
+{
+    int addressBits = 0;
+    while ( ( 1 << addressBits ) < registerCount )
+    {
+        ++addressBits;
+    }
+
+    auto memory = std::make_shared<Memory>( addressBits, width );
+
+    // counter bits: address, data, set, enable
+    auto counter = std::make_shared<Counter>( memory->GetInputCount() );
+    auto sink = std::make_shared<Sink>( width );
+
+    circuit.AddComponent( counter );
+    circuit.AddComponent( memory );
+    circuit.AddComponent( sink );
+
+    for ( int i = 0; i < memory->GetInputCount(); ++i )
+    {
+        circuit.ConnectOutToIn( counter, i, memory, i );
+    }
+    for ( int b = 0; b < width; ++b )
+    {
+        circuit.ConnectOutToIn( memory, b, sink, b );
+    }
+
+    return 3;
+}
+
+}  // namespace bench
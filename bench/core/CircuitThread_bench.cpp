@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "core/Circuit.h"
+
+/**
+ * @brief Benchmarks for CircuitThread hand-over latency
+ *
+ * Ticks a multi-buffered circuit holding a single trivial component, so that the
+ * time per tick is dominated by handing control to each buffer's thread and back,
+ * for every Circuit::SyncPolicy. Run with a dedicated core per buffer thread when
+ * comparing SyncPolicy::BusyPoll, as it never yields the CPU.
+ */
+
+namespace
+{
+
+class Inverter final : public Component
+{
+public:
+    Inverter()
+    {
+        SetInputCount( 1 );
+        SetOutputCount( 1 );
+    }
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override
+    {
+        auto in = inputs.GetValue( 0 );
+        onebit out;
+        out.value = in == nullptr || !in->value;
+        outputs.SetValue( 0, out );
+    }
+};
+
+}  // namespace
+
+static void BM_CircuitThread_TickLatency( benchmark::State& state )
+{
+    auto policy = (Circuit::SyncPolicy)state.range( 0 );
+    int bufferCount = state.range( 1 );
+
+    Circuit circuit;
+    auto inverter = std::make_shared<Inverter>();
+    circuit.AddComponent( inverter );
+    circuit.ConnectOutToIn( inverter, 0, inverter, 0 );
+
+    circuit.SetSyncPolicy( policy );
+    circuit.SetBufferCount( bufferCount );
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    circuit.SetBufferCount( 0 );
+
+    state.counters["ticks"] = benchmark::Counter( (double)state.iterations(), benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_CircuitThread_TickLatency )
+    ->ArgNames( { "policy", "buffers" } )
+    ->ArgsProduct( { { (int)Circuit::SyncPolicy::Blocking, (int)Circuit::SyncPolicy::Adaptive, (int)Circuit::SyncPolicy::BusyPoll },
+                     { 1, 2 } } )
+    ->UseRealTime();
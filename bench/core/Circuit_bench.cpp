@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "BenchCircuits.h"
+
+/**
+ * @brief Benchmarks for full circuit ticks
+ *
+ * Ticks ripple-carry adders and register files of several sizes in every tick
+ * mode and at several buffer counts. "ticks" counts circuit ticks per second, and
+ * "components" the components ticked per second ("clusters" is the number of
+ * clusters that TickMode::Parallel splits the circuit into). The first few ticks
+ * compile the circuit and warm it up, and are not timed. The remaining benchmarks
+ * each time one Circuit feature.
+ */
+
+namespace
+{
+
+void tickCircuit( benchmark::State& state, Circuit& circuit, int componentCount )
+{
+    auto mode = (Component::TickMode)state.range( 0 );
+    int bufferCount = state.range( 1 );
+
+    circuit.SetBufferCount( bufferCount );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( mode );
+    }
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( mode );
+    }
+
+    circuit.SetBufferCount( 0 );
+
+    state.counters["ticks"] = benchmark::Counter( (double)state.iterations(), benchmark::Counter::kIsRate );
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+    state.counters["clusters"] = circuit.GetClusterCount();
+}
+
+}  // namespace
+
+static void BM_Circuit_RippleCarryAdder( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = bench::BuildRippleCarryAdder( circuit, state.range( 2 ) );
+
+    tickCircuit( state, circuit, componentCount );
+}
+
+static void BM_Circuit_RegisterFile( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = bench::BuildRegisterFile( circuit, state.range( 2 ), state.range( 3 ) );
+
+    tickCircuit( state, circuit, componentCount );
+}
+
+BENCHMARK( BM_Circuit_RippleCarryAdder )
+    ->ArgNames( { "mode", "buffers", "bits" } )
+    ->ArgsProduct( { { (int)Component::TickMode::Series, (int)Component::TickMode::Parallel, (int)Component::TickMode::EventDriven },
+                     { 1, 4 },
+                     { 8, 32, 128 } } )
+    ->UseRealTime();
+
+BENCHMARK( BM_Circuit_RegisterFile )
+    ->ArgNames( { "mode", "buffers", "registers", "width" } )
+    ->Apply( []( benchmark::internal::Benchmark* b ) {
+        for ( int mode : { (int)Component::TickMode::Series, (int)Component::TickMode::Parallel, (int)Component::TickMode::EventDriven } )
+        {
+            for ( int bufferCount : { 1, 4 } )
+            {
+                // registers x width: 4 x 8, 16 x 16, 32 x 32
+                for ( int size : { 4, 16, 32 } )
+                {
+                    b->Args( { mode, bufferCount, size, size == 4 ? 8 : size } );
+                }
+            }
+        }
+    } )
+    ->UseRealTime();
+
+// restores a register file's state, as done before every test run started from a checkpoint
+static void BM_Circuit_RestoreState( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = bench::BuildRegisterFile( circuit, state.range( 0 ), state.range( 1 ) );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+    auto savedState = circuit.SaveState();
+
+    for ( auto _ : state )
+    {
+        circuit.RestoreState( savedState );
+    }
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+    state.counters["bytes"] = savedState.size() * sizeof( uint64_t );
+}
+
+BENCHMARK( BM_Circuit_RestoreState )
+    ->ArgNames( { "registers", "width" } )
+    ->Args( { 16, 16 } )
+    ->Args( { 32, 32 } );
+
+// 64 ticks of a small adder per iteration, via 64 calls to Circuit::Tick() or one to TickN()
+static void BM_Circuit_TickN( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = bench::BuildRippleCarryAdder( circuit, 4 );
+
+    int bufferCount = state.range( 0 );
+    bool batched = state.range( 1 ) != 0;
+
+    circuit.SetBufferCount( bufferCount );
+    circuit.TickN( 16, Component::TickMode::Series );
+
+    for ( auto _ : state )
+    {
+        if ( batched )
+        {
+            circuit.TickN( 64, Component::TickMode::Series );
+        }
+        else
+        {
+            for ( int i = 0; i < 64; ++i )
+            {
+                circuit.Tick( Component::TickMode::Series );
+            }
+        }
+    }
+
+    circuit.SetBufferCount( 0 );
+
+    state.counters["ticks"] = benchmark::Counter( (double)state.iterations() * 64, benchmark::Counter::kIsRate );
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * 64 * componentCount, benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_Circuit_TickN )->ArgNames( { "buffers", "batched" } )->ArgsProduct( { { 0, 4 }, { 0, 1 } } )->UseRealTime();
+
+// a write-protected register file with and without Circuit::SetOptimizeLogic(), reporting
+// how many gates were "folded" and found "dead" ("components" still counts every component)
+static void BM_Circuit_OptimizeLogic( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = bench::BuildRegisterFile( circuit, state.range( 2 ), state.range( 2 ), true );
+
+    circuit.SetOptimizeLogic( state.range( 1 ) != 0 );
+
+    auto mode = (Component::TickMode)state.range( 0 );
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( mode );
+    }
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( mode );
+    }
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+    state.counters["folded"] = circuit.GetFoldedGateCount();
+    state.counters["dead"] = circuit.GetDeadGateCount();
+}
+
+BENCHMARK( BM_Circuit_OptimizeLogic )
+    ->ArgNames( { "mode", "optimize", "registers" } )
+    ->ArgsProduct( { { (int)Component::TickMode::Series, (int)Component::TickMode::EventDriven }, { 0, 1 }, { 16, 32 } } )
+    ->UseRealTime();
+
+// ripple-carry adders with gates mapped onto LUTs of up to "inputs" inputs (0 for none),
+// reporting the "nodes" still ticked
+static void BM_Circuit_Lut( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = bench::BuildRippleCarryAdder( circuit, state.range( 2 ) );
+
+    circuit.SetLutInputCount( state.range( 1 ) );
+
+    auto mode = (Component::TickMode)state.range( 0 );
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( mode );
+    }
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( mode );
+    }
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+    state.counters["nodes"] = componentCount - ( circuit.GetLutGateCount() - circuit.GetLutCount() );
+}
+
+BENCHMARK( BM_Circuit_Lut )
+    ->ArgNames( { "mode", "inputs", "bits" } )
+    ->ArgsProduct( { { (int)Component::TickMode::Series, (int)Component::TickMode::EventDriven }, { 0, 4, 6 }, { 32, 128 } } )
+    ->UseRealTime();
+
+// Series ticks with and without Circuit::SetCodegen() ("native" is 0 if no generated code
+// could be loaded), not timing the one-time cost of building the generated code
+static void BM_Circuit_Codegen( benchmark::State& state )
+{
+    Circuit circuit;
+    int componentCount = state.range( 1 ) == 0 ? bench::BuildRippleCarryAdder( circuit, 128 ) : bench::BuildRegisterFile( circuit, 32, 32 );
+
+    circuit.SetCodegen( state.range( 0 ) != 0 );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+    state.counters["native"] = circuit.IsNative();
+}
+
+// circuit 0: 128-bit ripple-carry adder, 1: 32 x 32 register file
+BENCHMARK( BM_Circuit_Codegen )->ArgNames( { "codegen", "circuit" } )->ArgsProduct( { { 0, 1 }, { 0, 1 } } )->UseRealTime();
@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "core/Component.h"
+
+#include <vector>
+
+/**
+ * @brief Benchmarks for Component class
+ *
+ * Ticks and resets a chain of components directly, without a Circuit, so that each
+ * tick walks the chain via Component::Tick()'s own recursion. "components" counts
+ * components ticked and reset per second.
+ */
+
+namespace
+{
+
+class Inverter final : public Component
+{
+public:
+    Inverter()
+    {
+        SetInputCount( 1 );
+        SetOutputCount( 1 );
+    }
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override
+    {
+        auto in = inputs.GetValue( 0 );
+        onebit out;
+        out.value = in == nullptr || !in->value;
+        outputs.SetValue( 0, out );
+    }
+};
+
+}  // namespace
+
+static void BM_Component_TickReset( benchmark::State& state )
+{
+    auto mode = (Component::TickMode)state.range( 0 );
+    int chainLength = state.range( 1 );
+
+    // the first inverter is fed back from the last, so the chain toggles every tick
+    std::vector<std::shared_ptr<Component>> chain;
+    for ( int i = 0; i < chainLength; ++i )
+    {
+        chain.emplace_back( std::make_shared<Inverter>() );
+        if ( i != 0 )
+        {
+            chain[i]->ConnectInput( chain[i - 1], 0, 0 );
+        }
+    }
+    chain[0]->ConnectInput( chain.back(), 0, 0 );
+
+    for ( auto _ : state )
+    {
+        chain.back()->Tick( mode );
+        for ( auto& component : chain )
+        {
+            component->Reset();
+        }
+    }
+
+    // break the feedback cycle of shared_ptrs
+    chain[0]->DisconnectAllInputs();
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * chainLength, benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_Component_TickReset )
+    ->ArgNames( { "mode", "components" } )
+    ->ArgsProduct( { { (int)Component::TickMode::Series, (int)Component::TickMode::Parallel }, { 1, 16, 256 } } )
+    ->UseRealTime();
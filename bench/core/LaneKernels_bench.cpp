@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "core/internal/LaneKernels.h"
+
+#include <vector>
+
+/**
+ * @brief Benchmarks for LaneKernels class
+ *
+ * Evaluates one level of 1024 NAND gates, each reading two gates of the previous 
+ * level, for every supported instruction set and lane count. "instances" counts 
+ * circuit instances (lanes) evaluated per second.
+ */
+
+using internal::LaneKernels;
+
+static void BM_LaneKernels_NandLevel( benchmark::State& state )
+{
+    auto isa = (LaneKernels::Isa)state.range( 0 );
+    int laneCount = state.range( 1 );
+    int wordCount = laneCount / 64;
+    const int gateCount = 1024;
+
+    if ( LaneKernels::SetIsa( isa ) != isa )
+    {
+        state.SkipWithError( "instruction set not supported by this CPU" );
+        return;
+    }
+
+    std::vector<uint64_t> previousLevel( gateCount * wordCount, 0x5555555555555555 );
+    std::vector<uint64_t> level( gateCount * wordCount );
+
+    std::vector<internal::LaneGate> gates( gateCount );
+    for ( int g = 0; g < gateCount; ++g )
+    {
+        gates[g].out_ = &level[g * wordCount];
+        gates[g].in0_ = &previousLevel[g * wordCount];
+        gates[g].in1_ = &previousLevel[( ( g * 7 + 3 ) % gateCount ) * wordCount];
+    }
+
+    for ( auto _ : state )
+    {
+        LaneKernels::EvaluateBatch( internal::LaneOp::Nand, gates.data(), gateCount, wordCount );
+        benchmark::DoNotOptimize( level.data() );
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["instances"] = benchmark::Counter( (double)state.iterations() * laneCount, benchmark::Counter::kIsRate );
+    state.counters["gates"] = benchmark::Counter( (double)state.iterations() * laneCount * gateCount, benchmark::Counter::kIsRate );
+
+    LaneKernels::SetIsa( LaneKernels::GetSupportedIsa() );
+}
+
+BENCHMARK( BM_LaneKernels_NandLevel )
+    ->ArgNames( { "isa", "lanes" } )
+    ->ArgsProduct( { { (int)LaneKernels::Isa::Scalar, (int)LaneKernels::Isa::Avx2, (int)LaneKernels::Isa::Avx512 },
+                     { 64, 256, 512 } } );
@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "BenchCircuits.h"
+
+#include <cstdio>
+
+/**
+ * @brief Benchmarks for Memory
+ *
+ * Compares ticking a memory built out of gates (a register file) with ticking
+ * a native Memory of the same size, and times loading a whole image into a 
+ * Memory from a file. "ticks" counts circuit ticks per second, and "bytes" the
+ * bytes loaded per second.
+ */
+
+namespace
+{
+
+const std::string imagePath = "scottcpu_Memory_bench.bin";
+
+void memoryArgs( benchmark::internal::Benchmark* b )
+{
+    // registers x width: 16 x 8, 256 x 8
+    b->ArgNames( { "registers", "width" } )->Args( { 16, 8 } )->Args( { 256, 8 } );
+}
+
+void tickCircuit( benchmark::State& state, Circuit& circuit )
+{
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    state.counters["ticks"] = benchmark::Counter( (double)state.iterations(), benchmark::Counter::kIsRate );
+}
+
+}  // namespace
+
+static void BM_Memory_Gates( benchmark::State& state )
+{
+    Circuit circuit;
+    bench::BuildRegisterFile( circuit, state.range( 0 ), state.range( 1 ) );
+
+    tickCircuit( state, circuit );
+}
+
+static void BM_Memory_Native( benchmark::State& state )
+{
+    Circuit circuit;
+    bench::BuildMemory( circuit, state.range( 0 ), state.range( 1 ) );
+
+    tickCircuit( state, circuit );
+}
+
+static void BM_Memory_LoadImage( benchmark::State& state )
+{
+    Memory memory( state.range( 0 ) );
+
+    std::vector<uint8_t> image( memory.GetSize() );
+    for ( size_t i = 0; i < image.size(); ++i )
+    {
+        image[i] = (uint8_t)i;
+    }
+    if ( !memory.LoadImage( image ) || !memory.Dump( imagePath ) )
+    {
+        state.SkipWithError( "could not write image" );
+        return;
+    }
+
+    for ( auto _ : state )
+    {
+        if ( !memory.LoadImage( imagePath ) )
+        {
+            state.SkipWithError( "could not load image" );
+            break;
+        }
+    }
+
+    std::remove( imagePath.c_str() );
+
+    state.counters["bytes"] = benchmark::Counter( (double)state.iterations() * memory.GetSize(), benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_Memory_Gates )->Apply( memoryArgs );
+
+BENCHMARK( BM_Memory_Native )->Apply( memoryArgs );
+
+BENCHMARK( BM_Memory_LoadImage )->ArgName( "addressBits" )->Arg( 8 )->Arg( 16 );
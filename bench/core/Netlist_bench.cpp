@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "BenchCircuits.h"
+
+#include "core/Netlist.h"
+
+#include <cstdio>
+
+/**
+ * @brief Benchmarks for Netlist
+ *
+ * Compares building a register file through Circuit::AddComponent() and
+ * ConnectOutToIn() with loading the same circuit from a netlist file.
+ * "components" counts the components built or loaded per second.
+ */
+
+namespace
+{
+
+const std::string netlistPath = "scottcpu_Netlist_bench.net";
+
+void registerFileArgs( benchmark::internal::Benchmark* b )
+{
+    // registers x width: 16 x 16, 64 x 32, 256 x 32
+    b->ArgNames( { "registers", "width" } )->Args( { 16, 16 } )->Args( { 64, 32 } )->Args( { 256, 32 } );
+}
+
+}  // namespace
+
+static void BM_Netlist_Build( benchmark::State& state )
+{
+    int componentCount = 0;
+
+    for ( auto _ : state )
+    {
+        Circuit circuit;
+        componentCount = bench::BuildRegisterFile( circuit, state.range( 0 ), state.range( 1 ) );
+    }
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+}
+
+static void BM_Netlist_Load( benchmark::State& state )
+{
+    int registerCount = state.range( 0 );
+    int width = state.range( 1 );
+
+    int componentCount;
+    {
+        Circuit circuit;
+        componentCount = bench::BuildRegisterFile( circuit, registerCount, width );
+        if ( !Netlist::Write( circuit, netlistPath ) )
+        {
+            state.SkipWithError( "could not write netlist" );
+            return;
+        }
+    }
+
+    // the counter drives data, 2 addresses and a write enable
+    int addressBits = 0;
+    while ( ( 1 << addressBits ) < registerCount )
+    {
+        ++addressBits;
+    }
+
+    Netlist netlist;
+    netlist.RegisterType( typeid( bench::Counter ), [=] { return std::make_shared<bench::Counter>( width + addressBits * 2 + 1 ); } );
+    netlist.RegisterType( typeid( bench::Sink ), [=] { return std::make_shared<bench::Sink>( width ); } );
+
+    for ( auto _ : state )
+    {
+        Circuit circuit;
+        if ( !netlist.Load( netlistPath, circuit ) )
+        {
+            state.SkipWithError( "could not load netlist" );
+            break;
+        }
+    }
+
+    std::remove( netlistPath.c_str() );
+
+    state.counters["components"] = benchmark::Counter( (double)state.iterations() * componentCount, benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_Netlist_Build )->Apply( registerFileArgs )->Unit( benchmark::kMillisecond );
+
+BENCHMARK( BM_Netlist_Load )->Apply( registerFileArgs )->Unit( benchmark::kMillisecond );
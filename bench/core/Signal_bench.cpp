@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "core/Signal.h"
+#include "core/SignalBus.h"
+
+/**
+ * @brief Benchmarks for Signal and SignalBus classes
+ *
+ * Bus benchmarks operate on every signal of a bus per iteration, so "signals"
+ * counts signals set, read, copied, moved or compared per second.
+ * BM_SignalBus_CopyBytes compares carrying bytes over 8 onebit signals each with
+ * carrying them as words, where "bytes" counts bytes copied per second.
+ */
+
+static void BM_Signal_SetGetValue( benchmark::State& state )
+{
+    Signal signal;
+    onebit bit;
+    bit.value = 0;
+
+    for ( auto _ : state )
+    {
+        bit.value = !bit.value;
+        signal.SetValue( bit );
+        benchmark::DoNotOptimize( signal.GetValue() );
+    }
+}
+
+static void BM_Signal_CopySignal( benchmark::State& state )
+{
+    auto from = std::make_shared<Signal>();
+    Signal to;
+    onebit bit;
+    bit.value = 1;
+    from->SetValue( bit );
+
+    for ( auto _ : state )
+    {
+        benchmark::DoNotOptimize( to.CopySignal( from ) );
+    }
+}
+
+static void BM_SignalBus_SetGetValue( benchmark::State& state )
+{
+    int signalCount = state.range( 0 );
+
+    SignalBus bus;
+    bus.SetSignalCount( signalCount );
+
+    onebit bit;
+    bit.value = 0;
+
+    for ( auto _ : state )
+    {
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            bit.value = !bit.value;
+            bus.SetValue( i, bit );
+        }
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            benchmark::DoNotOptimize( bus.GetValue( i ) );
+        }
+    }
+
+    state.counters["signals"] = benchmark::Counter( (double)state.iterations() * signalCount, benchmark::Counter::kIsRate );
+}
+
+static void fillBus( SignalBus& bus, int signalCount )
+{
+    bus.SetSignalCount( signalCount );
+    for ( int i = 0; i < signalCount; ++i )
+    {
+        onebit bit;
+        bit.value = i & 1;
+        bus.SetValue( i, bit );
+    }
+}
+
+static void BM_SignalBus_CopySignal( benchmark::State& state )
+{
+    int signalCount = state.range( 0 );
+
+    SignalBus from, to;
+    fillBus( from, signalCount );
+    to.SetSignalCount( signalCount );
+
+    for ( auto _ : state )
+    {
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            to.CopySignal( i, from, i );
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["signals"] = benchmark::Counter( (double)state.iterations() * signalCount, benchmark::Counter::kIsRate );
+}
+
+static void BM_SignalBus_MoveSignal( benchmark::State& state )
+{
+    int signalCount = state.range( 0 );
+
+    SignalBus from, to;
+    fillBus( from, signalCount );
+    to.SetSignalCount( signalCount );
+
+    // move back and forth, so that there is always a value to move
+    for ( auto _ : state )
+    {
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            to.MoveSignal( i, from, i );
+        }
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            from.MoveSignal( i, to, i );
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["signals"] = benchmark::Counter( (double)state.iterations() * signalCount * 2, benchmark::Counter::kIsRate );
+}
+
+static void BM_SignalBus_UpdateSignal( benchmark::State& state )
+{
+    int signalCount = state.range( 0 );
+
+    SignalBus from, to;
+    fillBus( from, signalCount );
+    fillBus( to, signalCount );
+
+    // inputs are mostly unchanged between event-driven ticks, so compare equal values
+    for ( auto _ : state )
+    {
+        int changed = 0;
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            changed += to.UpdateSignal( i, from, i );
+        }
+        benchmark::DoNotOptimize( changed );
+    }
+
+    state.counters["signals"] = benchmark::Counter( (double)state.iterations() * signalCount, benchmark::Counter::kIsRate );
+}
+
+static void BM_SignalBus_ClearAllValues( benchmark::State& state )
+{
+    int signalCount = state.range( 0 );
+
+    SignalBus bus;
+    fillBus( bus, signalCount );
+
+    for ( auto _ : state )
+    {
+        bus.ClearAllValues();
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["signals"] = benchmark::Counter( (double)state.iterations() * signalCount, benchmark::Counter::kIsRate );
+}
+
+static void BM_SignalBus_CopyBytes( benchmark::State& state )
+{
+    int byteCount = state.range( 0 );
+    bool asWords = state.range( 1 ) != 0;
+    int signalCount = asWords ? byteCount : byteCount * 8;
+
+    SignalBus from, to;
+    if ( asWords )
+    {
+        from.SetSignalCount( signalCount );
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            from.SetWord( i, i & 0xFF );
+        }
+    }
+    else
+    {
+        fillBus( from, signalCount );
+    }
+    to.SetSignalCount( signalCount );
+
+    for ( auto _ : state )
+    {
+        for ( int i = 0; i < signalCount; ++i )
+        {
+            to.CopySignal( i, from, i );
+        }
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["bytes"] = benchmark::Counter( (double)state.iterations() * byteCount, benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_Signal_SetGetValue );
+BENCHMARK( BM_Signal_CopySignal );
+BENCHMARK( BM_SignalBus_SetGetValue )->ArgName( "signals" )->Arg( 2 )->Arg( 64 )->Arg( 1024 );
+BENCHMARK( BM_SignalBus_CopySignal )->ArgName( "signals" )->Arg( 2 )->Arg( 64 )->Arg( 1024 );
+BENCHMARK( BM_SignalBus_MoveSignal )->ArgName( "signals" )->Arg( 2 )->Arg( 64 )->Arg( 1024 );
+BENCHMARK( BM_SignalBus_UpdateSignal )->ArgName( "signals" )->Arg( 2 )->Arg( 64 )->Arg( 1024 );
+BENCHMARK( BM_SignalBus_ClearAllValues )->ArgName( "signals" )->Arg( 2 )->Arg( 64 )->Arg( 1024 );
+BENCHMARK( BM_SignalBus_CopyBytes )->ArgNames( { "bytes", "words" } )->ArgsProduct( { { 8, 128 }, { 0, 1 } } );
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "BenchCircuits.h"
+
+#include "core/VcdWriter.h"
+
+#include <cstdio>
+
+/**
+ * @brief Benchmarks for VcdWriter
+ *
+ * Records a counter whose bits change about half the time, with the VcdWriter's
+ * file open ("recording" = 1) or closed. The difference is the cost recording adds
+ * to each circuit tick; "changes" counts the value changes recorded per second.
+ */
+
+static void BM_VcdWriter_Record( benchmark::State& state )
+{
+    int bitCount = state.range( 0 );
+    bool recording = state.range( 1 ) != 0;
+
+    Circuit circuit;
+    auto counter = std::make_shared<bench::Counter>( bitCount );
+    auto writer = std::make_shared<VcdWriter>();
+    circuit.AddComponent( counter );
+    circuit.AddComponent( writer );
+    for ( int i = 0; i < bitCount; ++i )
+    {
+        writer->AddSignal( "counter.bit" + std::to_string( i ) );
+        circuit.ConnectOutToIn( counter, i, writer, i );
+    }
+
+    std::string path = "scottcpu_VcdWriter_bench.vcd";
+    if ( recording && !writer->Open( path ) )
+    {
+        state.SkipWithError( "could not open VCD file" );
+        return;
+    }
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    for ( auto _ : state )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    writer->Close();
+    std::remove( path.c_str() );
+
+    state.counters["ticks"] = benchmark::Counter( (double)state.iterations(), benchmark::Counter::kIsRate );
+    state.counters["changes"] = benchmark::Counter( recording ? (double)state.iterations() * bitCount / 2 : 0.0,
+                                                    benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_VcdWriter_Record )
+    ->ArgNames( { "bits", "recording" } )
+    ->ArgsProduct( { { 8, 64, 256 }, { 0, 1 } } )
+    ->UseRealTime();
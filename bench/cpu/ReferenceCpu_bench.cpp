@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "benchmark/benchmark.h"
+
+#include "cpu/ReferenceCpu.h"
+
+/**
+ * @brief Benchmarks for ReferenceCpu
+ *
+ * Runs a loop of ALU, load, store and jump instructions, 1000 instructions per 
+ * iteration. "instructions" counts instructions executed per second.
+ */
+
+static void BM_ReferenceCpu_Run( benchmark::State& state )
+{
+    // R0 counts up, R3 accumulates the XOR of every count via RAM at 0x80, restarting whenever R3 is 0
+    std::vector<uint8_t> program = {
+        0x20, 0x00,  //  0: DATA R0, 0
+        0x21, 0x01,  //  2: DATA R1, 1
+        0x22, 0x80,  //  4: DATA R2, 0x80
+        0x60,        //  6: CLF
+        0x84,        //  7: ADD R1, R0
+        0xE3,        //  8: XOR R0, R3 (R3 = R3 ^ R0)
+        0x1B,        //  9: ST R2, R3
+        0x0B,        // 10: LD R2, R3
+        0x51, 0x00,  // 11: JZ 0
+        0x40, 0x06,  // 13: JMP 6
+    };
+
+    ReferenceCpu::State initial;
+    std::copy( program.begin(), program.end(), initial.ram.begin() );
+
+    ReferenceCpu cpu;
+    cpu.SetState( initial );
+
+    for ( auto _ : state )
+    {
+        cpu.Run( 1000 );
+    }
+
+    benchmark::DoNotOptimize( cpu.GetState().registers );
+
+    state.counters["instructions"] = benchmark::Counter( (double)state.iterations() * 1000, benchmark::Counter::kIsRate );
+}
+
+BENCHMARK( BM_ReferenceCpu_Run );
@@ -8,27 +8,21 @@
  */
 
 #include "Circuit.h"
-#include "internal/AutoTickThread.h"
-#include "internal/CircuitThread.h"
+#include "Gate.h"
+#include "SubCircuit.h"
+#include "VcdWriter.h"
+#include "internal/Circuit.h"
+#include "internal/Component.h"
+#include "internal/SubCircuit.h"
 
-namespace internal
-{
-
-class Circuit
-{
-public:
-    bool FindComponent(const std::shared_ptr<::Component const>& component, int& returnIndex) const;
-
-    int pauseCount_ = 0;
-    int currentThreadNo_ = 0;
+#ifdef SCOTTCPU_TRACE
+#include "internal/Trace.h"
+#endif
 
-    AutoTickThread autoTickThread_;
-
-    std::vector<std::shared_ptr<::Component>> components_;
-    std::vector<std::unique_ptr<CircuitThread>> circuitThreads_;
-};
-
-}  // namespace internal
+#include <algorithm>
+#include <cstdio>
+#include <unordered_map>
+#include <unordered_set>
 
 Circuit::Circuit()
 {
@@ -55,9 +49,11 @@ int Circuit::AddComponent(const std::shared_ptr<Component>& component)
 
         // components within the circuit need to have as many buffers as there are threads in the circuit
         component->SetBufferCount( p_->circuitThreads_.size() );
+        component->SetLaneCount( p_->laneCount_ );
 
         PauseAutoTick();
         p_->components_.emplace_back( component );
+        p_->compiled_ = false;
         ResumeAutoTick();
 
         return p_->components_.size() - 1;
@@ -84,18 +80,35 @@ void Circuit::RemoveComponent(int componentIndex)
 
     if (!p_->components_.empty())
     {
+        auto component = p_->components_[componentIndex].get();
+        auto& watched = p_->watched_;
+        watched.erase( std::remove_if( watched.begin(), watched.end(),
+                                       [component]( std::pair<::Component*, int> const& watch ) { return watch.first == component; } ),
+                       watched.end() );
+
         p_->components_.erase(p_->components_.begin() + componentIndex);
     }
 
+    p_->compiled_ = false;
+
     ResumeAutoTick();
 }
 
 void Circuit::RemoveAllComponents()
 {
-    for (size_t i = 0; i < p_->components_.size(); ++i)
+    PauseAutoTick();
+
+    // with every component going, each need only drop its own input wires
+    for ( auto& component : p_->components_ )
     {
-        RemoveComponent( i-- );  // size drops as one is removed
+        component->DisconnectAllInputs();
     }
+
+    p_->components_.clear();
+    p_->watched_.clear();
+    p_->compiled_ = false;
+
+    ResumeAutoTick();
 }
 
 int Circuit::GetComponentCount() const
@@ -146,6 +159,7 @@ bool Circuit::ConnectOutToIn(int fromComponent, int fromOutput, int toComponent,
 
     PauseAutoTick();
     bool result = p_->components_[toComponent]->ConnectInput( p_->components_[fromComponent], fromOutput, toInput );
+    p_->compiled_ = false;
     ResumeAutoTick();
 
     return result;
@@ -174,6 +188,8 @@ void Circuit::DisconnectComponent( int componentIndex )
         component->DisconnectInput( p_->components_[componentIndex] );
     }
 
+    p_->compiled_ = false;
+
     ResumeAutoTick();
 }
 
@@ -199,7 +215,8 @@ void Circuit::SetBufferCount( int bufferCount )
             {
                 p_->circuitThreads_[i] = std::unique_ptr<internal::CircuitThread>( new internal::CircuitThread() );
             }
-            p_->circuitThreads_[i]->Start( &p_->components_, i );
+            p_->circuitThreads_[i]->SetSyncPolicy( p_->syncPolicy_ );
+            p_->circuitThreads_[i]->Start( p_.get(), i );
         }
 
         // set all components to the new buffer count
@@ -208,6 +225,9 @@ void Circuit::SetBufferCount( int bufferCount )
             component->SetBufferCount( bufferCount );
         }
 
+        // event-driven state is kept per buffer
+        p_->compiled_ = false;
+
         ResumeAutoTick();
     }
 }
@@ -217,32 +237,368 @@ int Circuit::GetBufferCount() const
     return p_->circuitThreads_.size();
 }
 
+void Circuit::SetLaneCount( int laneCount )
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    for ( auto& component : p_->components_ )
+    {
+        component->SetLaneCount( laneCount );
+    }
+
+    p_->laneCount_ = laneCount > 0 ? ( laneCount + 63 ) / 64 * 64 : 0;  // lanes come in whole words
+
+    // gate lane batches point into lane storage
+    p_->compiled_ = false;
+
+    ResumeAutoTick();
+}
+
+int Circuit::GetLaneCount() const
+{
+    return p_->laneCount_;
+}
+
+void Circuit::SetSyncPolicy( SyncPolicy policy )
+{
+    // threads can switch policy while waiting, so there's no need to sync them first
+    p_->syncPolicy_ = policy;
+
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->SetSyncPolicy( policy );
+    }
+    p_->clustersDone_.SetPolicy( policy );
+}
+
+Circuit::SyncPolicy Circuit::GetSyncPolicy() const
+{
+    return p_->syncPolicy_;
+}
+
+void Circuit::Compile()
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    p_->Compile();
+
+    ResumeAutoTick();
+}
+
+bool Circuit::IsCompiled() const
+{
+    return p_->compiled_;
+}
+
+int Circuit::GetLevelCount() const
+{
+    return p_->levelOffsets_.size();
+}
+
+int Circuit::GetClusterCount() const
+{
+    return p_->clusters_.size();
+}
+
+int Circuit::GetFeedbackLoopCount() const
+{
+    return p_->loops_.size();
+}
+
+void Circuit::SetMaxFeedbackIterations( int iterations )
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    p_->maxFeedbackIterations_ = std::max( iterations, 1 );
+
+    ResumeAutoTick();
+}
+
+int Circuit::GetMaxFeedbackIterations() const
+{
+    return p_->maxFeedbackIterations_;
+}
+
+void Circuit::SetOptimizeLogic( bool optimize )
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    if ( p_->optimizeLogic_ != optimize )
+    {
+        p_->optimizeLogic_ = optimize;
+        p_->compiled_ = false;
+    }
+
+    ResumeAutoTick();
+}
+
+bool Circuit::GetOptimizeLogic() const
+{
+    return p_->optimizeLogic_;
+}
+
+int Circuit::GetFoldedGateCount() const
+{
+    return p_->constants_.size();
+}
+
+int Circuit::GetDeadGateCount() const
+{
+    // every other elided gate is in a LUT, but not its root
+    return p_->elided_.size() - p_->constants_.size() - ( p_->lutGateCount_ - p_->luts_.size() );
+}
+
+void Circuit::SetLutInputCount( int inputCount )
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    inputCount = std::max( inputCount, 0 );
+    if ( inputCount > internal::Circuit::maxLutInputCount )
+    {
+        inputCount = internal::Circuit::maxLutInputCount;
+    }
+    if ( p_->lutInputCount_ != inputCount )
+    {
+        p_->lutInputCount_ = inputCount;
+        p_->compiled_ = false;
+    }
+
+    ResumeAutoTick();
+}
+
+int Circuit::GetLutInputCount() const
+{
+    return p_->lutInputCount_;
+}
+
+int Circuit::GetLutCount() const
+{
+    return p_->luts_.size();
+}
+
+int Circuit::GetLutGateCount() const
+{
+    return p_->lutGateCount_;
+}
+
+void Circuit::SetCodegen( bool enabled )
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    if ( p_->codegen_ != enabled )
+    {
+        p_->codegen_ = enabled;
+        p_->compiled_ = false;
+    }
+
+    ResumeAutoTick();
+}
+
+bool Circuit::GetCodegen() const
+{
+    return p_->codegen_;
+}
+
+bool Circuit::IsNative() const
+{
+    return !p_->nativeRuns_.empty();
+}
+
 void Circuit::Tick( Component::TickMode mode )
 {
-    // process in a single thread if this circuit has no threads
-    // =========================================================
-    if (p_->circuitThreads_.empty())
+    p_->PrepareTick( mode );
+    p_->TickNext( mode, 1 );
+}
+
+void Circuit::TickN( int64_t tickCount, Component::TickMode mode )
+{
+    if ( tickCount > 0 )
     {
-        // tick all internal components
-        for (auto& component : p_->components_)
-        {
-            component->Tick( mode );
-        }
+        p_->PrepareTick( mode );
+        p_->TickNext( mode, tickCount );
+    }
+}
+
+int64_t Circuit::RunUntil( const std::function<bool()>& predicate, int64_t maxTicks, Component::TickMode mode )
+{
+    return p_->RunUntil( [&predicate]( int ) { return predicate(); }, maxTicks, mode );
+}
+
+int64_t Circuit::RunUntil( const std::shared_ptr<Component const>& component, int output, bool value, int64_t maxTicks,
+                           Component::TickMode mode )
+{
+    int componentIndex;
+    if ( !p_->FindComponent( component, componentIndex ) || output < 0 || output >= component->GetOutputCount() )
+    {
+        return 0;
+    }
+
+    // read the output where it is actually driven, should it be a sub-circuit's
+    auto driver = p_->ResolveOutput( p_->components_[componentIndex].get(), output );
+    if ( driver == nullptr )
+    {
+        return 0;
+    }
 
-        // reset all internal components
-        for (auto& component : p_->components_)
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    // an optimized circuit must keep the driver ticking, even if nothing else reads it
+    auto watch = std::make_pair( p_->components_[componentIndex].get(), output );
+    if ( std::find( p_->watched_.begin(), p_->watched_.end(), watch ) == p_->watched_.end() )
+    {
+        p_->watched_.emplace_back( watch );
+        if ( p_->optimizeLogic_ || p_->lutInputCount_ != 0 )
         {
-            component->Reset();
+            p_->compiled_ = false;
         }
     }
-    // process in multiple threads if this circuit has threads
-    // =======================================================
-    else
+
+    ResumeAutoTick();
+
+    return p_->RunUntil( [driver, output, value]( int bufferNo ) { return internal::Circuit::OutputIs( driver, output, bufferNo, value ); },
+                         maxTicks, mode );
+}
+
+Circuit::Stats Circuit::GetStats() const
+{
+    Stats stats;
+
+#ifdef SCOTTCPU_STATS
+    stats.enabled = true;
+    stats.tickCount = p_->tickCount_;
+#endif
+
+    for ( size_t i = 0; i < p_->components_.size(); ++i )
+    {
+        p_->AddStats( p_->components_[i], i, stats.components );
+    }
+
+    return stats;
+}
+
+void Circuit::ResetStats()
+{
+#ifdef SCOTTCPU_STATS
+    p_->tickCount_ = 0;
+#endif
+
+    for ( auto& component : p_->components_ )
+    {
+        p_->ResetStats( component );
+    }
+}
+
+std::vector<uint64_t> Circuit::SaveState()
+{
+    std::vector<uint64_t> state;
+
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    p_->SaveState( state );
+
+    ResumeAutoTick();
+
+    return state;
+}
+
+bool Circuit::SaveState( const std::string& filePath )
+{
+    auto state = SaveState();
+
+    std::FILE* file = std::fopen( filePath.c_str(), "wb" );
+    if ( file == nullptr )
+    {
+        return false;
+    }
+
+    bool result = std::fwrite( state.data(), sizeof( uint64_t ), state.size(), file ) == state.size();
+
+    return std::fclose( file ) == 0 && result;
+}
+
+bool Circuit::RestoreState( std::vector<uint64_t> const& state )
+{
+    PauseAutoTick();
+
+    // sync all threads
+    for ( auto& circuitThread : p_->circuitThreads_ )
+    {
+        circuitThread->Sync();
+    }
+
+    bool result = p_->RestoreState( state );
+
+    ResumeAutoTick();
+
+    return result;
+}
+
+bool Circuit::RestoreState( const std::string& filePath )
+{
+    std::FILE* file = std::fopen( filePath.c_str(), "rb" );
+    if ( file == nullptr )
     {
-        p_->circuitThreads_[p_->currentThreadNo_]->SyncAndResume( mode );  // sync and resume thread x
+        return false;
+    }
 
-        p_->currentThreadNo_ = p_->currentThreadNo_ + 1 == (int)p_->circuitThreads_.size() ? 0 : p_->currentThreadNo_ + 1;
+    std::vector<uint64_t> state;
+    uint64_t words[512];
+    for ( size_t count; ( count = std::fread( words, sizeof( uint64_t ), 512, file ) ) != 0; )
+    {
+        state.insert( state.end(), words, words + count );
     }
+
+    std::fclose( file );
+
+    return RestoreState( state );
 }
 
 void Circuit::StartAutoTick( Component::TickMode mode )
@@ -323,4 +679,1960 @@ bool internal::Circuit::FindComponent(const std::shared_ptr<::Component const>&
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+void internal::Circuit::Flatten( const std::shared_ptr<::Component>& component, std::vector<::Component*>& leaves )
+{
+    auto subCircuit = dynamic_cast<::SubCircuit*>( component.get() );
+    if ( subCircuit == nullptr )
+    {
+        leaves.emplace_back( component.get() );
+        return;
+    }
+
+    // inner components are ticked in place of the sub-circuit, so need its buffers and lanes
+    subCircuit->SyncComponents();
+    subCircuits_.emplace_back( subCircuit );
+
+    for ( auto& innerComponent : subCircuit->p_->components_ )
+    {
+        Flatten( innerComponent, leaves );
+    }
+}
+
+void internal::Circuit::AddStats( const std::shared_ptr<::Component>& component, int componentIndex, std::vector<::Circuit::Stats::ComponentStats>& stats ) const
+{
+    ::Circuit::Stats::ComponentStats componentStats;
+    componentStats.component = component;
+    componentStats.componentIndex = componentIndex;
+
+    for ( int i = 0; i < component->GetBufferCount(); ++i )
+    {
+        componentStats.buffers.emplace_back( component->GetStats( i ) );
+        componentStats.total += componentStats.buffers.back();
+    }
+
+    stats.emplace_back( std::move( componentStats ) );
+
+    // followed by the components inside a sub-circuit
+    if ( auto subCircuit = dynamic_cast<::SubCircuit*>( component.get() ) )
+    {
+        for ( auto& innerComponent : subCircuit->p_->components_ )
+        {
+            AddStats( innerComponent, componentIndex, stats );
+        }
+    }
+}
+
+void internal::Circuit::ResetStats( const std::shared_ptr<::Component>& component )
+{
+    component->ResetStats();
+
+    if ( auto subCircuit = dynamic_cast<::SubCircuit*>( component.get() ) )
+    {
+        for ( auto& innerComponent : subCircuit->p_->components_ )
+        {
+            ResetStats( innerComponent );
+        }
+    }
+}
+
+void internal::Circuit::CollectState( const std::shared_ptr<::Component>& component, std::vector<::Component*>& stateComponents ) const
+{
+    stateComponents.emplace_back( component.get() );
+
+    // followed by the sub-circuit's ports and the components inside it
+    if ( auto subCircuit = dynamic_cast<::SubCircuit*>( component.get() ) )
+    {
+        CollectState( subCircuit->p_->inputs_, stateComponents );
+        CollectState( subCircuit->p_->outputs_, stateComponents );
+
+        for ( auto& innerComponent : subCircuit->p_->components_ )
+        {
+            CollectState( innerComponent, stateComponents );
+        }
+    }
+}
+
+size_t internal::Circuit::StateShape( std::vector<::Component*> const& stateComponents, uint64_t& busCount, uint64_t& shape ) const
+{
+    // FNV-1a over the signal and lane count of every bus
+    busCount = 0;
+    shape = 0xcbf29ce484222325;
+    size_t wordCount = stateHeaderSize;
+
+    for ( auto component : stateComponents )
+    {
+        for ( auto buses : { &component->p_->inputBuses_, &component->p_->outputBuses_ } )
+        {
+            for ( auto& bus : *buses )
+            {
+                shape = ( shape ^ (uint64_t)bus.signalCount_ ) * 0x100000001b3;
+                shape = ( shape ^ (uint64_t)bus.laneWordCount_ ) * 0x100000001b3;
+                wordCount += bus.values_.size() + bus.hasValues_.size() + bus.lanes_.size() + 1;  // + word count
+                ++busCount;
+            }
+        }
+        ++wordCount;  // the component's own state's word count
+    }
+
+    return wordCount;  // not counting any word values
+}
+
+void internal::Circuit::SaveState( std::vector<uint64_t>& state ) const
+{
+    std::vector<::Component*> stateComponents;
+    for ( auto& component : components_ )
+    {
+        CollectState( component, stateComponents );
+    }
+
+    uint64_t busCount, shape;
+    size_t wordCount = StateShape( stateComponents, busCount, shape );
+
+    // which components event-driven ticks are due to process, if compiled
+    uint64_t scheduleSize = compiled_ ? schedule_.size() : 0;
+    size_t dirtyWordCount = ( scheduleSize + 63 ) / 64;
+
+    state.clear();
+    state.reserve( wordCount + ( scheduleSize != 0 ? dirty_.size() * ( dirtyWordCount + 1 ) : 0 ) );
+    state.insert( state.end(), { stateMagic, (uint64_t)circuitThreads_.size(), (uint64_t)currentThreadNo_, busCount, shape, scheduleSize } );
+
+    std::vector<uint64_t> componentState;
+    for ( auto component : stateComponents )
+    {
+        for ( auto buses : { &component->p_->inputBuses_, &component->p_->outputBuses_ } )
+        {
+            for ( auto& bus : *buses )
+            {
+                state.insert( state.end(), bus.values_.begin(), bus.values_.end() );
+                state.insert( state.end(), bus.hasValues_.begin(), bus.hasValues_.end() );
+                state.insert( state.end(), bus.lanes_.begin(), bus.lanes_.end() );
+
+                // word values, only if any were ever set on the bus
+                state.emplace_back( bus.words_.size() );
+                state.insert( state.end(), bus.isWords_.begin(), bus.isWords_.end() );
+                state.insert( state.end(), bus.words_.begin(), bus.words_.end() );
+            }
+        }
+
+        // followed by any state the component keeps itself
+        component->SaveState( componentState );
+        state.emplace_back( componentState.size() );
+        state.insert( state.end(), componentState.begin(), componentState.end() );
+    }
+
+    for ( size_t bufferNo = 0; scheduleSize != 0 && bufferNo < dirty_.size(); ++bufferNo )
+    {
+        for ( size_t w = 0; w < dirtyWordCount; ++w )
+        {
+            uint64_t word = 0;
+            for ( size_t i = w * 64; i < std::min<size_t>( w * 64 + 64, scheduleSize ); ++i )
+            {
+                word |= (uint64_t)( dirty_[bufferNo][i] != 0 ) << ( i % 64 );
+            }
+            state.emplace_back( word );
+        }
+        state.emplace_back( resync_[bufferNo] );
+    }
+}
+
+bool internal::Circuit::RestoreState( std::vector<uint64_t> const& state )
+{
+    std::vector<::Component*> stateComponents;
+    for ( auto& component : components_ )
+    {
+        CollectState( component, stateComponents );
+    }
+
+    // the state must be of a circuit just like this one
+    uint64_t busCount, shape;
+    size_t wordCount = StateShape( stateComponents, busCount, shape );
+    uint64_t bufferCount = circuitThreads_.size();
+
+    if ( state.size() < stateHeaderSize || state[0] != stateMagic || state[1] != bufferCount ||
+         state[2] >= std::max<uint64_t>( bufferCount, 1 ) || state[3] != busCount || state[4] != shape )
+    {
+        return false;
+    }
+
+    uint64_t scheduleSize = state[5];
+    size_t dirtyWordCount = ( scheduleSize + 63 ) / 64;
+    if ( scheduleSize > state.size() || state.size() < wordCount )
+    {
+        return false;
+    }
+
+    // the buses' word values and components' own states vary in size, so find where they end
+    // before restoring anything
+    size_t end = stateHeaderSize;
+    std::vector<size_t> componentStateIndices;
+    for ( auto component : stateComponents )
+    {
+        for ( auto buses : { &component->p_->inputBuses_, &component->p_->outputBuses_ } )
+        {
+            for ( auto& bus : *buses )
+            {
+                end += bus.values_.size() + bus.hasValues_.size() + bus.lanes_.size();
+                if ( end >= state.size() || ( state[end] != 0 && state[end] != (uint64_t)bus.signalCount_ ) )
+                {
+                    return false;
+                }
+                end += 1 + ( state[end] != 0 ? bus.values_.size() + state[end] : 0 );
+            }
+        }
+
+        if ( end >= state.size() || state[end] >= state.size() - end )
+        {
+            return false;
+        }
+        componentStateIndices.emplace_back( end );
+        end += 1 + state[end];
+    }
+
+    if ( end > state.size() ||
+         state.size() - end != ( scheduleSize != 0 ? std::max<uint64_t>( bufferCount, 1 ) * ( dirtyWordCount + 1 ) : 0 ) )
+    {
+        return false;
+    }
+
+    // components' own states first, as they may still turn out not to fit
+    std::vector<uint64_t> componentState;
+    for ( size_t i = 0; i < stateComponents.size(); ++i )
+    {
+        auto componentStateWords = state.begin() + componentStateIndices[i];
+        componentState.assign( componentStateWords + 1, componentStateWords + 1 + *componentStateWords );
+        if ( !stateComponents[i]->RestoreState( componentState ) )
+        {
+            return false;
+        }
+    }
+
+    currentThreadNo_ = state[2];
+
+    auto word = state.data() + stateHeaderSize;
+    auto restore = [&word]( std::vector<uint64_t>& words ) {
+        std::copy( word, word + words.size(), words.begin() );
+        word += words.size();
+    };
+
+    for ( auto component : stateComponents )
+    {
+        for ( auto buses : { &component->p_->inputBuses_, &component->p_->outputBuses_ } )
+        {
+            for ( auto& bus : *buses )
+            {
+                restore( bus.values_ );
+                restore( bus.hasValues_ );
+                restore( bus.lanes_ );
+
+                if ( *word++ != 0 )
+                {
+                    bus.isWords_.resize( bus.values_.size() );
+                    bus.words_.resize( bus.signalCount_ );
+                    restore( bus.isWords_ );
+                    restore( bus.words_ );
+                }
+                else
+                {
+                    bus.isWords_.clear();
+                    bus.words_.clear();
+                }
+            }
+        }
+
+        // (already restored)
+        word += 1 + *word;
+
+        // in-order components take turns starting from the buffer that ticks next
+        auto& gotReleases = component->p_->gotReleases_;
+        for ( size_t i = 0; i < gotReleases.size(); ++i )
+        {
+            gotReleases[i] = (int)i == currentThreadNo_;
+        }
+    }
+
+    if ( compiled_ && scheduleSize == schedule_.size() && scheduleSize != 0 )
+    {
+        for ( size_t bufferNo = 0; bufferNo < dirty_.size(); ++bufferNo )
+        {
+            for ( size_t i = 0; i < scheduleSize; ++i )
+            {
+                dirty_[bufferNo][i] = ( word[i / 64] >> ( i % 64 ) ) & 1;
+            }
+            word += dirtyWordCount;
+            resync_[bufferNo] = *word++ != 0;
+        }
+    }
+    else
+    {
+        // event-driven ticks can't assume which inputs changed
+        ResyncEventDriven();
+    }
+
+    if ( compiled_ )
+    {
+        ApplyConstants();
+    }
+
+    return true;
+}
+
+void internal::Circuit::PrepareTick( ::Component::TickMode mode )
+{
+    if ( !compiled_ )
+    {
+        // we may be running in the auto-tick thread here, so rather than pausing, just wait for
+        // any circuit threads still running the old schedule before recompiling it
+        for ( auto& circuitThread : circuitThreads_ )
+        {
+            circuitThread->Sync();
+        }
+
+        Compile();
+    }
+
+    if ( mode == ::Component::TickMode::EventDriven && lastMode_ != mode )
+    {
+        // other tick modes don't keep inputs up to date between ticks
+        ResyncEventDriven();
+    }
+    lastMode_ = mode;
+}
+
+void internal::Circuit::TickNext( ::Component::TickMode mode, int64_t tickCount )
+{
+#ifdef SCOTTCPU_STATS
+    tickCount_ += tickCount;
+#endif
+
+    // process in a single thread if this circuit has no threads
+    // =========================================================
+    if ( circuitThreads_.empty() )
+    {
+        for ( int64_t i = 0; i < tickCount; ++i )
+        {
+            Tick( mode, 0 );
+        }
+    }
+    // process in multiple threads if this circuit has threads
+    // =======================================================
+    else
+    {
+        // tick i goes to thread ( currentThreadNo_ + i ) % bufferCount, so hand each thread all
+        // of its ticks at once, in-order components keeping the buffers' turns among them
+        int bufferCount = circuitThreads_.size();
+        for ( int i = 0; i < bufferCount && i < tickCount; ++i )
+        {
+            int threadNo = ( currentThreadNo_ + i ) % bufferCount;
+            circuitThreads_[threadNo]->SyncAndResume( mode, tickCount / bufferCount + ( i < tickCount % bufferCount ) );
+        }
+
+        currentThreadNo_ = ( currentThreadNo_ + tickCount ) % bufferCount;
+    }
+}
+
+int64_t internal::Circuit::RunUntil( std::function<bool( int bufferNo )> const& predicate, int64_t maxTicks, ::Component::TickMode mode )
+{
+    if ( maxTicks <= 0 )
+    {
+        return 0;
+    }
+
+    PrepareTick( mode );
+
+    for ( int64_t tickCount = 1; tickCount <= maxTicks; ++tickCount )
+    {
+        int bufferNo = currentThreadNo_;
+        TickNext( mode, 1 );
+
+        if ( !circuitThreads_.empty() )
+        {
+            circuitThreads_[bufferNo]->Sync();  // the ticks before it were waited for in turn
+        }
+
+        if ( predicate( bufferNo ) )
+        {
+            return tickCount;
+        }
+    }
+
+    return maxTicks;
+}
+
+bool internal::Circuit::OutputIs( ::Component* component, int output, int bufferNo, bool value )
+{
+    auto& outputBus = component->p_->outputBuses_[bufferNo];
+
+    if ( outputBus.GetLaneWordCount() != 0 )
+    {
+        auto lanes = outputBus.GetLanes( output );
+        return lanes != nullptr && ( lanes[0] & 1 ) == (uint64_t)value;
+    }
+
+    auto bit = outputBus.GetValue( output );
+    return bit != nullptr && bit->value == value;
+}
+
+::Component* internal::Circuit::ResolveOutput( ::Component* component, int& output ) const
+{
+    // follow the wire driving a sub-circuit port until it reaches a component that isn't one
+
+    std::vector<std::pair<::Component*, int>> ports;
+
+    for ( ;; )
+    {
+        std::vector<Wire> const* wires;
+
+        if ( auto subCircuit = dynamic_cast<::SubCircuit*>( component ) )
+        {
+            // a sub-circuit's output is driven from inside it
+            wires = &static_cast<::Component*>( subCircuit->p_->outputs_.get() )->p_->inputWires_;
+        }
+        else if ( auto subCircuitInputs = dynamic_cast<SubCircuitInputs*>( component ) )
+        {
+            // a sub-circuit's input, as seen from inside it, is driven from outside it
+            wires = &static_cast<::Component*>( subCircuitInputs->subCircuit_ )->p_->inputWires_;
+        }
+        else
+        {
+            return component;
+        }
+
+        auto port = std::make_pair( component, output );
+        if ( std::find( ports.begin(), ports.end(), port ) != ports.end() )
+        {
+            return nullptr;  // ports wired in a loop, with nothing driving them
+        }
+        ports.emplace_back( port );
+
+        auto wire = std::find_if( wires->begin(), wires->end(), [output]( Wire const& w ) { return w.toInput_ == output; } );
+        if ( wire == wires->end() )
+        {
+            return nullptr;  // unconnected port
+        }
+
+        component = wire->fromComponent_.get();
+        output = wire->fromOutput_;
+    }
+}
+
+std::vector<internal::Circuit::Input> internal::Circuit::ResolveInputs( ::Component* component, bool resolvePorts ) const
+{
+    std::vector<Input> inputs;
+    inputs.reserve( component->p_->inputWires_.size() );
+
+    for ( auto& wire : component->p_->inputWires_ )
+    {
+        int fromOutput = wire.fromOutput_;
+        auto fromComponent = resolvePorts ? ResolveOutput( wire.fromComponent_.get(), fromOutput ) : wire.fromComponent_.get();
+
+        if ( fromComponent != nullptr )
+        {
+            inputs.push_back( { fromComponent, fromOutput, wire.toInput_ } );
+        }
+    }
+
+    return inputs;
+}
+
+void internal::Circuit::Compile()
+{
+    // Walk the circuit depth-first from each component back through its input wires, in the same
+    // order as Component::Tick() would. A wire that leads back to a component whose walk has
+    // started but not completed closes a feedback loop, and is excluded from the dependency graph
+    // (just as Tick() reads such a wire's output from the previous tick). The same walk finds the
+    // circuit's strongly connected components (Tarjan's algorithm), i.e. its feedback loops, in an
+    // order in which every loop comes after the components that drive it. Each component can then
+    // be assigned a level one above that of its deepest input, where the components driven by a
+    // loop are placed above all of the loop's components, so that the loop can be settled before
+    // they are ticked (see SettleLoop()).
+
+    enum class ScanStatus
+    {
+        NotScanned,
+        Scanning,
+        Scanned,  // but its strongly connected component is still open
+        Grouped
+    };
+
+    struct Scan
+    {
+        ScanStatus status = ScanStatus::NotScanned;
+        int index;      // in scan order
+        int lowLink;    // lowest index reachable from this component's walk
+        int postIndex;  // in order
+        int groupNo;    // strongly connected component
+        int level;
+    };
+
+    // sub-circuits are replaced by the components inside them
+    auto& roots = roots_;
+    roots.clear();
+    subCircuits_.clear();
+    for ( auto& component : components_ )
+    {
+        Flatten( component, roots );
+    }
+    bool resolvePorts = std::any_of( components_.begin(), components_.end(), []( const std::shared_ptr<::Component>& component ) {
+        return dynamic_cast<::SubCircuit*>( component.get() ) != nullptr;
+    } );
+
+    // watched outputs are resolved afresh, as the wires inside sub-circuits may have changed
+    observed_.clear();
+    for ( auto const& watch : watched_ )
+    {
+        int output = watch.second;
+        auto driver = ResolveOutput( watch.first, output );
+        if ( driver != nullptr )
+        {
+            observed_.insert( driver );
+        }
+    }
+
+    std::unordered_map<::Component*, Scan> scans;
+    std::unordered_map<::Component*, std::vector<Input>> inputs;
+    std::vector<::Component*> order;
+    std::vector<std::pair<::Component*, size_t>> stack;  // component:next wire to scan
+    std::vector<::Component*> openGroup;                 // components of open strongly connected components
+    std::vector<::Component*> groups;                    // components by strongly connected component
+    std::vector<size_t> groupOffsets;                    // groups index of each one's first component
+
+    int scanCount = 0;
+
+    auto startScan = [&]( ::Component* component, Scan& scan ) {
+        scan.status = ScanStatus::Scanning;
+        scan.index = scan.lowLink = scanCount++;
+        inputs[component] = ResolveInputs( component, resolvePorts );
+        stack.emplace_back( component, 0 );
+        openGroup.emplace_back( component );
+    };
+
+    for ( auto root : roots )
+    {
+        auto& rootScan = scans[root];
+        if ( rootScan.status != ScanStatus::NotScanned )
+        {
+            continue;
+        }
+
+        startScan( root, rootScan );
+
+        while ( !stack.empty() )
+        {
+            auto component = stack.back().first;
+            auto& scan = scans[component];
+            auto& wires = inputs[component];
+            auto& wireNo = stack.back().second;
+
+            if ( wireNo < wires.size() )
+            {
+                auto fromComponent = wires[wireNo++].fromComponent;
+                auto& fromScan = scans[fromComponent];
+
+                if ( fromScan.status == ScanStatus::NotScanned )
+                {
+                    startScan( fromComponent, fromScan );
+                }
+                else if ( fromScan.status != ScanStatus::Grouped )
+                {
+                    scan.lowLink = std::min( scan.lowLink, fromScan.index );
+                }
+                continue;
+            }
+
+            scan.status = ScanStatus::Scanned;
+            scan.postIndex = order.size();
+            order.emplace_back( component );
+
+            stack.pop_back();
+            if ( !stack.empty() )
+            {
+                auto& callerScan = scans[stack.back().first];
+                callerScan.lowLink = std::min( callerScan.lowLink, scan.lowLink );
+            }
+
+            if ( scan.lowLink != scan.index )
+            {
+                continue;
+            }
+
+            // this component is the first scanned of a strongly connected component: close it
+            groupOffsets.emplace_back( groups.size() );
+            ::Component* member;
+            do
+            {
+                member = openGroup.back();
+                openGroup.pop_back();
+
+                auto& memberScan = scans[member];
+                memberScan.status = ScanStatus::Grouped;
+                memberScan.groupNo = groupOffsets.size() - 1;
+                groups.emplace_back( member );
+            } while ( member != component );
+
+            std::sort( groups.begin() + groupOffsets.back(), groups.end(),
+                       [&scans]( ::Component* a, ::Component* b ) { return scans[a].postIndex < scans[b].postIndex; } );
+        }
+    }
+    groupOffsets.emplace_back( groups.size() );
+
+    // fold constant gates and leave out dead ones, then map cones of gates onto LUTs
+    elided_.clear();
+    constants_.clear();
+    luts_.clear();
+    lutGateCount_ = 0;
+
+    std::unordered_set<::Component*> elided;
+
+    if ( optimizeLogic_ )
+    {
+        // a gate read over a feedback wire reads no value there on the first tick, so keep it
+        std::unordered_set<::Component*> feedbackDrivers;
+        for ( auto component : order )
+        {
+            for ( auto& wire : inputs[component] )
+            {
+                if ( scans[wire.fromComponent].postIndex >= scans[component].postIndex )
+                {
+                    feedbackDrivers.insert( wire.fromComponent );
+                }
+            }
+        }
+
+        // in scan order, every other wire into a gate is driven by a component already visited
+        std::unordered_map<::Component*, bool> constants;
+        for ( auto component : order )
+        {
+            auto gate = dynamic_cast<::Gate const*>( component );
+            if ( gate == nullptr || feedbackDrivers.count( component ) != 0 )
+            {
+                continue;
+            }
+
+            bool known[2] = { true, true };  // unconnected inputs read 0
+            bool in[2] = { false, false };
+            for ( auto& wire : inputs[component] )
+            {
+                auto constant = constants.find( wire.fromComponent );
+                known[wire.toInput] = constant != constants.end();
+                in[wire.toInput] = known[wire.toInput] && constant->second;
+            }
+
+            auto type = gate->GetType();
+            bool controlling = ( type == ::Gate::Type::Or || type == ::Gate::Type::Nor );
+            if ( known[0] && known[1] )
+            {
+                constants[component] = ::Gate::Evaluate( type, in[0], in[1] );
+            }
+            else if ( ( type == ::Gate::Type::And || type == ::Gate::Type::Nand || controlling ) &&
+                      ( ( known[0] && in[0] == controlling ) || ( known[1] && in[1] == controlling ) ) )
+            {
+                constants[component] = ::Gate::Evaluate( type, controlling, controlling );
+            }
+        }
+
+        // every other kind of component is live, as are the gates that drive a live component,
+        // except through a constant gate
+        std::unordered_set<::Component*> live;
+        std::vector<::Component*> pending;
+        for ( auto component : order )
+        {
+            if ( dynamic_cast<::Gate const*>( component ) == nullptr || observed_.count( component ) != 0 )
+            {
+                live.insert( component );
+                pending.emplace_back( component );
+            }
+        }
+        while ( !pending.empty() )
+        {
+            auto component = pending.back();
+            pending.pop_back();
+
+            if ( constants.count( component ) != 0 )
+            {
+                continue;
+            }
+            for ( auto& wire : inputs[component] )
+            {
+                if ( live.insert( wire.fromComponent ).second )
+                {
+                    pending.emplace_back( wire.fromComponent );
+                }
+            }
+        }
+
+        for ( auto component : order )
+        {
+            if ( live.count( component ) == 0 || constants.count( component ) != 0 )
+            {
+                elided.insert( component );
+                elided_.emplace_back( component );
+                if ( live.count( component ) != 0 )
+                {
+                    constants_.emplace_back( component, constants[component] );
+                }
+            }
+        }
+    }
+
+    if ( lutInputCount_ > 0 && laneCount_ == 0 )
+    {
+        // members of feedback loops are re-ticked as the loop settles, so are left as they are
+        std::unordered_set<::Component*> loopMembers;
+        for ( size_t groupNo = 0; groupNo + 1 < groupOffsets.size(); ++groupNo )
+        {
+            for ( size_t i = groupOffsets[groupNo]; i < groupOffsets[groupNo + 1]; ++i )
+            {
+                auto& wires = inputs[groups[i]];
+                if ( groupOffsets[groupNo + 1] - groupOffsets[groupNo] > 1 ||
+                     std::any_of( wires.begin(), wires.end(), [&]( Input const& wire ) { return wire.fromComponent == groups[i]; } ) )
+                {
+                    loopMembers.insert( groups[i] );
+                }
+            }
+        }
+
+        MapLuts( order, inputs, loopMembers, elided );
+    }
+
+    if ( !elided.empty() )
+    {
+        auto isElided = [&elided]( ::Component* component ) { return elided.count( component ) != 0; };
+
+        for ( auto component : elided )
+        {
+            scans[component].groupNo = -1;
+        }
+        order.erase( std::remove_if( order.begin(), order.end(), isElided ), order.end() );
+
+        // close up the groups, dropping any left empty
+        std::vector<::Component*> keptGroups;
+        std::vector<size_t> keptOffsets;
+        for ( size_t groupNo = 0; groupNo + 1 < groupOffsets.size(); ++groupNo )
+        {
+            size_t keptBegin = keptGroups.size();
+            for ( size_t i = groupOffsets[groupNo]; i < groupOffsets[groupNo + 1]; ++i )
+            {
+                if ( !isElided( groups[i] ) )
+                {
+                    scans[groups[i]].groupNo = keptOffsets.size();
+                    keptGroups.emplace_back( groups[i] );
+                }
+            }
+            if ( keptGroups.size() != keptBegin )
+            {
+                keptOffsets.emplace_back( keptBegin );
+            }
+        }
+        keptOffsets.emplace_back( keptGroups.size() );
+
+        groups = std::move( keptGroups );
+        groupOffsets = std::move( keptOffsets );
+    }
+
+    // assign levels, one group at a time
+    std::vector<int> groupLevels( groupOffsets.size() - 1 );  // the highest level in each group
+    int levelCount = 0;
+    std::vector<std::vector<::Component*>> loops;
+
+    for ( size_t groupNo = 0; groupNo + 1 < groupOffsets.size(); ++groupNo )
+    {
+        auto begin = groups.begin() + groupOffsets[groupNo];
+        auto end = groups.begin() + groupOffsets[groupNo + 1];
+        bool isLoop = end - begin > 1;
+
+        // above every component driving the group...
+        int groupLevel = 0;
+        for ( auto member = begin; member != end; ++member )
+        {
+            for ( auto& wire : inputs[*member] )
+            {
+                auto& fromScan = scans[wire.fromComponent];
+                if ( fromScan.groupNo < 0 )
+                {
+                    continue;  // a constant gate, set before any tick
+                }
+                else if ( fromScan.groupNo != (int)groupNo )
+                {
+                    groupLevel = std::max( groupLevel, groupLevels[fromScan.groupNo] + 1 );
+                }
+                else if ( wire.fromComponent == *member )
+                {
+                    isLoop = true;  // driving itself
+                }
+            }
+        }
+
+        // ...and within a loop, above the members it doesn't read via a feedback wire
+        int topLevel = groupLevel;
+        for ( auto member = begin; member != end; ++member )
+        {
+            auto& scan = scans[*member];
+            scan.level = groupLevel;
+            for ( auto& wire : inputs[*member] )
+            {
+                auto& fromScan = scans[wire.fromComponent];
+                if ( fromScan.groupNo == (int)groupNo && fromScan.postIndex < scan.postIndex )
+                {
+                    scan.level = std::max( scan.level, fromScan.level + 1 );
+                }
+            }
+            topLevel = std::max( topLevel, scan.level );
+        }
+
+        groupLevels[groupNo] = topLevel;
+        levelCount = std::max( levelCount, topLevel + 1 );
+
+        if ( isLoop )
+        {
+            loops.emplace_back( begin, end );
+        }
+    }
+
+    // bucket components by level, preserving scan order within each level
+    levelOffsets_.assign( levelCount + 1, 0 );
+    for ( auto component : order )
+    {
+        ++levelOffsets_[scans[component].level + 1];
+    }
+    for ( int i = 0; i < levelCount; ++i )
+    {
+        levelOffsets_[i + 1] += levelOffsets_[i];
+    }
+
+    schedule_.resize( order.size() );
+    auto nextIndex = levelOffsets_;
+    for ( auto component : order )
+    {
+        schedule_[nextIndex[scans[component].level]++] = component;
+    }
+
+    levelOffsets_.pop_back();
+
+    // build each component's fan-out from the input wires of its receivers
+    std::unordered_map<::Component*, int> indices;
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        indices[schedule_[i]] = i;
+    }
+
+    inputs_.resize( schedule_.size() );
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        inputs_[i] = std::move( inputs[schedule_[i]] );
+    }
+
+    // components without inputs have nothing to wait on, and VcdWriters count every tick
+    alwaysProcessed_.resize( schedule_.size() );
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        alwaysProcessed_[i] = inputs_[i].empty() || dynamic_cast<::VcdWriter const*>( schedule_[i] ) != nullptr;
+    }
+
+    fanOuts_.assign( schedule_.size(), {} );
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        for ( auto& input : inputs_[i] )
+        {
+            auto fromIndex = indices.find( input.fromComponent );
+            if ( fromIndex != indices.end() )
+            {
+                fanOuts_[fromIndex->second].push_back( { (int)i, input.fromOutput, input.toInput } );
+            }
+        }
+    }
+
+    // look up the components that drive each built-in gate
+    gateOps_.assign( schedule_.size(), { -1, nullptr, 0, nullptr, 0, -1 } );
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        auto gate = dynamic_cast<::Gate const*>( schedule_[i] );
+        if ( gate == nullptr )
+        {
+            continue;
+        }
+
+        auto& gateOp = gateOps_[i];
+        gateOp.type = (int)gate->GetType();
+        for ( auto& input : inputs_[i] )
+        {
+            if ( input.toInput >= 0 )
+            {
+                ( input.toInput == 0 ? gateOp.in0 : gateOp.in1 ) = input.fromComponent->p_.get();
+                ( input.toInput == 0 ? gateOp.in0Output : gateOp.in1Output ) = input.fromOutput;
+            }
+        }
+    }
+    for ( size_t lutNo = 0; lutNo < luts_.size(); ++lutNo )
+    {
+        gateOps_[indices[luts_[lutNo].root]].lut = lutNo;
+    }
+
+    ApplyConstants();
+
+    dirty_.resize( std::max<size_t>( circuitThreads_.size(), 1 ) );
+    resync_.resize( dirty_.size() );
+    ResyncEventDriven();
+
+    // keep room for a snapshot of each feedback loop's outputs, per buffer
+    loops_.resize( loops.size() );
+    for ( size_t loopNo = 0; loopNo < loops.size(); ++loopNo )
+    {
+        auto& loop = loops_[loopNo];
+        loop.members.clear();
+
+        size_t wordCount = 0;
+        for ( auto component : loops[loopNo] )
+        {
+            loop.members.emplace_back( indices[component] );
+
+            auto& outputBus = component->p_->outputBuses_[0];
+            wordCount += outputBus.values_.size() + outputBus.hasValues_.size() + outputBus.lanes_.size();
+        }
+        std::sort( loop.members.begin(), loop.members.end() );
+
+        loop.outputs.assign( dirty_.size(), std::vector<uint64_t>( wordCount ) );
+    }
+    std::sort( loops_.begin(), loops_.end(), []( FeedbackLoop const& a, FeedbackLoop const& b ) { return a.members.back() < b.members.back(); } );
+
+    CompileLaneBatches();
+    CompileClusters( groups, groupOffsets, indices );
+    CompileNative();
+
+    compiled_ = true;
+}
+
+void internal::Circuit::ApplyConstants()
+{
+    // constant gates are not ticked, so their outputs are set once, in every buffer and lane
+    std::vector<uint64_t> lanes;
+    for ( auto& constant : constants_ )
+    {
+        onebit bit;
+        bit.value = constant.second;
+
+        for ( auto& outputBus : constant.first->p_->outputBuses_ )
+        {
+            outputBus.SetValue( 0, bit );
+            if ( outputBus.GetLaneWordCount() != 0 )
+            {
+                lanes.assign( outputBus.GetLaneWordCount(), constant.second ? ~uint64_t( 0 ) : 0 );
+                outputBus.SetLanes( 0, lanes.data() );
+            }
+        }
+    }
+}
+
+void internal::Circuit::CompileNative()
+{
+    nativeCode_.Unload();
+    nativeRuns_.clear();
+    nativeRunNos_.clear();
+    nativeWords_.clear();
+
+    if ( !codegen_ || laneCount_ != 0 )
+    {
+        return;
+    }
+
+    // runs of gates end where other components are ticked, and where loops may be settled
+    std::vector<unsigned char> runEnds( schedule_.size() + 1, 0 );
+    for ( auto& loop : loops_ )
+    {
+        runEnds[loop.members.back() + 1] = 1;
+    }
+
+    std::unordered_map<Component const*, size_t> gateIndices;
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        if ( gateOps_[i].type >= 0 )
+        {
+            gateIndices[schedule_[i]->p_.get()] = i;
+        }
+    }
+
+    // each bus read or written is a pair of entries in the words array: values_, then hasValues_
+    std::unordered_map<Component const*, int> busNos;
+    std::vector<Component*> buses;
+    auto busNo = [&]( Component* component ) {
+        auto bus = busNos.emplace( component, buses.size() * 2 );
+        if ( bus.second )
+        {
+            buses.push_back( component );
+        }
+        return std::to_string( bus.first->second );
+    };
+
+    std::string source = "// generated from a compiled scottcpu circuit (see Circuit::SetCodegen())\n"
+                         "#include <cstdint>\n"
+                         "typedef uint64_t u64;\n"
+                         "#define R( b, w, i ) ( ( ( w_[b][w] & w_[b + 1][w] ) >> i ) & 1 )\n"
+                         "#define W( b, v ) ( w_[b][0] = ( w_[b][0] & ~(u64)1 ) | v, w_[b + 1][0] |= 1 )\n";
+
+    for ( size_t begin = 0; begin < schedule_.size(); )
+    {
+        if ( gateOps_[begin].type < 0 )
+        {
+            ++begin;
+            continue;
+        }
+
+        std::string functionName = NativeCode::FunctionName( nativeRuns_.size() );
+        std::string body;
+
+        // a gate earlier in the run is read from its local, anything else from its bus
+        auto read = [&]( Component* component, int output, size_t i ) {
+            if ( component == nullptr )
+            {
+                return std::string( "(u64)0" );
+            }
+            auto gate = gateIndices.find( component );
+            if ( gate != gateIndices.end() && gate->second >= begin && gate->second < i )
+            {
+                return "g" + std::to_string( gate->second );
+            }
+            return "R( " + busNo( component ) + ", " + std::to_string( output >> 6 ) + ", " + std::to_string( output & 63 ) + " )";
+        };
+
+        size_t end = begin;
+        for ( ; end < schedule_.size() && gateOps_[end].type >= 0 && ( end == begin || !runEnds[end] ); ++end )
+        {
+            auto& gateOp = gateOps_[end];
+            std::string out;
+
+            if ( gateOp.lut >= 0 )
+            {
+                auto& lut = luts_[gateOp.lut];
+                std::string table = "lut" + std::to_string( end );
+                source += "static const u64 " + table + "[4] = { " + std::to_string( lut.table[0] ) + "u, " +
+                          std::to_string( lut.table[1] ) + "u, " + std::to_string( lut.table[2] ) + "u, " +
+                          std::to_string( lut.table[3] ) + "u };\n";
+
+                std::string index = "x" + std::to_string( end );
+                body += "    const u64 " + index + " = (u64)0";
+                for ( size_t leaf = 0; leaf < lut.leaves.size(); ++leaf )
+                {
+                    body += " | " + read( lut.leaves[leaf].first, lut.leaves[leaf].second, end ) + " << " + std::to_string( leaf );
+                }
+                body += ";\n";
+                out = "( " + table + "[" + index + " >> 6] >> ( " + index + " & 63 ) ) & 1";
+            }
+            else
+            {
+                auto a = read( gateOp.in0, gateOp.in0Output, end );
+                auto b = read( gateOp.in1, gateOp.in1Output, end );
+
+                switch ( (::Gate::Type)gateOp.type )
+                {
+                    case ::Gate::Type::Buf:  out = a; break;
+                    case ::Gate::Type::Not:  out = a + " ^ 1"; break;
+                    case ::Gate::Type::And:  out = a + " & " + b; break;
+                    case ::Gate::Type::Nand: out = "( " + a + " & " + b + " ) ^ 1"; break;
+                    case ::Gate::Type::Or:   out = a + " | " + b; break;
+                    case ::Gate::Type::Nor:  out = "( " + a + " | " + b + " ) ^ 1"; break;
+                    case ::Gate::Type::Xor:  out = a + " ^ " + b; break;
+                    case ::Gate::Type::Xnor: out = a + " ^ " + b + " ^ 1"; break;
+                }
+            }
+
+            std::string local = "g" + std::to_string( end );
+            body += "    const u64 " + local + " = " + out + "; W( " + busNo( schedule_[end]->p_.get() ) + ", " + local + " );\n";
+        }
+
+        source += "extern \"C\" void " + functionName + "( u64* const* w_ )\n{\n" + body + "}\n";
+
+        nativeRuns_.push_back( { end, nullptr } );
+        begin = end;
+    }
+
+    if ( nativeRuns_.empty() || !nativeCode_.Load( source, nativeRuns_.size() ) )
+    {
+        nativeRuns_.clear();
+        return;
+    }
+
+    nativeRunNos_.assign( schedule_.size(), -1 );
+    size_t runBegin = 0;
+    for ( size_t runNo = 0; runNo < nativeRuns_.size(); ++runNo )
+    {
+        while ( gateOps_[runBegin].type < 0 )
+        {
+            ++runBegin;
+        }
+        nativeRunNos_[runBegin] = runNo;
+        nativeRuns_[runNo].function = nativeCode_.GetFunction( runNo );
+        runBegin = nativeRuns_[runNo].end;
+    }
+
+    nativeWords_.resize( std::max<size_t>( circuitThreads_.size(), 1 ) );
+    for ( size_t bufferNo = 0; bufferNo < nativeWords_.size(); ++bufferNo )
+    {
+        for ( auto component : buses )
+        {
+            auto& bus = component->outputBuses_[bufferNo];
+            nativeWords_[bufferNo].push_back( bus.values_.data() );
+            nativeWords_[bufferNo].push_back( bus.hasValues_.data() );
+        }
+    }
+}
+
+void internal::Circuit::MapLuts( std::vector<::Component*> const& order, std::unordered_map<::Component*, std::vector<Input>>& inputs,
+                                 std::unordered_set<::Component*> const& loopMembers, std::unordered_set<::Component*>& elided )
+{
+    using Leaf = std::pair<::Component*, int>;
+
+    struct Cone
+    {
+        std::vector<Leaf> leaves;
+        std::vector<::Component*> gates;  // in scan order, root last
+    };
+
+    // the one component that reads each output (nullptr if several do)
+    std::unordered_map<::Component*, ::Component*> readers;
+    for ( auto component : order )
+    {
+        if ( elided.count( component ) != 0 )
+        {
+            continue;
+        }
+        for ( auto& wire : inputs[component] )
+        {
+            auto reader = readers.emplace( wire.fromComponent, component ).first;
+            if ( reader->second != component )
+            {
+                reader->second = nullptr;
+            }
+        }
+    }
+
+    // grow each gate's cone from its inputs' cones, in scan order (so that those come first),
+    // taking in each input's cone that only this gate reads, while the leaves still fit
+    std::unordered_map<::Component*, Cone> cones;
+    for ( auto component : order )
+    {
+        if ( dynamic_cast<::Gate const*>( component ) == nullptr || elided.count( component ) != 0 ||
+             loopMembers.count( component ) != 0 )
+        {
+            continue;
+        }
+
+        Cone cone;
+        for ( auto& wire : inputs[component] )
+        {
+            Leaf leaf( wire.fromComponent, wire.fromOutput );
+            if ( std::find( cone.leaves.begin(), cone.leaves.end(), leaf ) == cone.leaves.end() )
+            {
+                cone.leaves.push_back( leaf );
+            }
+        }
+        if ( (int)cone.leaves.size() > lutInputCount_ )
+        {
+            continue;
+        }
+
+        for ( auto& wire : inputs[component] )
+        {
+            auto inputCone = cones.find( wire.fromComponent );
+            if ( inputCone == cones.end() || readers[wire.fromComponent] != component || observed_.count( wire.fromComponent ) != 0 ||
+                 std::find( cone.gates.begin(), cone.gates.end(), wire.fromComponent ) != cone.gates.end() )
+            {
+                continue;
+            }
+
+            auto leaves = cone.leaves;
+            leaves.erase( std::find( leaves.begin(), leaves.end(), Leaf( wire.fromComponent, wire.fromOutput ) ) );
+            for ( auto& leaf : inputCone->second.leaves )
+            {
+                if ( std::find( leaves.begin(), leaves.end(), leaf ) == leaves.end() )
+                {
+                    leaves.push_back( leaf );
+                }
+            }
+
+            if ( (int)leaves.size() <= lutInputCount_ )
+            {
+                cone.leaves = std::move( leaves );
+                cone.gates.insert( cone.gates.end(), inputCone->second.gates.begin(), inputCone->second.gates.end() );
+            }
+        }
+
+        cone.gates.push_back( component );
+        cones[component] = std::move( cone );
+    }
+
+    // the cones not taken in by another are LUTs, if they hold more than their root
+    std::unordered_set<::Component*> taken;
+    for ( auto& cone : cones )
+    {
+        taken.insert( cone.second.gates.begin(), cone.second.gates.end() - 1 );
+    }
+
+    for ( auto component : order )
+    {
+        auto cone = cones.find( component );
+        if ( cone == cones.end() || cone->second.gates.size() < 2 || taken.count( component ) != 0 )
+        {
+            continue;
+        }
+
+        auto& leaves = cone->second.leaves;
+        auto& gates = cone->second.gates;
+
+        // tabulate the cone's output for every combination of its leaves' bits
+        Lut lut;
+        lut.root = component;
+        std::fill( std::begin( lut.table ), std::end( lut.table ), 0 );
+
+        std::unordered_map<::Component*, bool> outputs;
+        for ( unsigned index = 0; index < ( 1u << leaves.size() ); ++index )
+        {
+            for ( auto gate : gates )
+            {
+                bool in[2] = { false, false };  // unconnected inputs read 0
+                for ( auto& wire : inputs[gate] )
+                {
+                    auto leaf = std::find( leaves.begin(), leaves.end(), Leaf( wire.fromComponent, wire.fromOutput ) );
+                    in[wire.toInput] = leaf != leaves.end() ? ( index >> ( leaf - leaves.begin() ) ) & 1 : outputs[wire.fromComponent];
+                }
+                outputs[gate] = ::Gate::Evaluate( static_cast<::Gate const*>( gate )->GetType(), in[0], in[1] );
+            }
+            lut.table[index >> 6] |= (uint64_t)outputs[component] << ( index & 63 );
+        }
+
+        // the root now reads the leaves, and the rest of the cone is left out
+        inputs[component].clear();
+        for ( auto& leaf : leaves )
+        {
+            lut.leaves.emplace_back( leaf.first->p_.get(), leaf.second );
+            inputs[component].push_back( { leaf.first, leaf.second, -1 } );
+        }
+
+        for ( auto gate = gates.begin(); gate + 1 != gates.end(); ++gate )
+        {
+            elided.insert( *gate );
+            elided_.emplace_back( *gate );
+        }
+        lutGateCount_ += gates.size();
+
+        luts_.emplace_back( std::move( lut ) );
+    }
+}
+
+void internal::Circuit::CompileClusters( std::vector<::Component*> const& groups, std::vector<size_t> const& groupOffsets,
+                                         std::unordered_map<::Component*, int>& indices )
+{
+    clusters_.clear();
+    rootClusters_.clear();
+
+    size_t clusterCount = (size_t)ThreadPool::GetDefault().GetThreadCount() * clustersPerThread;
+    size_t clusterSize = std::max<size_t>( minClusterSize, ( schedule_.size() + clusterCount - 1 ) / clusterCount );
+
+    // each wire orders its components as the schedule does: the receiver after its driver, or for
+    // a feedback wire, the driver after its receiver (which reads the previous tick's output)
+    std::vector<std::vector<int>> predecessors( schedule_.size() );
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        for ( auto& input : inputs_[i] )
+        {
+            auto from = indices.find( input.fromComponent );
+            if ( from == indices.end() )
+            {
+                continue;  // a constant gate
+            }
+
+            size_t fromIndex = from->second;
+            if ( fromIndex < i )
+            {
+                predecessors[i].push_back( fromIndex );
+            }
+            else if ( fromIndex > i )
+            {
+                predecessors[fromIndex].push_back( i );
+            }
+        }
+    }
+
+    // grow clusters a strongly connected component at a time (so that every feedback loop is
+    // ticked by a single cluster), in scan order, which follows the wires into each component, and
+    // in which every component comes after its predecessors outside its own loop
+    std::vector<int> clusterNos( schedule_.size(), -1 );
+    std::vector<size_t> clusterSizes;
+    for ( size_t groupNo = 0; groupNo + 1 < groupOffsets.size(); ++groupNo )
+    {
+        auto begin = groups.begin() + groupOffsets[groupNo];
+        auto end = groups.begin() + groupOffsets[groupNo + 1];
+
+        // join the newest cluster we must follow, or if that's full (or there is none), the
+        // newest cluster of all
+        int clusterNo = -1;
+        for ( auto member = begin; member != end; ++member )
+        {
+            for ( auto predecessor : predecessors[indices[*member]] )
+            {
+                clusterNo = std::max( clusterNo, clusterNos[predecessor] );
+            }
+        }
+
+        if ( clusterNo < 0 || clusterSizes[clusterNo] >= clusterSize )
+        {
+            clusterNo = (int)clusterSizes.size() - 1;
+        }
+        if ( clusterNo < 0 || clusterSizes[clusterNo] >= clusterSize )
+        {
+            clusterNo = clusterSizes.size();
+            clusterSizes.push_back( 0 );
+        }
+
+        for ( auto member = begin; member != end; ++member )
+        {
+            clusterNos[indices[*member]] = clusterNo;
+        }
+        clusterSizes[clusterNo] += end - begin;
+    }
+
+    clusters_.resize( clusterSizes.size() );
+    for ( size_t clusterNo = 0; clusterNo < clusters_.size(); ++clusterNo )
+    {
+        clusters_[clusterNo] = std::unique_ptr<Cluster>( new Cluster() );
+        clusters_[clusterNo]->members.reserve( clusterSizes[clusterNo] );
+        clusters_[clusterNo]->task = [this, clusterNo]() { RunCluster( clusterNo ); };
+    }
+
+    for ( size_t i = 0; i < schedule_.size(); ++i )
+    {
+        clusters_[clusterNos[i]]->members.push_back( i );
+
+        for ( auto predecessor : predecessors[i] )
+        {
+            if ( clusterNos[predecessor] != clusterNos[i] )
+            {
+                clusters_[clusterNos[predecessor]]->successors.push_back( clusterNos[i] );
+            }
+        }
+    }
+
+    // note where each cluster must settle the feedback loops it ticks
+    for ( size_t loopNo = 0; loopNo < loops_.size(); ++loopNo )
+    {
+        int last = loops_[loopNo].members.back();
+        auto& members = clusters_[clusterNos[last]]->members;
+        clusters_[clusterNos[last]]->loopEnds.emplace_back( std::lower_bound( members.begin(), members.end(), last ) - members.begin(), loopNo );
+    }
+
+    for ( auto& cluster : clusters_ )
+    {
+        auto& successors = cluster->successors;
+        std::sort( successors.begin(), successors.end() );
+        successors.erase( std::unique( successors.begin(), successors.end() ), successors.end() );
+
+        for ( auto successorNo : successors )
+        {
+            ++clusters_[successorNo]->predecessorCount;
+        }
+    }
+
+    for ( size_t clusterNo = 0; clusterNo < clusters_.size(); ++clusterNo )
+    {
+        if ( clusters_[clusterNo]->predecessorCount == 0 )
+        {
+            rootClusters_.push_back( clusterNo );
+        }
+    }
+}
+
+void internal::Circuit::CompileLaneBatches()
+{
+    laneBatches_.clear();
+
+    if ( laneCount_ == 0 )
+    {
+        return;
+    }
+
+    int laneWordCount = laneCount_ / 64;
+    zeroLanes_.assign( laneWordCount, 0 );
+
+    laneBatches_.resize( dirty_.size() );
+    for ( size_t bufferNo = 0; bufferNo < laneBatches_.size(); ++bufferNo )
+    {
+        auto& batches = laneBatches_[bufferNo];
+
+        for ( size_t level = 0; level < levelOffsets_.size(); ++level )
+        {
+            size_t levelEnd = level + 1 < levelOffsets_.size() ? levelOffsets_[level + 1] : schedule_.size();
+            size_t firstBatch = batches.size();
+
+            for ( size_t i = levelOffsets_[level]; i < levelEnd; ++i )
+            {
+                auto& gateOp = gateOps_[i];
+                if ( gateOp.type < 0 )
+                {
+                    continue;
+                }
+
+                // find (or add) this level's batch for this gate type
+                size_t batchNo = firstBatch;
+                while ( batchNo < batches.size() && batches[batchNo].op != (LaneOp)gateOp.type )
+                {
+                    ++batchNo;
+                }
+                if ( batchNo == batches.size() )
+                {
+                    batches.push_back( { (int)level, (LaneOp)gateOp.type, {}, {} } );
+                }
+
+                auto inputLanes = [this, bufferNo, laneWordCount]( Component* in, int output ) -> uint64_t const* {
+                    return in != nullptr ? &in->outputBuses_[bufferNo].lanes_[(size_t)output * laneWordCount] : zeroLanes_.data();
+                };
+
+                auto& outputBus = schedule_[i]->p_->outputBuses_[bufferNo];
+
+                batches[batchNo].gates.push_back(
+                    { outputBus.lanes_.data(), inputLanes( gateOp.in0, gateOp.in0Output ), inputLanes( gateOp.in1, gateOp.in1Output ) } );
+                batches[batchNo].outputBuses.push_back( &outputBus );
+            }
+        }
+    }
+}
+
+void internal::Circuit::Tick( ::Component::TickMode mode, int bufferNo )
+{
+#ifdef SCOTTCPU_TRACE
+    Trace::Scope traceScope( "Tick", "circuit", bufferNo );
+#endif
+
+    if ( mode == ::Component::TickMode::EventDriven )
+    {
+        TickEventDriven( bufferNo );
+    }
+    else if ( laneCount_ != 0 )
+    {
+        TickLanes( bufferNo );
+    }
+    else if ( mode == ::Component::TickMode::Parallel && clusters_.size() > 1 && circuitThreads_.size() <= 1 )
+    {
+        // multiple buffers already tick in parallel, each in its own circuit thread
+        TickClusters( bufferNo );
+    }
+    else
+    {
+        TickSeries( bufferNo );
+    }
+
+    // flattened sub-circuits aren't processed themselves, but must still pass on their turn to
+    // process, in case a sub-circuit is later ticked by itself
+    for ( auto subCircuit : subCircuits_ )
+    {
+        subCircuit->p_->SkipProcess( bufferNo );
+    }
+}
+
+void internal::Circuit::TickComponent( int scheduleIndex, int bufferNo, bool reprocess )
+{
+    // The schedule guarantees that all non-feedback input components have already been ticked,
+    // so unlike Component::Tick(), there is no need to recurse or track tick status.
+
+    auto component = schedule_[scheduleIndex];
+    auto& inputBus = component->p_->inputBuses_[bufferNo];
+
+    // 1. copy new inputs from incoming components
+
+    // Outputs are always copied rather than moved here (see internal::Component::GetOutput()), as
+    // built-in gates read their inputs straight from the output buses of the components that
+    // drive them, and resolved inputs bypass the sub-circuit ports that hold reference counts.
+    for ( auto& input : inputs_[scheduleIndex] )
+    {
+        inputBus.CopySignal( input.toInput, input.fromComponent->p_->outputBuses_[bufferNo], input.fromOutput );
+
+#ifdef SCOTTCPU_STATS
+        auto& stats = *input.fromComponent->p_->stats_[bufferNo];
+        stats.Add( stats.signalCopies, 1 );
+#endif
+    }
+
+    // 2. clear outputs and call Process() with newly aquired inputs (when settling a feedback loop,
+    // the component has already taken its turn to process this tick)
+    if ( reprocess )
+    {
+        component->p_->outputBuses_[bufferNo].ClearAllValues();
+        component->CallProcess( bufferNo );
+    }
+    else
+    {
+        component->DoProcess( bufferNo );
+    }
+
+    // 3. clear inputs
+    inputBus.ClearAllValues();
+}
+
+void internal::Circuit::TickSeries( int bufferNo )
+{
+    // tick all components in a single sweep of the compiled schedule, settling each feedback loop
+    // before the components it drives
+    size_t begin = 0;
+    if ( maxFeedbackIterations_ > 1 )
+    {
+        for ( auto& loop : loops_ )
+        {
+            TickRange( begin, loop.members.back() + 1, bufferNo );
+            SettleLoop( loop, bufferNo );
+            begin = loop.members.back() + 1;
+        }
+    }
+    TickRange( begin, schedule_.size(), bufferNo );
+}
+
+void internal::Circuit::TickRange( size_t begin, size_t end, int bufferNo )
+{
+    for ( size_t i = begin; i < end; ++i )
+    {
+        if ( gateOps_[i].type < 0 )
+        {
+            TickComponent( i, bufferNo );
+        }
+        else if ( !nativeRunNos_.empty() && nativeRunNos_[i] >= 0 )
+        {
+            auto& run = nativeRuns_[nativeRunNos_[i]];
+            run.function( nativeWords_[bufferNo].data() );
+            i = run.end - 1;
+        }
+        else
+        {
+            EvaluateGate( i, bufferNo );
+        }
+    }
+}
+
+void internal::Circuit::TickClusters( int bufferNo )
+{
+    clusterBufferNo_ = bufferNo;
+    pendingClusterCount_ = clusters_.size();
+
+    for ( auto& cluster : clusters_ )
+    {
+        cluster->pendingCount = cluster->predecessorCount;
+    }
+
+    for ( auto clusterNo : rootClusters_ )
+    {
+        ThreadPool::GetDefault().Submit( &clusters_[clusterNo]->task );
+    }
+
+    // the last cluster to finish sets clustersDone_
+    clustersDone_.Wait();
+    clustersDone_.Clear();
+}
+
+void internal::Circuit::RunCluster( int clusterNo )
+{
+    auto& cluster = *clusters_[clusterNo];
+    int bufferNo = clusterBufferNo_;
+
+    {
+#ifdef SCOTTCPU_TRACE
+        Trace::Scope traceScope( "Cluster", "circuit", bufferNo );
+#endif
+
+        // as in TickSeries()
+        size_t begin = 0;
+        auto tickMembers = [this, &cluster, &begin, bufferNo]( size_t end ) {
+            for ( ; begin < end; ++begin )
+            {
+                int i = cluster.members[begin];
+                if ( gateOps_[i].type < 0 )
+                {
+                    TickComponent( i, bufferNo );
+                }
+                else
+                {
+                    EvaluateGate( i, bufferNo );
+                }
+            }
+        };
+
+        if ( maxFeedbackIterations_ > 1 )
+        {
+            for ( auto& loopEnd : cluster.loopEnds )
+            {
+                tickMembers( loopEnd.first + 1 );
+                SettleLoop( loops_[loopEnd.second], bufferNo );
+            }
+        }
+        tickMembers( cluster.members.size() );
+    }
+
+    // let successor clusters tick once all of their predecessors are done
+    for ( auto successorNo : cluster.successors )
+    {
+        auto& successor = *clusters_[successorNo];
+        if ( --successor.pendingCount == 0 )
+        {
+            ThreadPool::GetDefault().Submit( &successor.task );
+        }
+    }
+
+    if ( --pendingClusterCount_ == 0 )
+    {
+        clustersDone_.Set();
+    }
+}
+
+void internal::Circuit::TickLanes( int bufferNo )
+{
+    auto& batches = laneBatches_[bufferNo];
+    size_t batchNo = 0;
+    size_t loopNo = maxFeedbackIterations_ > 1 ? 0 : loops_.size();
+
+    for ( size_t level = 0; level < levelOffsets_.size(); ++level )
+    {
+        size_t levelEnd = level + 1 < levelOffsets_.size() ? levelOffsets_[level + 1] : schedule_.size();
+
+        // a level's components don't depend on one another, so tick the other components first...
+        for ( size_t i = levelOffsets_[level]; i < levelEnd; ++i )
+        {
+            if ( gateOps_[i].type < 0 )
+            {
+                TickComponent( i, bufferNo );
+            }
+#ifdef SCOTTCPU_STATS
+            else
+            {
+                auto& stats = *schedule_[i]->p_->stats_[bufferNo];
+                stats.Add( stats.tickCount, 1 );
+            }
+#endif
+        }
+
+        // ...then evaluate its built-in gates, one batch per gate type
+        for ( ; batchNo < batches.size() && batches[batchNo].level == (int)level; ++batchNo )
+        {
+            auto& batch = batches[batchNo];
+
+            LaneKernels::EvaluateBatch( batch.op, batch.gates.data(), batch.gates.size(), laneCount_ / 64 );
+
+            // as SetLanes() does, the gate's onebit value follows lane 0
+            for ( auto outputBus : batch.outputBuses )
+            {
+                outputBus->values_[0] = ( outputBus->values_[0] & ~uint64_t( 1 ) ) | ( outputBus->lanes_[0] & 1 );
+                outputBus->hasValues_[0] |= 1;
+            }
+        }
+
+        // settle the feedback loops that end at this level, before the levels they drive
+        for ( ; loopNo < loops_.size() && (size_t)loops_[loopNo].members.back() < levelEnd; ++loopNo )
+        {
+            SettleLoop( loops_[loopNo], bufferNo );
+        }
+    }
+}
+
+void internal::Circuit::EvaluateGate( int scheduleIndex, int bufferNo )
+{
+    // evaluate built-in gates straight from the packed outputs driving them
+    auto& gateOp = gateOps_[scheduleIndex];
+    if ( gateOp.lut >= 0 )
+    {
+        EvaluateLut( scheduleIndex, bufferNo );
+        return;
+    }
+
+    auto readBit = [bufferNo]( Component* in, int output ) {
+        if ( in == nullptr )
+        {
+            return false;
+        }
+        auto& bus = in->outputBuses_[bufferNo];
+        return ( bus.values_[output >> 6] & bus.hasValues_[output >> 6] & ( uint64_t( 1 ) << ( output & 63 ) ) ) != 0;
+    };
+
+    bool out = ::Gate::Evaluate( (::Gate::Type)gateOp.type, readBit( gateOp.in0, gateOp.in0Output ), readBit( gateOp.in1, gateOp.in1Output ) );
+
+    auto& outputBus = schedule_[scheduleIndex]->p_->outputBuses_[bufferNo];
+    outputBus.values_[0] = ( outputBus.values_[0] & ~uint64_t( 1 ) ) | (uint64_t)out;
+    outputBus.hasValues_[0] |= 1;
+
+#ifdef SCOTTCPU_STATS
+    auto& stats = *schedule_[scheduleIndex]->p_->stats_[bufferNo];
+    stats.Add( stats.tickCount, 1 );
+#endif
+}
+
+void internal::Circuit::EvaluateLut( int scheduleIndex, int bufferNo )
+{
+    // index the truth table with the leaves' packed output bits
+    auto& lut = luts_[gateOps_[scheduleIndex].lut];
+
+    unsigned index = 0;
+    for ( size_t i = 0; i < lut.leaves.size(); ++i )
+    {
+        auto& bus = lut.leaves[i].first->outputBuses_[bufferNo];
+        int output = lut.leaves[i].second;
+        index |= (unsigned)( ( bus.values_[output >> 6] & bus.hasValues_[output >> 6] ) >> ( output & 63 ) & 1 ) << i;
+    }
+
+    uint64_t out = ( lut.table[index >> 6] >> ( index & 63 ) ) & 1;
+
+    auto& outputBus = schedule_[scheduleIndex]->p_->outputBuses_[bufferNo];
+    outputBus.values_[0] = ( outputBus.values_[0] & ~uint64_t( 1 ) ) | out;
+    outputBus.hasValues_[0] |= 1;
+
+#ifdef SCOTTCPU_STATS
+    auto& stats = *schedule_[scheduleIndex]->p_->stats_[bufferNo];
+    stats.Add( stats.tickCount, 1 );
+#endif
+}
+
+void internal::Circuit::EvaluateGateLanes( int scheduleIndex, int bufferNo )
+{
+    // as a gate of a LaneBatch
+    auto& gateOp = gateOps_[scheduleIndex];
+    int laneWordCount = laneCount_ / 64;
+
+    auto inputLanes = [this, bufferNo, laneWordCount]( Component* in, int output ) -> uint64_t const* {
+        return in != nullptr ? &in->outputBuses_[bufferNo].lanes_[(size_t)output * laneWordCount] : zeroLanes_.data();
+    };
+
+    auto& outputBus = schedule_[scheduleIndex]->p_->outputBuses_[bufferNo];
+    LaneKernels::Evaluate( (LaneOp)gateOp.type, outputBus.lanes_.data(), inputLanes( gateOp.in0, gateOp.in0Output ),
+                           inputLanes( gateOp.in1, gateOp.in1Output ), laneWordCount );
+    outputBus.values_[0] = ( outputBus.values_[0] & ~uint64_t( 1 ) ) | ( outputBus.lanes_[0] & 1 );
+    outputBus.hasValues_[0] |= 1;
+
+#ifdef SCOTTCPU_STATS
+    auto& stats = *schedule_[scheduleIndex]->p_->stats_[bufferNo];
+    stats.Add( stats.tickCount, 1 );
+#endif
+}
+
+void internal::Circuit::ProcessGate( int scheduleIndex, int bufferNo )
+{
+    auto& gateOp = gateOps_[scheduleIndex];
+    if ( gateOp.lut >= 0 )
+    {
+        EvaluateLut( scheduleIndex, bufferNo );  // its leaves don't pass through its input bus
+        return;
+    }
+
+    auto& inputBus = schedule_[scheduleIndex]->p_->inputBuses_[bufferNo];
+    auto& outputBus = schedule_[scheduleIndex]->p_->outputBuses_[bufferNo];
+
+#ifdef SCOTTCPU_STATS
+    auto& stats = *schedule_[scheduleIndex]->p_->stats_[bufferNo];
+    stats.Add( stats.tickCount, 1 );
+#endif
+
+    if ( laneCount_ != 0 )
+    {
+        // inputs without a value hold zeroed lanes
+        LaneKernels::Evaluate( (LaneOp)gateOp.type, outputBus.lanes_.data(), inputBus.lanes_.data(),
+                               inputBus.GetSignalCount() > 1 ? &inputBus.lanes_[laneCount_ / 64] : zeroLanes_.data(), laneCount_ / 64 );
+        outputBus.values_[0] = ( outputBus.values_[0] & ~uint64_t( 1 ) ) | ( outputBus.lanes_[0] & 1 );
+        outputBus.hasValues_[0] |= 1;
+    }
+    else
+    {
+        // gates have at most 2 inputs, so they share the bus' first word
+        uint64_t inputBits = inputBus.values_[0] & inputBus.hasValues_[0];
+
+        bool out = ::Gate::Evaluate( (::Gate::Type)gateOp.type, ( inputBits & 1 ) != 0, ( inputBits & 2 ) != 0 );
+
+        outputBus.values_[0] = ( outputBus.values_[0] & ~uint64_t( 1 ) ) | (uint64_t)out;
+        outputBus.hasValues_[0] |= 1;
+    }
+}
+
+void internal::Circuit::TickEventDriven( int bufferNo )
+{
+    // after a resync, every component re-reads all of its inputs and is processed
+    bool resync = resync_[bufferNo] != 0;
+    resync_[bufferNo] = 0;
+
+    // as in TickSeries()
+    size_t begin = 0;
+    if ( maxFeedbackIterations_ > 1 )
+    {
+        for ( auto& loop : loops_ )
+        {
+            SweepEventDriven( begin, loop.members.back() + 1, bufferNo, resync );
+            SettleLoopEventDriven( loop, bufferNo );
+            begin = loop.members.back() + 1;
+        }
+    }
+    SweepEventDriven( begin, schedule_.size(), bufferNo, resync );
+}
+
+void internal::Circuit::SweepEventDriven( size_t begin, size_t end, int bufferNo, bool resync )
+{
+    auto& dirty = dirty_[bufferNo];
+
+    for ( size_t i = begin; i < end; ++i )
+    {
+        auto component = schedule_[i];
+        auto& p = *component->p_;
+
+        if ( resync )
+        {
+            for ( auto& input : inputs_[i] )
+            {
+                p.inputBuses_[bufferNo].UpdateSignal( input.toInput, input.fromComponent->p_->outputBuses_[bufferNo], input.fromOutput );
+            }
+        }
+        else if ( !dirty[i] && !alwaysProcessed_[i] )
+        {
+            // inputs unchanged, but in-order components still need to pass on their turn to process
+            p.SkipProcess( bufferNo );
+            continue;
+        }
+
+        dirty[i] = 0;
+
+        if ( gateOps_[i].type < 0 )
+        {
+            component->DoProcess( bufferNo );
+        }
+        else
+        {
+            ProcessGate( i, bufferNo );
+        }
+
+        ForwardChanges( i, bufferNo );
+    }
+}
+
+void internal::Circuit::ForwardChanges( int scheduleIndex, int bufferNo )
+{
+    // forward changed outputs to receiving inputs
+    auto& p = *schedule_[scheduleIndex]->p_;
+    auto& outputBus = p.outputBuses_[bufferNo];
+
+    for ( auto& fanOut : fanOuts_[scheduleIndex] )
+    {
+        if ( fanOut.toInput < 0 )
+        {
+            dirty_[bufferNo][fanOut.toIndex] = 1;  // a LUT reading this component's output directly
+            continue;
+        }
+
+        auto& inputBus = schedule_[fanOut.toIndex]->p_->inputBuses_[bufferNo];
+        if ( inputBus.UpdateSignal( fanOut.toInput, outputBus, fanOut.fromOutput ) )
+        {
+            dirty_[bufferNo][fanOut.toIndex] = 1;
+
+#ifdef SCOTTCPU_STATS
+            auto& stats = *p.stats_[bufferNo];
+            stats.Add( stats.signalCopies, 1 );
+#endif
+        }
+    }
+}
+
+void internal::Circuit::SettleLoop( FeedbackLoop& loop, int bufferNo )
+{
+    // The first pass over the loop was the tick itself, in which feedback wires read the previous
+    // tick's outputs. Each further pass re-reads them, until a pass leaves every output unchanged.
+    UpdateLoopOutputs( loop, bufferNo );
+
+    for ( int pass = 1; pass < maxFeedbackIterations_; ++pass )
+    {
+        for ( auto i : loop.members )
+        {
+            if ( gateOps_[i].type < 0 )
+            {
+                TickComponent( i, bufferNo, true );
+            }
+            else if ( laneCount_ != 0 )
+            {
+                EvaluateGateLanes( i, bufferNo );
+            }
+            else
+            {
+                EvaluateGate( i, bufferNo );
+            }
+        }
+
+        if ( !UpdateLoopOutputs( loop, bufferNo ) )
+        {
+            break;
+        }
+    }
+}
+
+void internal::Circuit::SettleLoopEventDriven( FeedbackLoop const& loop, int bufferNo )
+{
+    // re-process the members whose inputs changed (i.e. via a feedback wire), until none have
+    auto& dirty = dirty_[bufferNo];
+
+    for ( int pass = 1; pass < maxFeedbackIterations_; ++pass )
+    {
+        bool processed = false;
+
+        for ( auto i : loop.members )
+        {
+            if ( !dirty[i] )
+            {
+                continue;
+            }
+
+            dirty[i] = 0;
+            processed = true;
+
+            if ( gateOps_[i].type < 0 )
+            {
+                schedule_[i]->p_->outputBuses_[bufferNo].ClearAllValues();
+                schedule_[i]->CallProcess( bufferNo );
+            }
+            else
+            {
+                ProcessGate( i, bufferNo );
+            }
+
+            ForwardChanges( i, bufferNo );
+        }
+
+        if ( !processed )
+        {
+            break;
+        }
+    }
+}
+
+bool internal::Circuit::UpdateLoopOutputs( FeedbackLoop& loop, int bufferNo )
+{
+    // copy the members' output words into the loop's snapshot, returning true if any changed
+    auto& snapshot = loop.outputs[bufferNo];
+    size_t offset = 0;
+    bool changed = false;
+
+    auto update = [&snapshot, &offset, &changed]( std::vector<uint64_t> const& words ) {
+        if ( offset + words.size() > snapshot.size() )
+        {
+            snapshot.resize( offset + words.size() );  // word values first set on a member's bus
+            changed = true;
+        }
+        changed = changed || !std::equal( words.begin(), words.end(), snapshot.begin() + offset );
+        offset = std::copy( words.begin(), words.end(), snapshot.begin() + offset ) - snapshot.begin();
+    };
+
+    for ( auto i : loop.members )
+    {
+        auto& outputBus = schedule_[i]->p_->outputBuses_[bufferNo];
+        update( outputBus.values_ );
+        update( outputBus.hasValues_ );
+        update( outputBus.lanes_ );
+        update( outputBus.isWords_ );
+        update( outputBus.words_ );
+    }
+
+    return changed;
+}
+
+void internal::Circuit::ResyncEventDriven()
+{
+    for ( size_t i = 0; i < dirty_.size(); ++i )
+    {
+        dirty_[i].assign( schedule_.size(), 1 );
+        resync_[i] = 1;
+    }
+}
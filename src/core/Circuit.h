@@ -11,6 +11,9 @@
 
 #include "Component.h"
 
+#include <functional>
+#include <vector>
+
 namespace internal
 {
     class Circuit;
@@ -34,11 +37,17 @@ namespace internal
  * method can be called in a loop from the main application thread, or alternatively, 
  * by calling StartAutoTick(), a separate thread will spawn, automatically calling 
  * Tick() continuously until PauseAutoTick() or StopAutoTick() is called.
- * TickMode::Parallel (default) will spawn a thread per component in a circuit. 
- * The aim of this mode is to improve the performance of circuits that contain 
- * parallel branches. TickMode::Series on the other hand, tells the circuit to 
- * tick its components one-by-one in a single thread. This mode aims to improve 
- * the performance of circuits that do not contain parallel branches.
+ * TickMode::Parallel (default) runs clusters of connected components as tasks on
+ * a shared thread pool (see GetClusterCount()). The aim of this mode is to 
+ * improve the performance of circuits that contain parallel branches.
+ * TickMode::Series on the other hand, tells the circuit to tick its components
+ * one-by-one in a single thread. This mode aims to improve the performance of 
+ * circuits that do not contain parallel branches.
+ * TickMode::EventDriven only processes the components whose inputs have changed
+ * (see Tick()).
+ * Before ticking, a circuit is compiled into a schedule (see Compile()), which 
+ * flattens any SubCircuits it contains. SetLaneCount() switches a circuit into 
+ * bit-parallel mode.
  */ 
 
 class Circuit final
@@ -46,6 +55,28 @@ class Circuit final
 public:
     NONCOPYABLE( Circuit );
 
+    enum class SyncPolicy
+    {
+        Blocking,
+        Adaptive,
+        BusyPoll
+    };
+
+    struct Stats
+    {
+        struct ComponentStats
+        {
+            std::shared_ptr<Component const> component;
+            int componentIndex;  // of the circuit component that is, or contains, component
+            std::vector<Component::Stats> buffers;
+            Component::Stats total;
+        };
+
+        bool enabled = false;  // false if built without SCOTTCPU_STATS
+        int64_t tickCount = 0;
+        std::vector<ComponentStats> components;
+    };
+
     Circuit();
     ~Circuit();
 
@@ -68,13 +99,208 @@ public:
     void SetBufferCount( int bufferCount );
     int GetBufferCount() const;
 
+    /**
+     * @brief Switches the circuit into bit-parallel mode
+     *
+     * Each Tick() then evaluates laneCount independent instances of the circuit
+     * at once (see Component::ProcessLanes()). Every component added to the
+     * circuit inherits the circuit's lane count.
+     */
+
+    void SetLaneCount( int laneCount );
+    int GetLaneCount() const;
+
+    /**
+     * @brief Selects how buffer threads wait for a hand-over
+     *
+     * Every Tick() of a multi-buffered circuit hands control over to the next
+     * buffer's thread and back. SyncPolicy::Blocking (default) sleeps on a
+     * condition variable, SyncPolicy::Adaptive spins briefly before sleeping on
+     * a futex, and SyncPolicy::BusyPoll never sleeps, which gives the lowest
+     * latency when each thread has a dedicated core, but wastes CPU time
+     * otherwise.
+     */
+
+    void SetSyncPolicy( SyncPolicy policy );
+    SyncPolicy GetSyncPolicy() const;
+
+    /**
+     * @brief Sorts the circuit's components into a schedule
+     *
+     * Components are sorted topologically into levels, such that each component
+     * only depends on components of lower levels (feedback wires excepted), and
+     * sub-circuits are flattened into the one schedule (see SubCircuit). Each
+     * Series tick is then a single linear sweep through the schedule, and a
+     * Parallel tick reads every wire in the same order, so both modes tick a
+     * circuit alike. For TickMode::Parallel, the schedule is also partitioned
+     * into clusters of connected components, few enough that each has a
+     * worthwhile amount of work to do, so that threads only synchronise where
+     * wires cross cluster boundaries. Compiling also finds the circuit's
+     * feedback loops (strongly connected components), such as the cross-coupled
+     * gates of a latch, and schedules every component a loop drives after the
+     * whole loop. Adding, removing or connecting components via the Circuit
+     * invalidates the schedule, and the circuit is recompiled automatically on
+     * the next tick.
+     */
+
+    void Compile();
+    bool IsCompiled() const;
+    int GetLevelCount() const;
+    int GetClusterCount() const;
+    int GetFeedbackLoopCount() const;
+
+    /**
+     * @brief Re-ticks each feedback loop within a tick until it settles
+     *
+     * By default, a feedback wire reads the output its driver produced on the
+     * previous tick, so a latch may take more than one tick to settle. With
+     * iterations set, each loop is instead re-ticked until its outputs stop
+     * changing, up to that many passes in all, before anything it drives is
+     * ticked (a loop that never settles, like a ring oscillator, is left as it
+     * is after the last pass). Components in a loop may therefore be processed
+     * several times per tick, so should, as in TickMode::EventDriven, only
+     * depend on their inputs.
+     */
+
+    void SetMaxFeedbackIterations( int iterations );
+    int GetMaxFeedbackIterations() const;
+
+    /**
+     * @brief Has compiling fold constant gates and skip dead ones
+     *
+     * A built-in gate (see Gate) whose output is fixed, because its inputs are
+     * unconnected or constant, or one of them holds the gate's controlling
+     * value (0 for And and Nand, 1 for Or and Nor), has its output set once and
+     * is no longer ticked (see GetFoldedGateCount()). A gate that drives no
+     * other kind of component, directly or through other gates, is not ticked
+     * at all (see GetDeadGateCount()), so its output is left as it was. A
+     * component output watched by RunUntil() is always kept up to date. The
+     * circuit itself is left as it was built: its components, GetStats() and
+     * Netlist::Write() still cover every gate.
+     */
+
+    void SetOptimizeLogic( bool optimize );
+    bool GetOptimizeLogic() const;
+    int GetFoldedGateCount() const;
+    int GetDeadGateCount() const;
+
+    /**
+     * @brief Has compiling map built-in gates onto lookup tables
+     *
+     * With inputCount set (1 to 8, 0 by default), each gate outside feedback
+     * loops, together with the gates that only it reads (directly or through
+     * each other), as long as they read at most inputCount distinct outputs
+     * between them, becomes one LUT, whose output is a single truth table
+     * lookup indexed by those outputs. Only the LUT's last gate is ticked, and
+     * the others' outputs are left as they were (see GetLutCount() and
+     * GetLutGateCount()). LUTs tick exactly as their gates would, but a
+     * bit-parallel circuit, whose gates are already evaluated in batches, is
+     * not mapped.
+     */
+
+    void SetLutInputCount( int inputCount );
+    int GetLutInputCount() const;
+    int GetLutCount() const;
+    int GetLutGateCount() const;
+
+    /**
+     * @brief Has compiling generate native code for the built-in gates
+     *
+     * Straight-line C++ is generated for the gates (and LUTs) of the schedule,
+     * one statement per gate, built into a shared object with the system
+     * compiler (SCOTTCPU_CXX, or c++), and loaded, so that Series ticks
+     * evaluate every run of gates between other components in a single call.
+     * Building takes a second or so, but is only done once for any one circuit,
+     * as the shared objects are cached in a private directory in the temporary
+     * directory. IsNative() tells whether generated code is in use: it isn't in
+     * bit-parallel mode, or if the code could not be built or loaded (only
+     * Unix-like systems are supported), in which case the circuit ticks as
+     * usual. Gates evaluated by generated code are not counted in GetStats().
+     */
+
+    void SetCodegen( bool enabled );
+    bool GetCodegen() const;
+    bool IsNative() const;
+
+    /**
+     * @brief Ticks every component of the circuit once
+     *
+     * TickMode::EventDriven sweeps the compiled schedule, but only processes
+     * components whose inputs have changed since they were last processed,
+     * components that have no inputs, and VcdWriters. It therefore assumes that
+     * a component's outputs only depend on its inputs (and for input-less
+     * components, on internal state). Once a circuit has been ticked a few
+     * times in a given mode, further ticks do not allocate memory (unless the
+     * circuit or its buffer or lane count changes).
+     */
+
     void Tick(Component::TickMode mode = Component::TickMode::Parallel);
 
+    /**
+     * @brief Ticks the circuit tickCount times, as that many calls to Tick()
+     * would
+     *
+     * The ticks run without returning to the caller in between. With buffers,
+     * each circuit thread is handed all of its ticks at once, rather than one
+     * tick per hand-off.
+     */
+
+    void TickN(int64_t tickCount, Component::TickMode mode = Component::TickMode::Parallel);
+
+    /**
+     * @brief Ticks the circuit until a predicate holds after a tick
+     *
+     * Stops after maxTicks ticks otherwise, and returns the number of ticks
+     * run. The predicate can be a function, or a component output (such as a
+     * CPU's halt line) having a given value (in bit-parallel mode, in lane 0).
+     * With buffers, each tick is finished before the predicate is checked, so
+     * no threads are ticking while it is. The predicate must not modify the
+     * circuit.
+     */
+
+    int64_t RunUntil(const std::function<bool()>& predicate, int64_t maxTicks, Component::TickMode mode = Component::TickMode::Parallel);
+    int64_t RunUntil(const std::shared_ptr<Component const>& component, int output, bool value, int64_t maxTicks,
+                     Component::TickMode mode = Component::TickMode::Parallel);
+
+    /**
+     * @brief Returns a snapshot of every component's statistics
+     *
+     * Only collected when built with SCOTTCPU_STATS (see Component::Stats), per
+     * buffer and in total, to help find the components a circuit spends its
+     * time in. Components inside sub-circuits are listed individually, after
+     * the sub-circuit itself. Built-in gates evaluated straight from the
+     * compiled schedule are counted, but not timed.
+     */
+
+    Stats GetStats() const;
+    void ResetStats();
+
+    /**
+     * @brief Snapshots the simulation state of the circuit
+     *
+     * The state holds the value of every input and output signal (which
+     * includes the values held by feedback wires) of every component, in every
+     * buffer and lane, and the next buffer to tick. RestoreState() returns the
+     * circuit to that state, so a circuit can be brought up once and then
+     * restarted from the same point any number of times. A state can only be
+     * restored into a circuit of the same structure, buffer count and lane
+     * count (otherwise RestoreState() returns false). State held in a
+     * component's own member variables (such as a Memory's contents) is only
+     * captured if the component saves it (see Component::SaveState()).
+     */
+
+    std::vector<uint64_t> SaveState();
+    bool SaveState( const std::string& filePath );
+    bool RestoreState( std::vector<uint64_t> const& state );
+    bool RestoreState( const std::string& filePath );
+
     void StartAutoTick(Component::TickMode mode = Component::TickMode::Parallel);
     void StopAutoTick();
     void PauseAutoTick();
     void ResumeAutoTick();
 
 private:
+    friend class Netlist;
+
     std::unique_ptr<internal::Circuit> p_;    
 };
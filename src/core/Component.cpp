@@ -9,63 +9,11 @@
 
 #include "Component.h"
 
-#include "internal/ComponentThread.h"
-#include "internal/Wire.h"
+#include "internal/Component.h"
 
-#include <mutex>
-#include <condition_variable>
-#include <unordered_set>
-
-namespace internal
-{
-
-class Component
-{
-public:
-
-    enum class TickStatus
-    {
-        NotTicked,
-        TickStarted,
-        Ticking
-    };
-
-    Component(::Component::ProcessOrder processOrder) : processOrder_(processOrder)
-    {}
-
-    void WaitForRelease( int threadNo );
-    void ReleaseThread( int threadNo );
-
-    void GetOutput( int bufferNo, int fromOutput, int toInput, ::SignalBus& toBus, ::Component::TickMode mode );
-
-    void IncRefs( int output );
-    void DecRefs(int output);
-
-    const ::Component::ProcessOrder processOrder_;
-
-    int bufferCount_ = 0;
-
-    std::vector<::SignalBus> inputBuses_;
-    std::vector<::SignalBus> outputBuses_;
-
-    std::vector<std::vector<std::pair<int, int>>> refs_;  // ref_total:ref_counter per output, per buffer
-    std::vector<std::vector<std::unique_ptr<std::mutex>>> refMutexes_;
-
-    std::vector<Wire> inputWires_;
-
-    std::vector<std::unique_ptr<ComponentThread>> componentThreads_;
-    std::vector<std::unordered_set<Wire*>> feedbackWires_;
-
-    std::vector<TickStatus> tickStatuses_;
-    std::vector<bool> gotReleases_;
-    std::vector<std::unique_ptr<std::mutex>> releaseMutexes_;
-    std::vector<std::unique_ptr<std::condition_variable>> releaseCondts_;
-
-    std::vector<std::string> inputNames_;
-    std::vector<std::string> outputNames_;
-};
-
-}  // namespace internal
+#ifdef SCOTTCPU_TRACE
+#include "internal/Trace.h"
+#endif
 
 Component::Component(ProcessOrder processOrder)
 {
@@ -75,6 +23,12 @@ Component::Component(ProcessOrder processOrder)
 
 Component::~Component()
 {
+    // wait for any parallel ticks still running
+    for ( int i = 0; i < p_->bufferCount_; ++i )
+    {
+        p_->SyncTick( i );
+    }
+
     DisconnectAllInputs();    
 }
 
@@ -91,6 +45,12 @@ bool Component::ConnectInput(const std::shared_ptr<Component>& fromComponent, in
 
     p_->inputWires_.emplace_back( fromComponent, fromOutput, toInput );
 
+    // any of our wires may turn out to be a feedback wire while ticking
+    for ( auto& feedbackWires : p_->feedbackWires_ )
+    {
+        feedbackWires.reserve( p_->inputWires_.size() );
+    }
+
     // update source output's reference count
     fromComponent->p_->IncRefs( fromOutput );
 
@@ -178,7 +138,7 @@ void Component::SetBufferCount(int bufferCount)
     }
 
     // resize vectors
-    p_->componentThreads_.resize( bufferCount );
+    p_->parallelTicks_.resize( bufferCount );
     p_->feedbackWires_.resize( bufferCount );
 
     p_->tickStatuses_.resize( bufferCount );
@@ -193,15 +153,28 @@ void Component::SetBufferCount(int bufferCount)
     p_->refs_.resize( bufferCount );
     p_->refMutexes_.resize( bufferCount );
 
+#ifdef SCOTTCPU_STATS
+    p_->stats_.resize( bufferCount );
+#endif
+
     // init new vector values
     for (int i = p_->bufferCount_; i < bufferCount; ++i)
     {
-        p_->componentThreads_[i] = std::unique_ptr<internal::ComponentThread>( new internal::ComponentThread() );
+        p_->parallelTicks_[i] = std::unique_ptr<internal::Component::ParallelTick>( new internal::Component::ParallelTick() );
+        p_->parallelTicks_[i]->task = [this, i]() { RunParallelTick( i ); };
+
+        p_->feedbackWires_[i].reserve( p_->inputWires_.size() );
+
+#ifdef SCOTTCPU_STATS
+        p_->stats_[i] = std::unique_ptr<internal::Component::StatCounters>( new internal::Component::StatCounters() );
+#endif
 
         p_->tickStatuses_[i] = internal::Component::TickStatus::NotTicked;
 
         p_->inputBuses_[i].SetSignalCount(p_->inputBuses_[0].GetSignalCount());
         p_->outputBuses_[i].SetSignalCount(p_->outputBuses_[0].GetSignalCount());
+        p_->inputBuses_[i].SetLaneCount(p_->laneCount_);
+        p_->outputBuses_[i].SetLaneCount(p_->laneCount_);
 
         p_->gotReleases_[i] = false;
         p_->releaseMutexes_[i] = std::unique_ptr<std::mutex>( new std::mutex() );
@@ -224,7 +197,9 @@ void Component::SetBufferCount(int bufferCount)
 
     p_->gotReleases_[0] = true;
 
-    p_->bufferCount_ = bufferCount;    
+    p_->bufferCount_ = bufferCount;
+
+    p_->ReserveDependents();    
 }
 
 int Component::GetBufferCount() const
@@ -232,8 +207,37 @@ int Component::GetBufferCount() const
     return p_->inputBuses_.size();
 }
 
+void Component::SetLaneCount(int laneCount)
+{
+    if (laneCount < 0)
+    {
+        laneCount = 0;  // 0 lanes disables bit-parallel mode
+    }
+
+    for (auto& inputBus : p_->inputBuses_)
+    {
+        inputBus.SetLaneCount(laneCount);
+    }
+    for (auto& outputBus : p_->outputBuses_)
+    {
+        outputBus.SetLaneCount(laneCount);
+    }
+
+    p_->laneCount_ = p_->inputBuses_[0].GetLaneCount();
+}
+
+int Component::GetLaneCount() const
+{
+    return p_->laneCount_;
+}
+
 bool Component::Tick( Component::TickMode mode, int bufferNo )
 {
+    if ( mode == TickMode::EventDriven )
+    {
+        mode = TickMode::Series;  // only a circuit can tick event-driven
+    }
+
     if ( p_->tickStatuses_[bufferNo] == internal::Component::TickStatus::TickStarted )
     {
         // return false to indicate that we have already started a tick, and hence, are a feedback component.
@@ -262,7 +266,7 @@ bool Component::Tick( Component::TickMode mode, int bufferNo )
         {
             if ( !wire.fromComponent_->Tick( mode, bufferNo ) )
             {
-                p_->feedbackWires_[bufferNo].emplace( &wire );
+                p_->feedbackWires_[bufferNo].emplace_back( &wire );
             }
         }
     }
@@ -270,24 +274,11 @@ bool Component::Tick( Component::TickMode mode, int bufferNo )
     // 3. set tickStatus -> Ticking
     p_->tickStatuses_[bufferNo] = internal::Component::TickStatus::Ticking;
 
-    auto tick = [this, mode, bufferNo]() {
+    if ( mode == TickMode::Series )
+    {
         // 4. get new inputs from incoming components
         for ( auto& wire : p_->inputWires_ )
         {
-            if ( mode == TickMode::Parallel )
-            {
-                // wait for non-feedback incoming components to finish ticking
-                auto wireIndex = p_->feedbackWires_[bufferNo].find( &wire );
-                if ( wireIndex == p_->feedbackWires_[bufferNo].end() )
-                {
-                    wire.fromComponent_->p_->componentThreads_[bufferNo]->Sync();
-                }
-                else
-                {
-                    p_->feedbackWires_[bufferNo].erase( wireIndex );
-                }
-            }
-
             wire.fromComponent_->p_->GetOutput( bufferNo, wire.fromOutput_, wire.toInput_, p_->inputBuses_[bufferNo], mode );
         }
 
@@ -298,45 +289,63 @@ bool Component::Tick( Component::TickMode mode, int bufferNo )
         // output reference counting in internal::Component::GetOutput(), reseting the counter upon
         // the final request rather than in Reset().
 
-        // 5. clear outputs
-        p_->outputBuses_[bufferNo].ClearAllValues();
-
-        if ( p_->processOrder_ == ProcessOrder::InOrder && p_->bufferCount_ > 1 )
+        // 5. clear outputs and call Process() with newly aquired inputs
+        DoProcess( bufferNo );
+    }
+    else if ( mode == TickMode::Parallel )
+    {
+        // 4. run RunParallelTick() in the thread pool once all non-feedback incoming components
+        // have finished ticking (and for in-order components, once the previous buffer is done)
+        auto& parallelTick = *p_->parallelTicks_[bufferNo];
         {
-            // 6. wait for our turn to process
-            p_->WaitForRelease( bufferNo );
+            std::lock_guard<std::mutex> lock( parallelTick.mutex );
+            parallelTick.done = false;
+        }
 
-            // 7. call Process() with newly aquired inputs
-            Process( p_->inputBuses_[bufferNo], p_->outputBuses_[bufferNo] );
+        parallelTick.pendingCount = 1;  // hold the task back until all dependencies are counted
 
-            // 8. signal that we're done processing
-            p_->ReleaseThread( bufferNo );
+        for ( auto& wire : p_->inputWires_ )
+        {
+            auto& feedbackWires = p_->feedbackWires_[bufferNo];
+            if ( std::find( feedbackWires.begin(), feedbackWires.end(), &wire ) == feedbackWires.end() )
+            {
+                wire.fromComponent_->p_->AddDependent( bufferNo, parallelTick );
+            }
         }
-        else
+
+        if ( p_->processOrder_ == ProcessOrder::InOrder && p_->bufferCount_ > 1 )
         {
-            // 6. call Process() with newly aquired inputs
-            Process( p_->inputBuses_[bufferNo], p_->outputBuses_[bufferNo] );
+            p_->AwaitRelease( bufferNo );
         }
-    };
 
-    // do tick
-    if ( mode == TickMode::Series )
-    {
-        tick();
-    }
-    else if ( mode == TickMode::Parallel )
-    {
-        p_->componentThreads_[bufferNo]->Resume( tick );
+        parallelTick.DependencyMet();
     }
     
     // return true to indicate that we are now in "Ticking" state.
     return true;
 }
 
+void Component::RunParallelTick( int bufferNo )
+{
+    // 5. get new inputs from incoming components
+    for ( auto& wire : p_->inputWires_ )
+    {
+        wire.fromComponent_->p_->GetOutput( bufferNo, wire.fromOutput_, wire.toInput_, p_->inputBuses_[bufferNo], TickMode::Parallel );
+    }
+    p_->feedbackWires_[bufferNo].clear();
+
+    // 6. clear outputs and call Process() with newly aquired inputs (our turn to process has
+    // already come, see internal::Component::AwaitRelease())
+    DoProcess( bufferNo, true );
+
+    // 7. let dependent components tick
+    p_->FinishTick( bufferNo );
+}
+
 void Component::Reset( int bufferNo )
 {
     // wait for ticking to complete
-    p_->componentThreads_[bufferNo]->Sync();
+    p_->SyncTick( bufferNo );
 
     // clear inputs
     p_->inputBuses_[bufferNo].ClearAllValues();
@@ -345,6 +354,180 @@ void Component::Reset( int bufferNo )
     p_->tickStatuses_[bufferNo] = internal::Component::TickStatus::NotTicked;
 }
 
+std::shared_ptr<Component> Component::Clone() const
+{
+    return nullptr;
+}
+
+void Component::SaveState( std::vector<uint64_t>& state ) const
+{
+    state.clear();
+}
+
+bool Component::RestoreState( std::vector<uint64_t> const& state )
+{
+    return state.empty();
+}
+
+void Component::ProcessLanes( SignalBus const& inputs, SignalBus& outputs )
+{
+    // evaluate one lane at a time via Process()
+
+    thread_local SignalBus laneInputs;
+    thread_local SignalBus laneOutputs;
+    thread_local std::vector<uint64_t> outputLanes;
+    thread_local std::vector<bool> outputHasValues;
+
+    int laneWordCount = outputs.GetLaneWordCount();
+
+    laneInputs.SetSignalCount( inputs.GetSignalCount() );
+    laneOutputs.SetSignalCount( outputs.GetSignalCount() );
+    outputLanes.assign( (size_t)outputs.GetSignalCount() * laneWordCount, 0 );
+    outputHasValues.assign( outputs.GetSignalCount(), false );
+
+    for ( int lane = 0; lane < outputs.GetLaneCount(); ++lane )
+    {
+        int laneWord = lane / 64;
+        uint64_t laneMask = uint64_t( 1 ) << ( lane % 64 );
+
+        laneInputs.ClearAllValues();
+        for ( int i = 0; i < inputs.GetSignalCount(); ++i )
+        {
+            auto lanes = inputs.GetLanes( i );
+            if ( lanes != nullptr )
+            {
+                onebit bit;
+                bit.value = ( lanes[laneWord] & laneMask ) != 0;
+                laneInputs.SetValue( i, bit );
+            }
+        }
+
+        laneOutputs.ClearAllValues();
+        Process( laneInputs, laneOutputs );
+
+        for ( int i = 0; i < outputs.GetSignalCount(); ++i )
+        {
+            auto value = laneOutputs.GetValue( i );
+            if ( value != nullptr )
+            {
+                outputHasValues[i] = true;
+                if ( value->value )
+                {
+                    outputLanes[(size_t)i * laneWordCount + laneWord] |= laneMask;
+                }
+            }
+        }
+    }
+
+    for ( int i = 0; i < outputs.GetSignalCount(); ++i )
+    {
+        if ( outputHasValues[i] )
+        {
+            outputs.SetLanes( i, &outputLanes[(size_t)i * laneWordCount] );
+        }
+    }
+}
+
+void Component::DoProcess( int bufferNo, bool gotRelease )
+{
+    // clear outputs
+    p_->outputBuses_[bufferNo].ClearAllValues();
+
+    if ( p_->processOrder_ == ProcessOrder::InOrder && p_->bufferCount_ > 1 )
+    {
+        // wait for our turn to process
+        if ( !gotRelease )
+        {
+            p_->WaitForRelease( bufferNo );
+        }
+
+        // call Process() with newly aquired inputs
+        CallProcess( bufferNo );
+
+        // signal that we're done processing
+        p_->ReleaseThread( bufferNo );
+    }
+    else
+    {
+        // call Process() with newly aquired inputs
+        CallProcess( bufferNo );
+    }
+}
+
+void Component::CallProcess( int bufferNo )
+{
+#ifdef SCOTTCPU_TRACE
+    internal::Trace::Scope traceScope( "Process", "component", bufferNo, &typeid( *this ), this );
+#endif
+
+#ifdef SCOTTCPU_STATS
+    auto startNs = internal::Component::StatCounters::NowNs();
+#endif
+
+    if ( p_->laneCount_ != 0 )
+    {
+        ProcessLanes( p_->inputBuses_[bufferNo], p_->outputBuses_[bufferNo] );
+    }
+    else
+    {
+        Process( p_->inputBuses_[bufferNo], p_->outputBuses_[bufferNo] );
+    }
+
+#ifdef SCOTTCPU_STATS
+    auto& stats = *p_->stats_[bufferNo];
+    stats.Add( stats.tickCount, 1 );
+    stats.Add( stats.processNs, internal::Component::StatCounters::NowNs() - startNs );
+#endif
+}
+
+Component::Stats& Component::Stats::operator+=( Stats const& other )
+{
+    tickCount += other.tickCount;
+    processNs += other.processNs;
+    releaseWaitNs += other.releaseWaitNs;
+    syncWaitNs += other.syncWaitNs;
+    signalCopies += other.signalCopies;
+    signalMoves += other.signalMoves;
+    return *this;
+}
+
+Component::Stats Component::GetStats( int bufferNo ) const
+{
+    Stats result;
+
+#ifdef SCOTTCPU_STATS
+    if ( (unsigned)bufferNo < (unsigned)p_->bufferCount_ )
+    {
+        auto& stats = *p_->stats_[bufferNo];
+        result.tickCount = stats.tickCount;
+        result.processNs = stats.processNs;
+        result.releaseWaitNs = stats.releaseWaitNs;
+        result.syncWaitNs = stats.syncWaitNs;
+        result.signalCopies = stats.signalCopies;
+        result.signalMoves = stats.signalMoves;
+    }
+#else
+    (void)bufferNo;
+#endif
+
+    return result;
+}
+
+void Component::ResetStats()
+{
+#ifdef SCOTTCPU_STATS
+    for ( auto& stats : p_->stats_ )
+    {
+        stats->tickCount = 0;
+        stats->processNs = 0;
+        stats->releaseWaitNs = 0;
+        stats->syncWaitNs = 0;
+        stats->signalCopies = 0;
+        stats->signalMoves = 0;
+    }
+#endif
+}
+
 void Component::SetInputCount(const int inputCount,   const std::vector<std::string>& inputNames)
 {
     p_->inputNames_ = inputNames;
@@ -389,7 +572,18 @@ void internal::Component::WaitForRelease( int threadNo )
 
     if ( !gotReleases_[threadNo] )
     {
+#ifdef SCOTTCPU_STATS
+        auto startNs = StatCounters::NowNs();
+#endif
+#ifdef SCOTTCPU_TRACE
+        Trace::Scope traceScope( "ReleaseWait", "wait", threadNo );
+#endif
+
         releaseCondts_[threadNo]->wait( lock );  // wait for resume
+
+#ifdef SCOTTCPU_STATS
+        StatCounters::Add( stats_[threadNo]->releaseWaitNs, StatCounters::NowNs() - startNs );
+#endif
     }
     gotReleases_[threadNo] = false;  // reset the release flag
 }
@@ -398,10 +592,115 @@ void internal::Component::ReleaseThread( int threadNo )
 {
     threadNo = threadNo + 1 == bufferCount_ ? 0 : threadNo + 1;  // we're actually releasing the next available thread
 
-    std::lock_guard<std::mutex> lock( *releaseMutexes_[threadNo] );
+    ParallelTick* awaitingTick = nullptr;
+    {
+        std::lock_guard<std::mutex> lock( *releaseMutexes_[threadNo] );
+
+        if ( parallelTicks_[threadNo]->awaitingRelease )
+        {
+            // the next buffer's parallel tick was only waiting on this release
+            parallelTicks_[threadNo]->awaitingRelease = false;
+            awaitingTick = parallelTicks_[threadNo].get();
+        }
+        else
+        {
+            gotReleases_[threadNo] = true;
+            releaseCondts_[threadNo]->notify_all();
+        }
+    }
+
+    if ( awaitingTick != nullptr )
+    {
+        awaitingTick->DependencyMet();
+    }
+}
+
+void internal::Component::AwaitRelease( int bufferNo )
+{
+    std::lock_guard<std::mutex> lock( *releaseMutexes_[bufferNo] );
 
-    gotReleases_[threadNo] = true;
-    releaseCondts_[threadNo]->notify_all();
+    if ( gotReleases_[bufferNo] )
+    {
+        gotReleases_[bufferNo] = false;  // already released, take our turn now
+    }
+    else
+    {
+        // ReleaseThread() will meet this dependency instead of setting the release flag
+        ++parallelTicks_[bufferNo]->pendingCount;
+        parallelTicks_[bufferNo]->awaitingRelease = true;
+    }
+}
+
+bool internal::Component::AddDependent( int bufferNo, ParallelTick& dependent )
+{
+    auto& parallelTick = *parallelTicks_[bufferNo];
+
+    std::lock_guard<std::mutex> lock( parallelTick.mutex );
+
+    if ( parallelTick.done )
+    {
+        return false;  // nothing to wait for
+    }
+
+    ++dependent.pendingCount;
+    parallelTick.dependents.emplace_back( &dependent );
+    return true;
+}
+
+void internal::Component::FinishTick( int bufferNo )
+{
+    auto& parallelTick = *parallelTicks_[bufferNo];
+
+    // copy rather than swap, so that neither list loses its capacity
+    thread_local std::vector<ParallelTick*> dependents;
+    {
+        std::lock_guard<std::mutex> lock( parallelTick.mutex );
+
+        parallelTick.done = true;
+        dependents.assign( parallelTick.dependents.begin(), parallelTick.dependents.end() );
+        parallelTick.dependents.clear();
+        parallelTick.doneCondt.notify_all();
+    }
+
+    for ( auto dependent : dependents )
+    {
+        dependent->DependencyMet();
+    }
+}
+
+void internal::Component::SyncTick( int bufferNo )
+{
+    auto& parallelTick = *parallelTicks_[bufferNo];
+
+    std::unique_lock<std::mutex> lock( parallelTick.mutex );
+
+    if ( parallelTick.done )
+    {
+        return;
+    }
+
+#ifdef SCOTTCPU_STATS
+    auto startNs = StatCounters::NowNs();
+#endif
+#ifdef SCOTTCPU_TRACE
+    Trace::Scope traceScope( "SyncWait", "wait", bufferNo );
+#endif
+
+    parallelTick.doneCondt.wait( lock, [&parallelTick] { return parallelTick.done; } );
+
+#ifdef SCOTTCPU_STATS
+    StatCounters::Add( stats_[bufferNo]->syncWaitNs, StatCounters::NowNs() - startNs );
+#endif
+}
+
+void internal::Component::SkipProcess( int threadNo )
+{
+    if ( processOrder_ == ::Component::ProcessOrder::InOrder && bufferCount_ > 1 )
+    {
+        // let the next buffer process, even though we didn't
+        WaitForRelease( threadNo );
+        ReleaseThread( threadNo );
+    }
 }
 
 void internal::Component::GetOutput(
@@ -412,8 +711,6 @@ void internal::Component::GetOutput(
         return;
     }
 
-    auto& signal = outputBuses_[bufferNo].GetSignal( fromOutput );
-
     if ( mode == ::Component::TickMode::Parallel && refs_[bufferNo][fromOutput].first > 1 )
     {
         refMutexes_[bufferNo][fromOutput]->lock();
@@ -424,12 +721,20 @@ void internal::Component::GetOutput(
         // this is the final reference, reset the counter, move the signal
         refs_[bufferNo][fromOutput].second = 0;
 
-        toBus.MoveSignal( toInput, signal );
+        toBus.MoveSignal( toInput, outputBuses_[bufferNo], fromOutput );
+
+#ifdef SCOTTCPU_STATS
+        StatCounters::Add( stats_[bufferNo]->signalMoves, 1 );
+#endif
     }
     else
     {
         // otherwise, copy the signal
-        toBus.CopySignal( toInput, signal );
+        toBus.CopySignal( toInput, outputBuses_[bufferNo], fromOutput );
+
+#ifdef SCOTTCPU_STATS
+        StatCounters::Add( stats_[bufferNo]->signalCopies, 1 );
+#endif
     }
 
     if ( mode == ::Component::TickMode::Parallel && refs_[bufferNo][fromOutput].first > 1 )
@@ -444,6 +749,25 @@ void internal::Component::IncRefs( int output )
     {
         ++ref[output].first;
     }
+
+    ReserveDependents();
+}
+
+void internal::Component::ReserveDependents()
+{
+    // every wire from our outputs may add a dependent to our parallel tick, so make room for them
+    // all up front, rather than while ticking (capacity is kept when wires are removed)
+
+    size_t wireCount = 0;
+    for ( auto& ref : refs_[0] )
+    {
+        wireCount += ref.first;
+    }
+
+    for ( auto& parallelTick : parallelTicks_ )
+    {
+        parallelTick->dependents.reserve( wireCount );
+    }
 }
 
 void internal::Component::DecRefs( int output )
@@ -10,11 +10,13 @@
 #pragma once
 
 #include "SignalBus.h"
+#include <cstdint>
 #include <string>
 
 namespace internal
 {
     class Component;
+    class Circuit;
 }  // namespace internal
 
 
@@ -46,6 +48,35 @@ namespace internal
  * The Reset() method informs the component that the last circuit traversal has 
  * completed and hence can execute the next Tick() request.
  *
+ * When a Circuit has been compiled (see Circuit::Compile()), its components are
+ * instead ticked by the circuit itself, one-by-one in topological order, without
+ * recursing through input components and without a following call to Reset().
+ *
+ * In bit-parallel mode (see SetLaneCount()), every signal carries one bit per lane,
+ * where each lane is an independent instance of the circuit. Instead of Process(),
+ * the engine then calls ProcessLanes(), which should evaluate all lanes at once via 
+ * bitwise operations on the buses' lane words (see SignalBus::GetLanes()). The 
+ * default ProcessLanes() evaluates one lane at a time through Process(), which is
+ * only correct for components that hold no state between ticks.
+ *
+ * Components that hold simulation state in their own member variables (such as
+ * a memory's contents) should override SaveState() and RestoreState(), so that
+ * the state is captured by Circuit::SaveState() and Circuit::RestoreState(). 
+ * SaveState() fills a vector of words with the component's state, and 
+ * RestoreState() returns the component to a state so saved, or returns false if
+ * it can't. The defaults save nothing. Neither is called while the component's 
+ * circuit is ticking.
+ *
+ * Components that can be copied into a SubCircuit instance (see 
+ * SubCircuit::Instantiate()) should override Clone() to return a new, unconnected
+ * component of the same type and configuration. The default Clone() returns nullptr.
+ *
+ * When built with SCOTTCPU_STATS defined (see the SCOTTCPU_STATS CMake option),
+ * each component counts, per buffer, how often and for how long it processes, how
+ * long it waits on other buffers, and how many of its output signals are copied
+ * or moved to receiving inputs (see Stats). Otherwise no statistics are collected,
+ * and GetStats() returns all zeros.
+ *
  * <b>PERFORMANCE TIP:</b> If a component's Process() method is capable of 
  * processing buffers out-of-order within a stream processing circuit, consider
  * initialising its base with ProcessOrder::OutOfOrder to improve performance. 
@@ -65,7 +96,20 @@ public:
     enum class TickMode
     {
         Series,
-        Parallel
+        Parallel,
+        EventDriven
+    };
+
+    struct Stats
+    {
+        int64_t tickCount = 0;      // times processed
+        int64_t processNs = 0;      // time spent in Process() or ProcessLanes()
+        int64_t releaseWaitNs = 0;  // time spent waiting for an in-order turn to process
+        int64_t syncWaitNs = 0;     // time spent in Reset() waiting for a parallel tick to finish
+        int64_t signalCopies = 0;   // output signals copied to receiving inputs
+        int64_t signalMoves = 0;    // output signals moved to receiving inputs
+
+        Stats& operator+=( Stats const& other );
     };
 
     Component(ProcessOrder processOrder = ProcessOrder::InOrder);
@@ -86,17 +130,36 @@ public:
     void SetBufferCount(int bufferCount);
     int GetBufferCount() const;
 
+    void SetLaneCount(int laneCount);
+    int GetLaneCount() const;
+
     bool Tick( TickMode mode = TickMode::Parallel, int bufferNo = 0 );
     void Reset( int bufferNo = 0 );
 
+    Stats GetStats( int bufferNo = 0 ) const;
+    void ResetStats();
+
+    virtual std::shared_ptr<Component> Clone() const;
+
 protected:
 
     virtual void Process( SignalBus const&, SignalBus& ) = 0;
+    virtual void ProcessLanes( SignalBus const& inputs, SignalBus& outputs );
+
+    virtual void SaveState( std::vector<uint64_t>& state ) const;
+    virtual bool RestoreState( std::vector<uint64_t> const& state );
 
     void SetInputCount(const int inputCount,   const std::vector<std::string>& inputNames  = {});
     void SetOutputCount(const int outputCount, const std::vector<std::string>& outputNames = {});
 
 private:
+    friend class internal::Circuit;
+    friend class Netlist;
+    friend class SubCircuit;
+
+    void RunParallelTick( int bufferNo );
+    void DoProcess( int bufferNo, bool gotRelease = false );
+    virtual void CallProcess( int bufferNo );
 
     std::unique_ptr<internal::Component> p_;
 };
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "Gate.h"
+
+#include "internal/LaneKernels.h"
+
+static_assert( (int)Gate::Type::Xnor == (int)internal::LaneOp::Xnor, "Gate::Type must mirror internal::LaneOp" );
+
+Gate::Gate( Type type )
+    : Component( ProcessOrder::OutOfOrder )
+    , type_( type )
+{
+    if ( type == Type::Buf || type == Type::Not )
+    {
+        SetInputCount( 1, { "in" } );
+    }
+    else
+    {
+        SetInputCount( 2, { "in0", "in1" } );
+    }
+
+    SetOutputCount( 1, { "out" } );
+}
+
+Gate::Type Gate::GetType() const
+{
+    return type_;
+}
+
+std::shared_ptr<Component> Gate::Clone() const
+{
+    switch ( type_ )
+    {
+        case Type::Buf:
+            return std::make_shared<BufGate>();
+        case Type::Not:
+            return std::make_shared<NotGate>();
+        case Type::And:
+            return std::make_shared<AndGate>();
+        case Type::Nand:
+            return std::make_shared<NandGate>();
+        case Type::Or:
+            return std::make_shared<OrGate>();
+        case Type::Nor:
+            return std::make_shared<NorGate>();
+        case Type::Xor:
+            return std::make_shared<XorGate>();
+        case Type::Xnor:
+            return std::make_shared<XnorGate>();
+    }
+    return nullptr;
+}
+
+void Gate::Process( SignalBus const& inputs, SignalBus& outputs )
+{
+    auto in0 = inputs.GetValue( 0 );
+    auto in1 = inputs.GetValue( 1 );
+
+    onebit out;
+    out.value = Evaluate( type_, in0 != nullptr && in0->value, in1 != nullptr && in1->value );
+    outputs.SetValue( 0, out );
+}
+
+void Gate::ProcessLanes( SignalBus const& inputs, SignalBus& outputs )
+{
+    thread_local std::vector<uint64_t> zeroLanes;
+    thread_local std::vector<uint64_t> outLanes;
+
+    zeroLanes.assign( outputs.GetLaneWordCount(), 0 );
+    outLanes.resize( outputs.GetLaneWordCount() );
+
+    auto in0 = inputs.GetLanes( 0 );
+    auto in1 = inputs.GetLanes( 1 );
+
+    internal::LaneKernels::Evaluate( (internal::LaneOp)type_, outLanes.data(),
+                                     in0 != nullptr ? in0 : zeroLanes.data(),
+                                     in1 != nullptr ? in1 : zeroLanes.data(),
+                                     outputs.GetLaneWordCount() );
+
+    outputs.SetLanes( 0, outLanes.data() );
+}
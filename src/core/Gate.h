@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Component.h"
+
+/**
+ * @brief Built-in primitive logic gate
+ *
+ * Gates are Components, so can be added to a Circuit and routed to and from any
+ * other Component, including user-defined ones. Unlike user-defined components 
+ * however, a compiled Circuit recognises gates by their Type, and evaluates them 
+ * directly from the packed output bits of the components that drive them, without
+ * a virtual Process() call or a copy into the gate's input bus. In bit-parallel mode,
+ * gates of the same type within the same level are evaluated together in one batch
+ * (see internal::LaneKernels).
+ *
+ * Buf and Not gates have 1 input, all others have 2. An unconnected input, or one 
+ * that receives no value, reads as 0. A gate's single output always has a value.
+ */
+
+class Gate : public Component
+{
+public:
+    enum class Type
+    {
+        Buf,
+        Not,
+        And,
+        Nand,
+        Or,
+        Nor,
+        Xor,
+        Xnor
+    };
+
+    Gate( Type type );
+
+    Type GetType() const;
+
+    virtual std::shared_ptr<Component> Clone() const override;
+
+    static bool Evaluate( Type type, bool in0, bool in1 )
+    {
+        switch ( type )
+        {
+            case Type::Buf:
+                return in0;
+            case Type::Not:
+                return !in0;
+            case Type::And:
+                return in0 && in1;
+            case Type::Nand:
+                return !( in0 && in1 );
+            case Type::Or:
+                return in0 || in1;
+            case Type::Nor:
+                return !( in0 || in1 );
+            case Type::Xor:
+                return in0 != in1;
+            case Type::Xnor:
+                return in0 == in1;
+        }
+        return false;
+    }
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override final;
+    virtual void ProcessLanes( SignalBus const& inputs, SignalBus& outputs ) override final;
+
+private:
+    const Type type_;
+};
+
+class BufGate final : public Gate
+{
+public:
+    BufGate() : Gate( Type::Buf ) {}
+};
+
+class NotGate final : public Gate
+{
+public:
+    NotGate() : Gate( Type::Not ) {}
+};
+
+class AndGate final : public Gate
+{
+public:
+    AndGate() : Gate( Type::And ) {}
+};
+
+class NandGate final : public Gate
+{
+public:
+    NandGate() : Gate( Type::Nand ) {}
+};
+
+class OrGate final : public Gate
+{
+public:
+    OrGate() : Gate( Type::Or ) {}
+};
+
+class NorGate final : public Gate
+{
+public:
+    NorGate() : Gate( Type::Nor ) {}
+};
+
+class XorGate final : public Gate
+{
+public:
+    XorGate() : Gate( Type::Xor ) {}
+};
+
+class XnorGate final : public Gate
+{
+public:
+    XnorGate() : Gate( Type::Xnor ) {}
+};
@@ -0,0 +1,293 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "Memory.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace
+{
+
+std::vector<std::string> portNames( std::string const& prefix, int count )
+{
+    std::vector<std::string> names;
+    names.reserve( count );
+    for ( int i = 0; i < count; ++i )
+    {
+        names.emplace_back( prefix + std::to_string( i ) );
+    }
+    return names;
+}
+
+// count (up to 64) bits of a bus from signal offset up, signals without a value reading as 0
+uint64_t readBits( SignalBus const& bus, int offset, int count )
+{
+    auto values = bus.GetValueWords();
+    auto hasValues = bus.GetHasValueWords();
+
+    uint64_t bits = 0;
+    for ( int i = 0; i < count; )
+    {
+        int word = ( offset + i ) / 64;
+        int shift = ( offset + i ) % 64;
+        int chunkSize = std::min( 64 - shift, count - i );
+
+        uint64_t chunk = ( values[word] & hasValues[word] ) >> shift;
+        if ( chunkSize < 64 )
+        {
+            chunk &= ( uint64_t( 1 ) << chunkSize ) - 1;
+        }
+        bits |= chunk << i;
+        i += chunkSize;
+    }
+    return bits;
+}
+
+}  // namespace
+
+Memory::Memory( int addressBits, int width, bool readOnly )
+    : addressBits_( std::max( 0, std::min( addressBits, 24 ) ) )
+    , width_( std::max( 1, std::min( width, 64 ) ) )
+    , readOnly_( readOnly )
+    , wordBytes_( ( width_ + 7 ) / 8 )
+    , size_( ( size_t( 1 ) << addressBits_ ) * wordBytes_ )
+    , bytes_( size_, 0 )
+{
+    auto inputNames = portNames( "a", addressBits_ );
+    auto dataNames = portNames( "d", width_ );
+    inputNames.insert( inputNames.end(), dataNames.begin(), dataNames.end() );
+    inputNames.emplace_back( "set" );
+    inputNames.emplace_back( "enable" );
+
+    SetInputCount( inputNames.size(), inputNames );
+    SetOutputCount( width_, portNames( "q", width_ ) );
+}
+
+int Memory::GetAddressBits() const
+{
+    return addressBits_;
+}
+
+int Memory::GetWidth() const
+{
+    return width_;
+}
+
+bool Memory::IsReadOnly() const
+{
+    return readOnly_;
+}
+
+size_t Memory::GetSize() const
+{
+    return size_;
+}
+
+int Memory::GetDataInput() const
+{
+    return addressBits_;
+}
+
+int Memory::GetSetInput() const
+{
+    return addressBits_ + width_;
+}
+
+int Memory::GetEnableInput() const
+{
+    return addressBits_ + width_ + 1;
+}
+
+bool Memory::LoadImage( std::vector<uint8_t> const& image, size_t offset )
+{
+    if ( offset > size_ || image.size() > size_ - offset )
+    {
+        return false;
+    }
+
+    for ( int lane = 0; lane < laneCopies_; ++lane )
+    {
+        std::copy( image.begin(), image.end(), bytes_.begin() + lane * size_ + offset );
+    }
+    return true;
+}
+
+bool Memory::LoadImage( const std::string& filePath, size_t offset )
+{
+    std::FILE* file = std::fopen( filePath.c_str(), "rb" );
+    if ( file == nullptr )
+    {
+        return false;
+    }
+
+    // read one byte more than fits, to tell an image that is too large
+    std::vector<uint8_t> image( size_ - std::min( offset, size_ ) + 1 );
+    image.resize( std::fread( image.data(), 1, image.size(), file ) );
+
+    std::fclose( file );
+
+    return LoadImage( image, offset );
+}
+
+std::vector<uint8_t> Memory::Dump( int lane ) const
+{
+    if ( lane < 0 || lane >= laneCopies_ )
+    {
+        return {};
+    }
+    return std::vector<uint8_t>( bytes_.begin() + lane * size_, bytes_.begin() + ( lane + 1 ) * size_ );
+}
+
+bool Memory::Dump( const std::string& filePath, int lane ) const
+{
+    if ( lane < 0 || lane >= laneCopies_ )
+    {
+        return false;
+    }
+
+    std::FILE* file = std::fopen( filePath.c_str(), "wb" );
+    if ( file == nullptr )
+    {
+        return false;
+    }
+
+    bool result = std::fwrite( bytes_.data() + lane * size_, 1, size_, file ) == size_;
+
+    return std::fclose( file ) == 0 && result;
+}
+
+std::shared_ptr<Component> Memory::Clone() const
+{
+    auto memory = std::make_shared<Memory>( addressBits_, width_, readOnly_ );
+    std::copy( bytes_.begin(), bytes_.begin() + size_, memory->bytes_.begin() );
+    return memory;
+}
+
+void Memory::SaveState( std::vector<uint64_t>& state ) const
+{
+    // the byte count (size_ per lane copy), then the bytes, 8 to a word
+    state.assign( 1 + ( bytes_.size() + 7 ) / 8, 0 );
+    state[0] = bytes_.size();
+    for ( size_t i = 0; i < bytes_.size(); ++i )
+    {
+        state[1 + i / 8] |= (uint64_t)bytes_[i] << ( i % 8 * 8 );
+    }
+}
+
+bool Memory::RestoreState( std::vector<uint64_t> const& state )
+{
+    if ( state.empty() || state[0] == 0 || state[0] % size_ != 0 || state.size() != 1 + ( state[0] + 7 ) / 8 )
+    {
+        return false;
+    }
+
+    // as many lane copies as were saved
+    bytes_.resize( state[0] );
+    laneCopies_ = (int)( state[0] / size_ );
+    for ( size_t i = 0; i < bytes_.size(); ++i )
+    {
+        bytes_[i] = (uint8_t)( state[1 + i / 8] >> ( i % 8 * 8 ) );
+    }
+    return true;
+}
+
+uint64_t Memory::ReadWord( size_t byteIndex ) const
+{
+    uint64_t word = 0;
+    for ( int i = 0; i < wordBytes_; ++i )
+    {
+        word |= (uint64_t)bytes_[byteIndex + i] << ( i * 8 );
+    }
+    return width_ < 64 ? word & ( ( uint64_t( 1 ) << width_ ) - 1 ) : word;
+}
+
+void Memory::WriteWord( size_t byteIndex, uint64_t word )
+{
+    for ( int i = 0; i < wordBytes_; ++i )
+    {
+        bytes_[byteIndex + i] = (uint8_t)( word >> ( i * 8 ) );
+    }
+}
+
+void Memory::Process( SignalBus const& inputs, SignalBus& outputs )
+{
+    size_t byteIndex = readBits( inputs, 0, addressBits_ ) * wordBytes_;
+
+    if ( !readOnly_ && readBits( inputs, GetSetInput(), 1 ) != 0 )
+    {
+        WriteWord( byteIndex, readBits( inputs, GetDataInput(), width_ ) );
+    }
+
+    uint64_t word = readBits( inputs, GetEnableInput(), 1 ) != 0 ? ReadWord( byteIndex ) : 0;
+
+    for ( int i = 0; i < width_; ++i )
+    {
+        onebit bit;
+        bit.value = ( word >> i ) & 1;
+        outputs.SetValue( i, bit );
+    }
+}
+
+void Memory::ProcessLanes( SignalBus const& inputs, SignalBus& outputs )
+{
+    int laneCount = outputs.GetLaneCount();
+    int laneWordCount = outputs.GetLaneWordCount();
+
+    if ( laneCopies_ != laneCount )
+    {
+        // every new lane starts as a copy of lane 0
+        bytes_.resize( size_ * laneCount );
+        for ( int lane = laneCopies_; lane < laneCount; ++lane )
+        {
+            std::copy( bytes_.begin(), bytes_.begin() + size_, bytes_.begin() + lane * size_ );
+        }
+        laneCopies_ = laneCount;
+    }
+
+    thread_local std::vector<uint64_t> outLanes;
+    outLanes.assign( (size_t)width_ * laneWordCount, 0 );
+
+    auto readLaneBits = [&inputs]( int offset, int count, int laneWord, int laneBit ) {
+        uint64_t bits = 0;
+        for ( int i = 0; i < count; ++i )
+        {
+            auto lanes = inputs.GetLanes( offset + i );
+            bits |= lanes != nullptr ? ( ( lanes[laneWord] >> laneBit ) & 1 ) << i : 0;
+        }
+        return bits;
+    };
+
+    for ( int lane = 0; lane < laneCount; ++lane )
+    {
+        int laneWord = lane / 64;
+        int laneBit = lane % 64;
+
+        size_t byteIndex = lane * size_ + readLaneBits( 0, addressBits_, laneWord, laneBit ) * wordBytes_;
+
+        if ( !readOnly_ && readLaneBits( GetSetInput(), 1, laneWord, laneBit ) != 0 )
+        {
+            WriteWord( byteIndex, readLaneBits( GetDataInput(), width_, laneWord, laneBit ) );
+        }
+
+        if ( readLaneBits( GetEnableInput(), 1, laneWord, laneBit ) != 0 )
+        {
+            uint64_t word = ReadWord( byteIndex );
+            for ( int i = 0; i < width_; ++i )
+            {
+                outLanes[(size_t)i * laneWordCount + laneWord] |= ( ( word >> i ) & 1 ) << laneBit;
+            }
+        }
+    }
+
+    for ( int i = 0; i < width_; ++i )
+    {
+        outputs.SetLanes( i, &outLanes[(size_t)i * laneWordCount] );
+    }
+}
@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Component.h"
+
+/**
+ * @brief Native RAM or ROM component
+ *
+ * A Memory holds 2^addressBits words of width bits in a flat byte array, each 
+ * word taking (width + 7) / 8 bytes, least significant byte first. It stands in
+ * for a memory built out of gates (address decoders, and a latch per bit), with
+ * the same ports and behaviour, at the cost of a single component:
+ *
+ *   inputs:  a0 to a<addressBits - 1>, d0 to d<width - 1>, set, enable
+ *   outputs: q0 to q<width - 1>
+ *
+ * Every tick, while "set" is 1, the data inputs are written to the word at the
+ * address inputs. Then, while "enable" is 1, the outputs carry that word (the 
+ * newly written word, if "set" is also 1), otherwise they are all 0. Inputs 
+ * without a value read as 0. A read-only Memory (ROM) ignores "set" and the data
+ * inputs, and can only be changed via LoadImage(). Every word starts at 0.
+ *
+ * LoadImage() copies an image (from a buffer or a file) into the memory at a 
+ * given byte offset, and Dump() copies the whole memory out. Neither should be 
+ * called while the memory's circuit is ticking. Memory contents, of every lane's
+ * copy, are part of a Circuit's saved state (see Circuit::SaveState()). Note 
+ * that in TickMode::EventDriven, a Memory is only processed when one of its 
+ * inputs has changed, so a newly loaded image only shows on its outputs from 
+ * then on.
+ *
+ * In bit-parallel mode, each lane has its own copy of the memory, each starting
+ * as a copy of the memory when bit-parallel mode was entered. LoadImage() loads
+ * every lane's copy, and Dump() dumps a given lane's copy.
+ */
+
+class Memory final : public Component
+{
+public:
+    Memory( int addressBits, int width = 8, bool readOnly = false );
+
+    int GetAddressBits() const;
+    int GetWidth() const;
+    bool IsReadOnly() const;
+    size_t GetSize() const;
+
+    int GetDataInput() const;
+    int GetSetInput() const;
+    int GetEnableInput() const;
+
+    bool LoadImage( std::vector<uint8_t> const& image, size_t offset = 0 );
+    bool LoadImage( const std::string& filePath, size_t offset = 0 );
+    std::vector<uint8_t> Dump( int lane = 0 ) const;
+    bool Dump( const std::string& filePath, int lane = 0 ) const;
+
+    virtual std::shared_ptr<Component> Clone() const override;
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override;
+    virtual void ProcessLanes( SignalBus const& inputs, SignalBus& outputs ) override;
+
+    virtual void SaveState( std::vector<uint64_t>& state ) const override;
+    virtual bool RestoreState( std::vector<uint64_t> const& state ) override;
+
+private:
+    uint64_t ReadWord( size_t byteIndex ) const;
+    void WriteWord( size_t byteIndex, uint64_t word );
+
+    const int addressBits_;
+    const int width_;
+    const bool readOnly_;
+    const int wordBytes_;
+    const size_t size_;  // bytes per lane
+
+    int laneCopies_ = 1;
+    std::vector<uint8_t> bytes_;  // laneCopies_ copies of size_ bytes
+};
@@ -0,0 +1,393 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "Netlist.h"
+
+#include "Gate.h"
+#include "internal/Circuit.h"
+#include "internal/Component.h"
+#include "internal/Netlist.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCOTTCPU_MMAP
+#else
+#include <fstream>
+#endif
+
+constexpr char internal::Netlist::magic[8];
+
+namespace
+{
+
+// read-only view of a whole file, mapped into memory where possible
+class MappedFile final
+{
+public:
+    NONCOPYABLE( MappedFile );
+
+    explicit MappedFile( const std::string& filePath )
+    {
+#ifdef SCOTTCPU_MMAP
+        int fd = open( filePath.c_str(), O_RDONLY );
+        if ( fd < 0 )
+        {
+            return;
+        }
+
+        struct stat status;
+        if ( fstat( fd, &status ) == 0 && status.st_size > 0 )
+        {
+            void* data = mmap( nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( data != MAP_FAILED )
+            {
+                data_ = static_cast<char const*>( data );
+                size_ = status.st_size;
+            }
+        }
+
+        close( fd );
+#else
+        std::ifstream file( filePath, std::ios::binary | std::ios::ate );
+        if ( file )
+        {
+            buffer_.resize( file.tellg() );
+            file.seekg( 0 );
+            if ( file.read( buffer_.data(), buffer_.size() ) && !buffer_.empty() )
+            {
+                data_ = buffer_.data();
+                size_ = buffer_.size();
+            }
+        }
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef SCOTTCPU_MMAP
+        if ( data_ != nullptr )
+        {
+            munmap( const_cast<char*>( data_ ), size_ );
+        }
+#endif
+    }
+
+    char const* Data() const
+    {
+        return data_;
+    }
+
+    uint64_t Size() const
+    {
+        return size_;
+    }
+
+private:
+    char const* data_ = nullptr;
+    uint64_t size_ = 0;
+#ifndef SCOTTCPU_MMAP
+    std::vector<char> buffer_;
+#endif
+};
+
+// writes a section, padded to the next 8-byte boundary
+bool writeSection( std::FILE* file, void const* data, uint64_t size )
+{
+    static const char padding[8] = {};
+
+    return std::fwrite( data, 1, size, file ) == size &&
+           std::fwrite( padding, 1, internal::Netlist::Align( size ) - size, file ) == internal::Netlist::Align( size ) - size;
+}
+
+}  // namespace
+
+Netlist::Netlist()
+    : p_( new internal::Netlist() )
+{
+}
+
+Netlist::~Netlist() = default;
+
+void Netlist::RegisterType( std::type_info const& type, Factory const& factory )
+{
+    p_->factories_[type.name()] = factory;
+}
+
+bool Netlist::Write( Circuit& circuit, const std::string& filePath )
+{
+    using Header = internal::Netlist::Header;
+    using TypeEntry = internal::Netlist::TypeEntry;
+    using WireEntry = internal::Netlist::WireEntry;
+
+    if ( !circuit.IsCompiled() )
+    {
+        circuit.Compile();
+    }
+
+    // the circuit as built, including any gates the schedule leaves out, and with the wires of
+    // gates mapped onto LUTs (see Circuit::SetOptimizeLogic() and SetLutInputCount()), in the
+    // order compiled, so that a loaded circuit breaks its feedback loops at the same wires
+    auto& components = circuit.p_->roots_;
+
+    std::vector<std::vector<internal::Circuit::Input>> inputs;
+    inputs.reserve( components.size() );
+    for ( auto component : components )
+    {
+        inputs.emplace_back( circuit.p_->ResolveInputs( component, !circuit.p_->subCircuits_.empty() ) );
+    }
+
+    std::unordered_map<Component*, uint32_t> indices;
+    indices.reserve( components.size() );
+    for ( size_t i = 0; i < components.size(); ++i )
+    {
+        indices[components[i]] = i;
+    }
+
+    // component types, told apart by gate type, or C++ type, and IO counts
+    std::vector<TypeEntry> types;
+    std::string names;
+    std::map<std::tuple<int32_t, std::string, uint32_t, uint32_t>, uint32_t> typeIndices;
+
+    std::vector<uint32_t> componentTypes;
+    componentTypes.reserve( components.size() );
+    for ( auto component : components )
+    {
+        auto gate = dynamic_cast<Gate const*>( component );
+        auto key = std::make_tuple( gate != nullptr ? (int32_t)gate->GetType() : -1,
+                                    gate != nullptr ? std::string() : std::string( typeid( *component ).name() ),
+                                    (uint32_t)component->GetInputCount(), (uint32_t)component->GetOutputCount() );
+
+        auto typeIndex = typeIndices.find( key );
+        if ( typeIndex == typeIndices.end() )
+        {
+            auto& name = std::get<1>( key );
+            typeIndex = typeIndices.emplace( key, types.size() ).first;
+            types.push_back( { names.size(), (uint32_t)name.size(), std::get<0>( key ), std::get<2>( key ), std::get<3>( key ) } );
+            names += name;
+        }
+        componentTypes.emplace_back( typeIndex->second );
+    }
+
+    // the wires into each component, in CSR form
+    std::vector<uint64_t> wireOffsets;
+    std::vector<WireEntry> wires;
+    wireOffsets.reserve( components.size() + 1 );
+    for ( auto& componentInputs : inputs )
+    {
+        wireOffsets.emplace_back( wires.size() );
+        for ( auto& input : componentInputs )
+        {
+            wires.push_back( { indices[input.fromComponent], (uint32_t)input.fromOutput, (uint32_t)input.toInput } );
+        }
+    }
+    wireOffsets.emplace_back( wires.size() );
+
+    Header header;
+    std::memcpy( header.magic, internal::Netlist::magic, sizeof( header.magic ) );
+    header.version = internal::Netlist::version;
+    header.typeCount = types.size();
+    header.componentCount = componentTypes.size();
+    header.wireCount = wires.size();
+    header.namesSize = names.size();
+
+    std::FILE* file = std::fopen( filePath.c_str(), "wb" );
+    if ( file == nullptr )
+    {
+        return false;
+    }
+
+    bool result = writeSection( file, &header, sizeof( header ) ) &&
+                  writeSection( file, types.data(), types.size() * sizeof( TypeEntry ) ) &&
+                  writeSection( file, componentTypes.data(), componentTypes.size() * sizeof( uint32_t ) ) &&
+                  writeSection( file, wireOffsets.data(), wireOffsets.size() * sizeof( uint64_t ) ) &&
+                  writeSection( file, wires.data(), wires.size() * sizeof( WireEntry ) ) &&
+                  writeSection( file, names.data(), names.size() );
+
+    return std::fclose( file ) == 0 && result;
+}
+
+bool Netlist::Load( const std::string& filePath, Circuit& circuit ) const
+{
+    using Header = internal::Netlist::Header;
+    using TypeEntry = internal::Netlist::TypeEntry;
+    using WireEntry = internal::Netlist::WireEntry;
+    using Format = internal::Netlist;
+
+    MappedFile file( filePath );
+
+    // check that the file holds every section it claims to
+    // ====================================================
+
+    Header header;
+    if ( file.Size() < sizeof( header ) )
+    {
+        return false;
+    }
+    std::memcpy( &header, file.Data(), sizeof( header ) );
+
+    if ( std::memcmp( header.magic, Format::magic, sizeof( header.magic ) ) != 0 || header.version != Format::version ||
+         header.componentCount >= UINT32_MAX || header.wireCount > file.Size() || header.namesSize > file.Size() )
+    {
+        return false;
+    }
+
+    uint64_t typesOffset = Format::Align( sizeof( Header ) );
+    uint64_t componentTypesOffset = typesOffset + Format::Align( header.typeCount * sizeof( TypeEntry ) );
+    uint64_t wireOffsetsOffset = componentTypesOffset + Format::Align( header.componentCount * sizeof( uint32_t ) );
+    uint64_t wiresOffset = wireOffsetsOffset + ( header.componentCount + 1 ) * sizeof( uint64_t );
+    uint64_t namesOffset = wiresOffset + Format::Align( header.wireCount * sizeof( WireEntry ) );
+
+    if ( namesOffset + header.namesSize > file.Size() )
+    {
+        return false;
+    }
+
+    auto types = reinterpret_cast<TypeEntry const*>( file.Data() + typesOffset );
+    auto componentTypes = reinterpret_cast<uint32_t const*>( file.Data() + componentTypesOffset );
+    auto wireOffsets = reinterpret_cast<uint64_t const*>( file.Data() + wireOffsetsOffset );
+    auto wires = reinterpret_cast<WireEntry const*>( file.Data() + wiresOffset );
+    auto names = file.Data() + namesOffset;
+
+    // find a factory for every type
+    // =============================
+
+    std::vector<::Netlist::Factory const*> factories( header.typeCount, nullptr );
+    uint32_t maxInputCount = 0;
+    for ( uint32_t i = 0; i < header.typeCount; ++i )
+    {
+        auto& type = types[i];
+        maxInputCount = std::max( maxInputCount, type.inputCount );
+
+        if ( type.gateType >= 0 )
+        {
+            if ( type.gateType > (int32_t)Gate::Type::Xnor )
+            {
+                return false;
+            }
+            continue;
+        }
+
+        if ( type.nameOffset > header.namesSize || type.nameSize > header.namesSize - type.nameOffset )
+        {
+            return false;
+        }
+
+        auto factory = p_->factories_.find( std::string( names + type.nameOffset, type.nameSize ) );
+        if ( factory == p_->factories_.end() )
+        {
+            return false;  // not registered
+        }
+        factories[i] = &factory->second;
+    }
+
+    // check every wire connects an existing output to an existing, otherwise unconnected, input
+    // ==========================================================================================
+
+    if ( wireOffsets[0] != 0 || wireOffsets[header.componentCount] != header.wireCount )
+    {
+        return false;
+    }
+
+    std::vector<uint32_t> wiredBy( maxInputCount, UINT32_MAX );  // component last seen wiring each input
+    for ( uint32_t i = 0; i < header.componentCount; ++i )
+    {
+        if ( componentTypes[i] >= header.typeCount || wireOffsets[i] > wireOffsets[i + 1] )
+        {
+            return false;
+        }
+
+        for ( uint64_t w = wireOffsets[i]; w < wireOffsets[i + 1]; ++w )
+        {
+            auto& wire = wires[w];
+            if ( wire.fromComponent >= header.componentCount || wire.toInput >= types[componentTypes[i]].inputCount ||
+                 wire.fromOutput >= types[componentTypes[wire.fromComponent]].outputCount || wiredBy[wire.toInput] == i )
+            {
+                return false;
+            }
+            wiredBy[wire.toInput] = i;
+        }
+    }
+
+    // create the components
+    // =====================
+
+    std::vector<std::shared_ptr<Component>> components( header.componentCount );
+    for ( uint32_t i = 0; i < header.componentCount; ++i )
+    {
+        auto& type = types[componentTypes[i]];
+        components[i] = type.gateType >= 0 ? std::make_shared<Gate>( (Gate::Type)type.gateType ) : ( *factories[componentTypes[i]] )();
+
+        if ( components[i] == nullptr || (uint32_t)components[i]->GetInputCount() != type.inputCount ||
+             (uint32_t)components[i]->GetOutputCount() != type.outputCount )
+        {
+            return false;  // the factory doesn't create what was saved
+        }
+    }
+
+    // add them to the circuit, wired up
+    // =================================
+
+    circuit.PauseAutoTick();
+
+    auto& circuitState = *circuit.p_;
+    int bufferCount = circuitState.circuitThreads_.size();
+
+    for ( auto& component : components )
+    {
+        // as in Circuit::AddComponent()
+        component->SetBufferCount( bufferCount );
+        component->SetLaneCount( circuitState.laneCount_ );
+    }
+
+    for ( uint32_t i = 0; i < header.componentCount; ++i )
+    {
+        // as in Component::ConnectInput(), but knowing the input isn't wired yet
+        auto& toComponent = *components[i]->p_;
+        toComponent.inputWires_.reserve( wireOffsets[i + 1] - wireOffsets[i] );
+
+        for ( uint64_t w = wireOffsets[i]; w < wireOffsets[i + 1]; ++w )
+        {
+            auto& wire = wires[w];
+            auto& fromComponent = components[wire.fromComponent];
+            toComponent.inputWires_.emplace_back( fromComponent, wire.fromOutput, wire.toInput );
+
+            for ( auto& ref : fromComponent->p_->refs_ )
+            {
+                ++ref[wire.fromOutput].first;
+            }
+        }
+    }
+
+    circuitState.components_.reserve( circuitState.components_.size() + components.size() );
+    for ( auto& component : components )
+    {
+        for ( auto& feedbackWires : component->p_->feedbackWires_ )
+        {
+            feedbackWires.reserve( component->p_->inputWires_.size() );
+        }
+        component->p_->ReserveDependents();
+
+        circuitState.components_.emplace_back( std::move( component ) );
+    }
+
+    circuitState.compiled_ = false;
+
+    circuit.ResumeAutoTick();
+
+    return true;
+}
@@ -0,0 +1,72 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Circuit.h"
+
+#include <functional>
+#include <typeinfo>
+
+namespace internal
+{
+    class Netlist;
+}
+
+/**
+ * @brief Compact binary file format for saving and loading whole circuits
+ *
+ * Write() saves a circuit's compiled schedule (see Circuit::Compile()) as a flat
+ * netlist: a table of component types, each component's type, and every wire in
+ * compressed sparse row (CSR) form, i.e. the wires into each component stored
+ * contiguously, indexed by a per-component offset. Sub-circuits are saved
+ * flattened, as the components inside them, and components are saved in the
+ * order they were added, so that a loaded circuit breaks its feedback loops at
+ * the same wires as the original (see Circuit::Compile()).
+ *
+ * Load() maps the file into memory and appends its components to a circuit in a
+ * single pass: components are created in bulk and their wires added straight to
+ * the engine, without searching the circuit for components by pointer or pausing
+ * it per connection, so that a design of millions of gates loads in a fraction of
+ * the time it takes to build it via Circuit::AddComponent() and ConnectOutToIn().
+ *
+ * Built-in gates (see Gate) are always known to Load(). Any other component type
+ * must first be registered with RegisterType(), along with a factory that creates
+ * a component of that type with the same number of inputs and outputs as the one
+ * saved. Components are identified by their C++ type, so a netlist should be
+ * loaded by the same build of a program that wrote it. Load() returns false,
+ * leaving the circuit unchanged, if the file is invalid or holds a component type
+ * that is not registered.
+ */
+
+class Netlist final
+{
+public:
+    NONCOPYABLE( Netlist );
+
+    using Factory = std::function<std::shared_ptr<Component>()>;
+
+    Netlist();
+    ~Netlist();
+
+    template <class ComponentType>
+    void RegisterType()
+    {
+        RegisterType( typeid( ComponentType ), [] { return std::make_shared<ComponentType>(); } );
+    }
+
+    void RegisterType( std::type_info const& type, Factory const& factory );
+
+    static bool Write( Circuit& circuit, const std::string& filePath );
+
+    bool Load( const std::string& filePath, Circuit& circuit ) const;
+
+private:
+    std::unique_ptr<internal::Netlist> p_;
+};
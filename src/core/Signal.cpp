@@ -12,14 +12,12 @@
 #include <iostream>
 
 Signal::Signal()
-{}
+{
+    value_.value = 0;
+}
 
 Signal::~Signal()
 {
-    if (valueHolder_ != nullptr)
-    {
-        delete valueHolder_;
-    }    
 }
 
 bool Signal::HasValue() const
@@ -36,7 +34,7 @@ onebit* Signal::GetValue()
 {
     if (hasValue_)
     {
-        return &(valueHolder_ ->value_);
+        return &value_;
     }
     else 
     {
@@ -46,31 +44,50 @@ onebit* Signal::GetValue()
 
 void Signal::SetValue(const onebit& newValue)
 {
-    if (valueHolder_ == nullptr)
+    value_ = newValue;
+    hasValue_ = true;
+    isWord_ = false;
+}
+
+bool Signal::IsWord() const
+{
+    return hasValue_ && isWord_;
+}
+
+uint64_t const* Signal::GetWord() const
+{
+    static const uint64_t zeroWord = 0;
+    static const uint64_t oneWord = 1;
+
+    if (!hasValue_)
     {
-        valueHolder_ = new ValueHolder( newValue );
+        return nullptr;
     }
-    else 
+    else if (isWord_)
+    {
+        return &word_;
+    }
+    else
     {
-        valueHolder_->value_ = newValue;    
+        return value_.value ? &oneWord : &zeroWord;
     }
-    
+}
+
+void Signal::SetWord(const uint64_t newWord)
+{
+    word_ = newWord;
+    value_.value = newWord & 1;
     hasValue_ = true;
+    isWord_ = true;
 }
 
 bool Signal::CopySignal(const std::shared_ptr<Signal>& fromSignal)
 {
     if (fromSignal != nullptr && fromSignal->hasValue_)
     {
-        if (valueHolder_ != nullptr && fromSignal->valueHolder_ != nullptr)
-        {
-            valueHolder_->SetValue(fromSignal->valueHolder_);
-        }
-        else
-        {
-            delete valueHolder_;
-            valueHolder_ = fromSignal->valueHolder_->GetCopy();
-        }
+        value_ = fromSignal->value_;
+        word_ = fromSignal->word_;
+        isWord_ = fromSignal->isWord_;
 
         hasValue_ = true;
         return true;
@@ -85,7 +102,9 @@ bool Signal::MoveSignal(const std::shared_ptr<Signal>& fromSignal)
 {
     if (fromSignal != nullptr && fromSignal->hasValue_)
     {
-        std::swap(fromSignal->valueHolder_, valueHolder_);
+        value_ = fromSignal->value_;
+        word_ = fromSignal->word_;
+        isWord_ = fromSignal->isWord_;
         fromSignal->hasValue_ = false;
 
         hasValue_ = true;
@@ -95,4 +114,4 @@ bool Signal::MoveSignal(const std::shared_ptr<Signal>& fromSignal)
     {
         return false;
     }
-}
\ No newline at end of file
+}
@@ -10,14 +10,16 @@
 #pragma once
 
 #include "Common.h"
-#include <assert.h>
+
+#include <cstdint>
 #include <memory>
 
 /**
  * @brief Value container used to carry data between components
  *
  * Components process and transfer data between each other in the form of "signals"
- * via interconnected wires. The Signal class holds a onebit value. 
+ * via interconnected wires. The Signal class holds a onebit value, or a word of up
+ * to 64 bits (see SetWord()), whose onebit value is its lowest bit. 
  */
 
 class Signal final
@@ -34,33 +36,17 @@ public:
     onebit* GetValue();
     void SetValue(const onebit& newValue);
 
+    bool IsWord() const;
+    uint64_t const* GetWord() const;
+    void SetWord(const uint64_t newWord);
+
     bool CopySignal(const std::shared_ptr<Signal>& fromSignal);
     bool MoveSignal(const std::shared_ptr<Signal>& fromSignal);
 
 private:
-
-    struct ValueHolder
-    {
-        NONCOPYABLE( ValueHolder );
-
-        ValueHolder(const onebit& value) : value_( value )
-        {
-        }
-
-        ValueHolder* GetCopy() const 
-        {
-            return new ValueHolder( value_ );
-        }
-
-        void SetValue( ValueHolder* valueHolder ) 
-        {
-            assert(valueHolder);
-            value_ = valueHolder->value_;
-        }
-
-        onebit value_;
-    };
-
-    ValueHolder* valueHolder_ = nullptr;
+    // held inline, so that setting, copying and moving values never allocates
+    onebit value_;
+    uint64_t word_ = 0;
     bool hasValue_ = false;
+    bool isWord_ = false;
 };
\ No newline at end of file
@@ -7,30 +7,48 @@
  * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
  */
 
- #include "SignalBus.h"
-#include <memory>
+#include "SignalBus.h"
 
+#include <algorithm>
+#include <cstring>
 
-namespace internal
+namespace
 {
 
-class SignalBus
+const onebit zeroBit = { 0 };
+const onebit oneBit = { 1 };
+
+const uint64_t zeroWord = 0;
+const uint64_t oneWord = 1;
+
+inline int WordIndex( const int signalIndex )
+{
+    return signalIndex >> 6;
+}
+
+inline uint64_t BitMask( const int signalIndex )
 {
-public:
-    std::shared_ptr<Signal> nullSignal = nullptr;
-};
+    return uint64_t( 1 ) << ( signalIndex & 63 );
+}
 
-}  // namespace internal
+}  // namespace
 
 
 SignalBus::SignalBus() 
 {
-    p_ = std::make_unique<internal::SignalBus>();
 }
 
 SignalBus::SignalBus(SignalBus&& rhs)
+    : signalCount_( rhs.signalCount_ )
+    , laneWordCount_( rhs.laneWordCount_ )
+    , values_( std::move( rhs.values_ ) )
+    , hasValues_( std::move( rhs.hasValues_ ) )
+    , lanes_( std::move( rhs.lanes_ ) )
+    , isWords_( std::move( rhs.isWords_ ) )
+    , words_( std::move( rhs.words_ ) )
 {
-    signals_ = rhs.signals_;
+    rhs.signalCount_ = 0;
+    rhs.laneWordCount_ = 0;
 }
 
 SignalBus::~SignalBus()
@@ -39,50 +57,114 @@ SignalBus::~SignalBus()
 
 void SignalBus::SetSignalCount(const int signalCount)
 {
-    int fromSize = signals_.size();
+    int wordCount = ( signalCount + 63 ) / 64;
 
-    signals_.resize(signalCount);
+    // drop the values of any signals removed from the last word
+    if ( signalCount < signalCount_ && ( signalCount & 63 ) != 0 )
+    {
+        auto keepMask = BitMask( signalCount ) - 1;
+        values_[WordIndex( signalCount )] &= keepMask;
+        hasValues_[WordIndex( signalCount )] &= keepMask;
+        if ( !isWords_.empty() )
+        {
+            isWords_[WordIndex( signalCount )] &= keepMask;
+        }
+    }
 
-    for (int i = fromSize; i < signalCount; ++i)
+    values_.resize( wordCount, 0 );
+    hasValues_.resize( wordCount, 0 );
+    lanes_.resize( (size_t)signalCount * laneWordCount_, 0 );
+    if ( !isWords_.empty() )
     {
-        signals_[i] = std::make_shared<Signal>();
+        isWords_.resize( wordCount, 0 );
+        words_.resize( signalCount, 0 );
     }
+
+    signalCount_ = signalCount;
 }
 
 int SignalBus::GetSignalCount() const
 {
-    return signals_.size();
+    return signalCount_;
+}
+
+void SignalBus::SetLaneCount(const int laneCount)
+{
+    // lanes are allocated in whole words
+    laneWordCount_ = laneCount > 0 ? ( laneCount + 63 ) / 64 : 0;
+
+    lanes_.assign( (size_t)signalCount_ * laneWordCount_, 0 );
+}
+
+int SignalBus::GetLaneCount() const
+{
+    return laneWordCount_ * 64;
 }
 
-const std::shared_ptr<Signal>& SignalBus::GetSignal(const int signalIndex) const
+int SignalBus::GetLaneWordCount() const
 {
-    if ( (size_t)signalIndex < signals_.size() )
+    return laneWordCount_;
+}
+
+bool SignalBus::HasValue(const int signalIndex) const
+{
+    if ( (unsigned)signalIndex < (unsigned)signalCount_ )
     {
-        return signals_[signalIndex];
+        return ( hasValues_[WordIndex( signalIndex )] & BitMask( signalIndex ) ) != 0;
     }
     else
     {
-        return p_->nullSignal;
+        return false;
     }    
 }
 
-bool SignalBus::HasValue(const int signalIndex) const
+onebit const* SignalBus::GetValue(const int signalIndex) const
 {
-    if ( (size_t)signalIndex < signals_.size() )
+    if ( HasValue( signalIndex ) )
     {
-        return signals_[signalIndex]->HasValue();
+        return ( values_[WordIndex( signalIndex )] & BitMask( signalIndex ) ) != 0 ? &oneBit : &zeroBit;
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+bool SignalBus::SetValue(const int signalIndex, const onebit& newValue)
+{
+    if ( (unsigned)signalIndex < (unsigned)signalCount_ )
+    {
+        auto& value = values_[WordIndex( signalIndex )];
+        auto mask = BitMask( signalIndex );
+
+        value = newValue.value ? ( value | mask ) : ( value & ~mask );
+        hasValues_[WordIndex( signalIndex )] |= mask;
+        if ( !isWords_.empty() )
+        {
+            isWords_[WordIndex( signalIndex )] &= ~mask;
+        }
+        return true;
     }
     else
     {
         return false;
-    }    
+    }
 }
 
-onebit* SignalBus::GetValue(const int signalIndex) const
+bool SignalBus::IsWord(const int signalIndex) const
 {
-    if ( (size_t)signalIndex < signals_.size() )
+    return HasValue( signalIndex ) && !isWords_.empty() && ( isWords_[WordIndex( signalIndex )] & BitMask( signalIndex ) ) != 0;
+}
+
+uint64_t const* SignalBus::GetWord(const int signalIndex) const
+{
+    if ( IsWord( signalIndex ) )
+    {
+        return &words_[signalIndex];
+    }
+    else if ( HasValue( signalIndex ) )
     {
-        return signals_[signalIndex]->GetValue();
+        return ( values_[WordIndex( signalIndex )] & BitMask( signalIndex ) ) != 0 ? &oneWord : &zeroWord;
     }
     else
     {
@@ -90,11 +172,70 @@ onebit* SignalBus::GetValue(const int signalIndex) const
     }
 }
 
-bool SignalBus::SetValue(const int signalIndex, const onebit& newValue)
+bool SignalBus::SetWord(const int signalIndex, const uint64_t newWord)
+{
+    if ( (unsigned)signalIndex < (unsigned)signalCount_ )
+    {
+        if ( isWords_.empty() )
+        {
+            // the first word set on this bus
+            isWords_.resize( values_.size(), 0 );
+            words_.resize( signalCount_, 0 );
+        }
+
+        auto& value = values_[WordIndex( signalIndex )];
+        auto mask = BitMask( signalIndex );
+
+        value = ( newWord & 1 ) != 0 ? ( value | mask ) : ( value & ~mask );
+        hasValues_[WordIndex( signalIndex )] |= mask;
+        isWords_[WordIndex( signalIndex )] |= mask;
+        words_[signalIndex] = newWord;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}
+
+int SignalBus::GetWordCount() const
+{
+    return values_.size();
+}
+
+uint64_t const* SignalBus::GetValueWords() const
+{
+    return values_.data();
+}
+
+uint64_t const* SignalBus::GetHasValueWords() const
+{
+    return hasValues_.data();
+}
+
+uint64_t const* SignalBus::GetLanes(const int signalIndex) const
 {
-    if ( (size_t)signalIndex < signals_.size() )
+    if ( laneWordCount_ != 0 && HasValue( signalIndex ) )
     {
-        signals_[signalIndex]->SetValue( newValue );
+        return &lanes_[(size_t)signalIndex * laneWordCount_];
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+bool SignalBus::SetLanes(const int signalIndex, uint64_t const* newLanes)
+{
+    if ( laneWordCount_ != 0 && (unsigned)signalIndex < (unsigned)signalCount_ )
+    {
+        std::memcpy( &lanes_[(size_t)signalIndex * laneWordCount_], newLanes, laneWordCount_ * sizeof( uint64_t ) );
+
+        // the signal's onebit value is lane 0's
+        auto& value = values_[WordIndex( signalIndex )];
+        auto mask = BitMask( signalIndex );
+        value = ( newLanes[0] & 1 ) != 0 ? ( value | mask ) : ( value & ~mask );
+        hasValues_[WordIndex( signalIndex )] |= mask;
         return true;
     }
     else
@@ -105,9 +246,13 @@ bool SignalBus::SetValue(const int signalIndex, const onebit& newValue)
 
 bool SignalBus::CopySignal(const int toSignalIndex, const std::shared_ptr<Signal>& fromSignal)
 {
-    if ( (size_t)toSignalIndex < signals_.size() )
+    if ( fromSignal != nullptr && fromSignal->IsWord() )
+    {
+        return SetWord( toSignalIndex, *fromSignal->GetWord() );
+    }
+    else if ( fromSignal != nullptr && fromSignal->HasValue() )
     {
-        return signals_[toSignalIndex]->CopySignal( fromSignal );
+        return SetValue( toSignalIndex, *fromSignal->GetValue() );
     }
     else
     {
@@ -117,9 +262,10 @@ bool SignalBus::CopySignal(const int toSignalIndex, const std::shared_ptr<Signal
 
 bool SignalBus::MoveSignal(const int toSignalIndex, const std::shared_ptr<Signal>& fromSignal)
 {
-    if ( (size_t)toSignalIndex < signals_.size() )
+    if ( CopySignal( toSignalIndex, fromSignal ) )
     {
-        return signals_[toSignalIndex]->MoveSignal( fromSignal );
+        fromSignal->ClearValue();
+        return true;
     }
     else
     {
@@ -127,10 +273,104 @@ bool SignalBus::MoveSignal(const int toSignalIndex, const std::shared_ptr<Signal
     }    
 }
 
-void SignalBus::ClearAllValues()
+bool SignalBus::CopySignal(const int toSignalIndex, SignalBus const& fromBus, const int fromSignalIndex)
+{
+    auto value = fromBus.GetValue( fromSignalIndex );
+
+    if ( value != nullptr )
+    {
+        // in bit-parallel mode, the lanes are the signal value
+        if ( laneWordCount_ != 0 && laneWordCount_ == fromBus.laneWordCount_ )
+        {
+            return SetLanes( toSignalIndex, fromBus.GetLanes( fromSignalIndex ) );
+        }
+        if ( fromBus.IsWord( fromSignalIndex ) )
+        {
+            return SetWord( toSignalIndex, fromBus.words_[fromSignalIndex] );
+        }
+        return SetValue( toSignalIndex, *value );
+    }
+    else
+    {
+        return false;
+    }
+}
+
+bool SignalBus::MoveSignal(const int toSignalIndex, SignalBus& fromBus, const int fromSignalIndex)
 {
-    for ( auto& signal : signals_ )
+    if ( CopySignal( toSignalIndex, fromBus, fromSignalIndex ) )
     {
-        signal->ClearValue();
+        fromBus.ClearValue( fromSignalIndex );
+        return true;
+    }
+    else
+    {
+        return false;
     }
-}
\ No newline at end of file
+}
+
+bool SignalBus::UpdateSignal(const int toSignalIndex, SignalBus const& fromBus, const int fromSignalIndex)
+{
+    // like CopySignal(), but also copies the absence of a value, and returns whether the signal changed
+
+    if ( (unsigned)toSignalIndex >= (unsigned)signalCount_ )
+    {
+        return false;
+    }
+
+    bool hasValue = HasValue( toSignalIndex );
+
+    if ( !fromBus.HasValue( fromSignalIndex ) )
+    {
+        ClearValue( toSignalIndex );
+        return hasValue;
+    }
+
+    if ( laneWordCount_ != 0 && laneWordCount_ == fromBus.laneWordCount_ )
+    {
+        auto toLanes = &lanes_[(size_t)toSignalIndex * laneWordCount_];
+        auto fromLanes = &fromBus.lanes_[(size_t)fromSignalIndex * laneWordCount_];
+
+        if ( hasValue && std::memcmp( toLanes, fromLanes, laneWordCount_ * sizeof( uint64_t ) ) == 0 )
+        {
+            return false;
+        }
+        return SetLanes( toSignalIndex, fromLanes );
+    }
+
+    if ( fromBus.IsWord( fromSignalIndex ) || IsWord( toSignalIndex ) )
+    {
+        auto word = fromBus.GetWord( fromSignalIndex );
+
+        if ( hasValue && IsWord( toSignalIndex ) == fromBus.IsWord( fromSignalIndex ) && *GetWord( toSignalIndex ) == *word )
+        {
+            return false;
+        }
+        return fromBus.IsWord( fromSignalIndex ) ? SetWord( toSignalIndex, *word ) : SetValue( toSignalIndex, *fromBus.GetValue( fromSignalIndex ) );
+    }
+
+    auto value = fromBus.GetValue( fromSignalIndex );
+
+    if ( hasValue && GetValue( toSignalIndex ) == value )
+    {
+        return false;  // GetValue() points to a shared 0 or 1
+    }
+    return SetValue( toSignalIndex, *value );
+}
+
+void SignalBus::ClearValue(const int signalIndex)
+{
+    if ( (unsigned)signalIndex < (unsigned)signalCount_ )
+    {
+        hasValues_[WordIndex( signalIndex )] &= ~BitMask( signalIndex );
+
+        // lanes without a value read as 0 (see internal::Circuit::TickLanes())
+        std::fill_n( lanes_.begin() + (size_t)signalIndex * laneWordCount_, laneWordCount_, 0 );
+    }
+}
+
+void SignalBus::ClearAllValues()
+{
+    std::fill( hasValues_.begin(), hasValues_.end(), 0 );
+    std::fill( lanes_.begin(), lanes_.end(), 0 );
+}
@@ -10,14 +10,15 @@
 #pragma once
 
 #include "Signal.h"
+
+#include <cstdint>
 #include <vector>
 
 namespace internal
 {
-    class SignalBus;
+    class Circuit;
 }
 
-
 /**
  * @brief Signal container
  *
@@ -26,6 +27,30 @@ namespace internal
  * "outputs" SignalBus. The SignalBus class provides public getters and setters for 
  * manipulating it's internal Signal values directly, abstracting the need to retrieve 
  * and interface with the contained Signals themself. 
+ *
+ * Signal values are not stored as individual Signal objects, but packed into machine 
+ * words: one word of value bits and one word of "has value" bits per 64 signals. 
+ * Copying signals between buses is therefore a matter of copying bits, and clearing
+ * a bus is a single store per word.
+ *
+ * For bit-parallel simulation, a bus can additionally carry a number of lanes per 
+ * signal (see SetLaneCount()). Each lane holds the signal's value in one independent
+ * instance of the circuit, with lanes packed 64 to a word. GetLanes() and SetLanes()
+ * access a signal's lane words, while HasValue() applies to all lanes of a signal.
+ * SetLanes() also sets the signal's onebit value (GetValue()) to that of lane 0.
+ * The lanes of a signal without a value read as 0.
+ * GetValueWords() and GetHasValueWords() expose the packed words for reading many
+ * signals at once (a value bit is only meaningful where its "has value" bit is set).
+ *
+ * A signal can also carry a whole word of up to 64 bits (e.g. a byte of a data 
+ * bus), set via SetWord() and read via GetWord(), so that a multi-bit value can 
+ * travel along a single wire. Word values are held in a separate array, only 
+ * allocated once a word is first set on the bus, and are copied along with the 
+ * signal like any other value. A word signal's onebit value (GetValue()) is its 
+ * lowest bit, and GetWord() of a onebit signal returns 0 or 1, so word and bit
+ * signals can be wired to one another (see BitSlice and BitConcat to connect a 
+ * word to individual bits). Words are not carried by the lanes of bit-parallel 
+ * buses.
  */
 
 class SignalBus final
@@ -40,20 +65,47 @@ public:
     void SetSignalCount(const int signalCount);
     int GetSignalCount() const;
 
-    const std::shared_ptr<Signal>& GetSignal(const int signalIndex) const;
-    
+    void SetLaneCount(const int laneCount);
+    int GetLaneCount() const;
+    int GetLaneWordCount() const;
+
     bool HasValue(const int signalIndex) const;
 
-    onebit* GetValue(const int signalIndex) const;
+    int GetWordCount() const;
+    uint64_t const* GetValueWords() const;
+    uint64_t const* GetHasValueWords() const;
+
+    onebit const* GetValue(const int signalIndex) const;
     bool SetValue(const int signalIndex, const onebit& newValue);
 
+    bool IsWord(const int signalIndex) const;
+    uint64_t const* GetWord(const int signalIndex) const;
+    bool SetWord(const int signalIndex, const uint64_t newWord);
+
+    uint64_t const* GetLanes(const int signalIndex) const;
+    bool SetLanes(const int signalIndex, uint64_t const* newLanes);
+
     bool CopySignal(const int toSignalIndex, const std::shared_ptr<Signal>& fromSignal);
     bool MoveSignal(const int toSignalIndex, const std::shared_ptr<Signal>& fromSignal);
 
+    bool CopySignal(const int toSignalIndex, SignalBus const& fromBus, const int fromSignalIndex);
+    bool MoveSignal(const int toSignalIndex, SignalBus& fromBus, const int fromSignalIndex);
+
+    bool UpdateSignal(const int toSignalIndex, SignalBus const& fromBus, const int fromSignalIndex);
+
+    void ClearValue(const int signalIndex);
     void ClearAllValues();
 
 private:
+    friend class internal::Circuit;
+
+    int signalCount_ = 0;
+    int laneWordCount_ = 0;
+
+    std::vector<uint64_t> values_;
+    std::vector<uint64_t> hasValues_;
+    std::vector<uint64_t> lanes_;  // laneWordCount_ words per signal
 
-    std::vector<std::shared_ptr<Signal>> signals_;
-    std::unique_ptr<internal::SignalBus> p_;
-};
\ No newline at end of file
+    std::vector<uint64_t> isWords_;  // a bit per signal, set if it holds a word (empty until a word is set)
+    std::vector<uint64_t> words_;    // a word per signal (empty until a word is set)
+};
@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "SubCircuit.h"
+
+#include "internal/Component.h"
+#include "internal/SubCircuit.h"
+
+#include <unordered_map>
+
+SubCircuit::SubCircuit( const std::vector<std::string>& inputNames, const std::vector<std::string>& outputNames )
+    : p_( new internal::SubCircuit() )
+{
+    SetInputCount( inputNames.size(), inputNames );
+    SetOutputCount( outputNames.size(), outputNames );
+
+    p_->inputs_ = std::make_shared<internal::SubCircuitInputs>( this, inputNames.size() );
+    p_->outputs_ = std::make_shared<internal::SubCircuitOutputs>( outputNames.size() );
+}
+
+SubCircuit::~SubCircuit()
+{
+    // break any shared_ptr cycles formed by wires between inner components
+    for ( auto& component : p_->components_ )
+    {
+        component->DisconnectAllInputs();
+    }
+    p_->outputs_->DisconnectAllInputs();
+}
+
+int SubCircuit::FindInput( const std::string& inputName ) const
+{
+    for ( int i = 0; i < GetInputCount(); ++i )
+    {
+        if ( GetInputName( i ) == inputName )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SubCircuit::FindOutput( const std::string& outputName ) const
+{
+    for ( int i = 0; i < GetOutputCount(); ++i )
+    {
+        if ( GetOutputName( i ) == outputName )
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int SubCircuit::AddComponent( const std::shared_ptr<Component>& component )
+{
+    int componentIndex;
+
+    if ( component == nullptr )
+    {
+        return -1;
+    }
+
+    if ( p_->FindComponent( component, componentIndex ) )
+    {
+        return componentIndex;  // if the component is already in the array
+    }
+
+    p_->components_.emplace_back( component );
+    p_->templateValid_ = false;
+
+    return p_->components_.size() - 1;
+}
+
+int SubCircuit::GetComponentCount() const
+{
+    return p_->components_.size();
+}
+
+bool SubCircuit::ConnectOutToIn( const std::shared_ptr<Component const>& fromComponent, int fromOutput, const std::shared_ptr<Component const>& toComponent, int toInput )
+{
+    int toComponentIndex;
+    int fromComponentIndex;
+    if ( p_->FindComponent( fromComponent, fromComponentIndex ) && p_->FindComponent( toComponent, toComponentIndex ) )
+    {
+        return ConnectOutToIn( fromComponentIndex, fromOutput, toComponentIndex, toInput );
+    }
+
+    return false;
+}
+
+bool SubCircuit::ConnectOutToIn( int fromComponent, int fromOutput, int toComponent, int toInput )
+{
+    if ( (size_t)fromComponent >= p_->components_.size() || (size_t)toComponent >= p_->components_.size() )
+    {
+        return false;
+    }
+
+    p_->templateValid_ = false;
+
+    return p_->components_[toComponent]->ConnectInput( p_->components_[fromComponent], fromOutput, toInput );
+}
+
+bool SubCircuit::ConnectInToIn( int fromInput, const std::shared_ptr<Component const>& toComponent, int toInput )
+{
+    int toComponentIndex;
+    if ( (unsigned)fromInput >= (unsigned)GetInputCount() || !p_->FindComponent( toComponent, toComponentIndex ) )
+    {
+        return false;
+    }
+
+    p_->templateValid_ = false;
+
+    return p_->components_[toComponentIndex]->ConnectInput( p_->inputs_, fromInput, toInput );
+}
+
+bool SubCircuit::ConnectInToIn( const std::string& fromInput, const std::shared_ptr<Component const>& toComponent, int toInput )
+{
+    return ConnectInToIn( FindInput( fromInput ), toComponent, toInput );
+}
+
+bool SubCircuit::ConnectOutToOut( const std::shared_ptr<Component const>& fromComponent, int fromOutput, int toOutput )
+{
+    int fromComponentIndex;
+    if ( (unsigned)toOutput >= (unsigned)GetOutputCount() || !p_->FindComponent( fromComponent, fromComponentIndex ) )
+    {
+        return false;
+    }
+
+    p_->templateValid_ = false;
+
+    return p_->outputs_->ConnectInput( p_->components_[fromComponentIndex], fromOutput, toOutput );
+}
+
+bool SubCircuit::ConnectOutToOut( const std::shared_ptr<Component const>& fromComponent, int fromOutput, const std::string& toOutput )
+{
+    return ConnectOutToOut( fromComponent, fromOutput, FindOutput( toOutput ) );
+}
+
+std::shared_ptr<SubCircuit> SubCircuit::Instantiate() const
+{
+    if ( !p_->templateValid_ )
+    {
+        BuildTemplate();
+    }
+
+    std::vector<std::string> inputNames, outputNames;
+    for ( int i = 0; i < GetInputCount(); ++i )
+    {
+        inputNames.emplace_back( GetInputName( i ) );
+    }
+    for ( int i = 0; i < GetOutputCount(); ++i )
+    {
+        outputNames.emplace_back( GetOutputName( i ) );
+    }
+
+    auto instance = std::make_shared<SubCircuit>( inputNames, outputNames );
+
+    auto& components = instance->p_->components_;
+    components.reserve( p_->components_.size() );
+    for ( auto& component : p_->components_ )
+    {
+        auto clone = component->Clone();
+        if ( !clone )
+        {
+            return nullptr;  // this component type can't be copied
+        }
+        components.emplace_back( std::move( clone ) );
+    }
+
+    // wire up the clones by index
+    for ( auto& wire : p_->template_ )
+    {
+        Component* toComponent = wire.toComponent < 0 ? instance->p_->outputs_.get() : components[wire.toComponent].get();
+        if ( wire.fromComponent < 0 )
+        {
+            toComponent->ConnectInput( instance->p_->inputs_, wire.fromOutput, wire.toInput );
+        }
+        else
+        {
+            toComponent->ConnectInput( components[wire.fromComponent], wire.fromOutput, wire.toInput );
+        }
+    }
+
+    // the instance has the same wiring, so can share our template
+    instance->p_->template_ = p_->template_;
+    instance->p_->templateValid_ = true;
+
+    return instance;
+}
+
+std::shared_ptr<Component> SubCircuit::Clone() const
+{
+    return Instantiate();
+}
+
+void SubCircuit::CallProcess( int bufferNo )
+{
+    // note the buffer for Process(), which is only handed its buses
+    p_->bufferNo_ = bufferNo;
+    Component::CallProcess( bufferNo );
+}
+
+void SubCircuit::Process( SignalBus const& inputs, SignalBus& outputs )
+{
+    // This sub-circuit was not flattened into a compiled schedule, so tick the inner components
+    // here, on the buffer currently being processed. As a sub-circuit processes in order, its
+    // buffers are processed one at a time, in turn, just as its inner components expect.
+
+    int bufferNo = p_->bufferNo_;
+
+    SyncComponents();
+
+    p_->inputs_->bus_ = &inputs;
+    p_->outputs_->bus_ = &outputs;
+
+    for ( auto& component : p_->components_ )
+    {
+        component->Tick( TickMode::Series, bufferNo );
+    }
+    p_->outputs_->Tick( TickMode::Series, bufferNo );
+
+    for ( auto& component : p_->components_ )
+    {
+        component->Reset( bufferNo );
+    }
+    p_->inputs_->Reset( bufferNo );
+    p_->outputs_->Reset( bufferNo );
+}
+
+void SubCircuit::ProcessLanes( SignalBus const& inputs, SignalBus& outputs )
+{
+    // inner components process their own lanes
+    Process( inputs, outputs );
+}
+
+void SubCircuit::SyncComponents()
+{
+    int bufferCount = GetBufferCount();
+    int laneCount = GetLaneCount();
+
+    auto sync = [bufferCount, laneCount]( Component& component ) {
+        if ( component.GetBufferCount() != bufferCount )
+        {
+            component.SetBufferCount( bufferCount );
+        }
+        if ( component.GetLaneCount() != laneCount )
+        {
+            component.SetLaneCount( laneCount );
+        }
+    };
+
+    for ( auto& component : p_->components_ )
+    {
+        sync( *component );
+    }
+    sync( *p_->inputs_ );
+    sync( *p_->outputs_ );
+}
+
+void SubCircuit::BuildTemplate() const
+{
+    std::unordered_map<Component const*, int> indices;
+    for ( size_t i = 0; i < p_->components_.size(); ++i )
+    {
+        indices[p_->components_[i].get()] = i;
+    }
+    indices[p_->inputs_.get()] = -1;
+
+    auto addWires = [this, &indices]( Component const& toComponent, int toIndex ) {
+        for ( auto& wire : toComponent.Component::p_->inputWires_ )
+        {
+            auto from = indices.find( wire.fromComponent_.get() );
+            if ( from != indices.end() )  // wires from outside the sub-circuit aren't copied
+            {
+                p_->template_.push_back( { from->second, wire.fromOutput_, toIndex, wire.toInput_ } );
+            }
+        }
+    };
+
+    p_->template_.clear();
+    for ( size_t i = 0; i < p_->components_.size(); ++i )
+    {
+        addWires( *p_->components_[i], i );
+    }
+    addWires( *p_->outputs_, -1 );
+
+    p_->templateValid_ = true;
+}
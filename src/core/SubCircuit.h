@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Component.h"
+
+namespace internal
+{
+    class SubCircuit;
+}
+
+/**
+ * @brief Circuit of components exposed as a single component with named ports
+ *
+ * A SubCircuit is built much like a Circuit: components are added via
+ * AddComponent() and routed to one another via ConnectOutToIn(). In addition,
+ * each of the sub-circuit's named inputs can be routed to any number of inner
+ * component inputs via ConnectInToIn(), and each of its named outputs driven by
+ * an inner component output via ConnectOutToOut(). The sub-circuit itself can then
+ * be added to a Circuit (or to another SubCircuit) and routed like any other
+ * component.
+ *
+ * When a circuit is compiled (see Circuit::Compile()), its sub-circuits are
+ * flattened: every wire through a sub-circuit port is resolved to the inner (or
+ * outer) component that actually drives it, and the inner components are
+ * scheduled alongside the circuit's own. A sub-circuit therefore adds no work to
+ * compiled ticks. When ticked by itself (outside of a circuit), a sub-circuit
+ * instead ticks its inner components itself from Process().
+ * Inner components always follow the sub-circuit's buffer and lane count.
+ *
+ * Instantiate() stamps out an unconnected copy of the sub-circuit, cloning each
+ * inner component via Component::Clone() and re-creating its wiring from a cached
+ * template, without searching for components by pointer. A sub-circuit should be
+ * completely built before it is added to a circuit, as changes to it do not
+ * invalidate the circuit's compiled schedule (call Circuit::Compile() to
+ * recompile).
+ */
+
+class SubCircuit final : public Component
+{
+public:
+    NONCOPYABLE( SubCircuit );
+
+    SubCircuit( const std::vector<std::string>& inputNames, const std::vector<std::string>& outputNames );
+    ~SubCircuit();
+
+    int FindInput( const std::string& inputName ) const;
+    int FindOutput( const std::string& outputName ) const;
+
+    int AddComponent( const std::shared_ptr<Component>& component );
+
+    int GetComponentCount() const;
+
+    bool ConnectOutToIn( const std::shared_ptr<Component const>& fromComponent, int fromOutput, const std::shared_ptr<Component const>& toComponent, int toInput );
+    bool ConnectOutToIn( int fromComponent, int fromOutput, int toComponent, int toInput );
+
+    bool ConnectInToIn( int fromInput, const std::shared_ptr<Component const>& toComponent, int toInput );
+    bool ConnectInToIn( const std::string& fromInput, const std::shared_ptr<Component const>& toComponent, int toInput );
+
+    bool ConnectOutToOut( const std::shared_ptr<Component const>& fromComponent, int fromOutput, int toOutput );
+    bool ConnectOutToOut( const std::shared_ptr<Component const>& fromComponent, int fromOutput, const std::string& toOutput );
+
+    std::shared_ptr<SubCircuit> Instantiate() const;
+
+    virtual std::shared_ptr<Component> Clone() const override;
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override;
+    virtual void ProcessLanes( SignalBus const& inputs, SignalBus& outputs ) override;
+
+private:
+    friend class internal::Circuit;
+
+    virtual void CallProcess( int bufferNo ) override;
+
+    void SyncComponents();
+    void BuildTemplate() const;
+
+    std::unique_ptr<internal::SubCircuit> p_;
+};
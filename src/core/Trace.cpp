@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "Trace.h"
+
+#include "internal/Trace.h"
+
+#include <fstream>
+
+bool Trace::IsAvailable()
+{
+#ifdef SCOTTCPU_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Trace::Start( int eventsPerThread )
+{
+    if ( IsAvailable() )
+    {
+        internal::Trace::Get().Start( eventsPerThread );
+    }
+}
+
+void Trace::Stop()
+{
+    internal::Trace::Get().Stop();
+}
+
+bool Trace::IsRecording()
+{
+    return internal::Trace::Get().IsRecording();
+}
+
+void Trace::Write( std::ostream& out )
+{
+    internal::Trace::Get().Write( out );
+}
+
+bool Trace::Write( const std::string& filePath )
+{
+    std::ofstream out( filePath );
+    if ( !out )
+    {
+        return false;
+    }
+
+    Write( out );
+
+    return static_cast<bool>( out );
+}
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Common.h"
+
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Process-wide recording of tick phases, for viewing in Perfetto
+ *
+ * When built with SCOTTCPU_TRACE defined (see the SCOTTCPU_TRACE CMake option),
+ * calling Start() records begin and end events for every Circuit tick (per 
+ * buffer), every component Process() call, every wait for an in-order turn to 
+ * process ("ReleaseWait"), and every wait for a circuit thread or parallel tick 
+ * to finish ("SyncWait"), on whichever thread they occur. Built-in gates 
+ * evaluated straight from a compiled schedule are not traced.
+ *
+ * Each thread records into its own lock-free ring buffer of eventsPerThread 
+ * events, keeping only the most recent events once full. Write() outputs all 
+ * recorded events as Chrome trace-event JSON, which can be opened in Perfetto 
+ * (ui.perfetto.dev) or chrome://tracing to see, for example, how the ticks of 
+ * different buffers overlap, and where they wait on one another.
+ *
+ * Start() and Write() should only be called while no circuit is ticking.
+ * Without SCOTTCPU_TRACE, nothing is recorded and Write() outputs an empty trace.
+ */
+
+class Trace final
+{
+public:
+    NONCOPYABLE( Trace );
+
+    static bool IsAvailable();
+
+    static void Start( int eventsPerThread = 1 << 16 );
+    static void Stop();
+    static bool IsRecording();
+
+    static void Write( std::ostream& out );
+    static bool Write( const std::string& filePath );
+
+private:
+    Trace() = delete;
+};
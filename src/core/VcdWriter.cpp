@@ -0,0 +1,392 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "VcdWriter.h"
+
+#include "internal/VcdWriter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+namespace
+{
+
+// the writer thread writes to file once it has formatted this much text
+constexpr size_t writeBlockSize = 1 << 20;
+
+std::vector<std::string> splitScopes( const std::string& name )
+{
+    std::vector<std::string> parts;
+    size_t begin = 0;
+    for ( size_t dot = name.find( '.' ); dot != std::string::npos; dot = name.find( '.', begin ) )
+    {
+        parts.emplace_back( name.substr( begin, dot - begin ) );
+        begin = dot + 1;
+    }
+    parts.emplace_back( name.substr( begin ) );
+    return parts;
+}
+
+}  // namespace
+
+VcdWriter::VcdWriter( int bufferedChanges )
+    : p_( new internal::VcdWriter( bufferedChanges ) )
+{
+}
+
+VcdWriter::~VcdWriter()
+{
+    Close();
+}
+
+int VcdWriter::AddSignal( const std::string& name )
+{
+    if ( IsOpen() )
+    {
+        return -1;  // the header has already been written
+    }
+
+    std::vector<std::string> names;
+    for ( int i = 0; i < GetInputCount(); ++i )
+    {
+        names.emplace_back( GetInputName( i ) );
+    }
+    names.emplace_back( name );
+
+    SetInputCount( names.size(), names );
+
+    return names.size() - 1;
+}
+
+bool VcdWriter::Open( const std::string& filePath )
+{
+    Close();
+
+    p_->file_ = std::fopen( filePath.c_str(), "wb" );
+    if ( p_->file_ == nullptr )
+    {
+        return false;
+    }
+
+    int signalCount = GetInputCount();
+
+    auto& identifiers = p_->identifiers_;
+    identifiers.clear();
+    for ( int i = 0; i < signalCount; ++i )
+    {
+        identifiers.emplace_back( internal::VcdWriter::Identifier( i ) );
+    }
+
+    // list signals by name, so that signals of the same scope are declared together
+    std::vector<int> order( signalCount );
+    std::iota( order.begin(), order.end(), 0 );
+    std::stable_sort( order.begin(), order.end(), [this]( int a, int b ) { return GetInputName( a ) < GetInputName( b ); } );
+
+    auto& text = p_->text_;
+    text = "$version scottcpu $end\n$timescale 1ns $end\n$scope module circuit $end\n";
+
+    std::vector<std::string> scopes;
+    for ( int i : order )
+    {
+        auto parts = splitScopes( GetInputName( i ) );
+        auto signalName = parts.back();
+        parts.pop_back();
+
+        // leave scopes this signal is not in, then enter the ones it is
+        size_t common = 0;
+        while ( common < scopes.size() && common < parts.size() && scopes[common] == parts[common] )
+        {
+            ++common;
+        }
+        for ( ; scopes.size() > common; scopes.pop_back() )
+        {
+            text += "$upscope $end\n";
+        }
+        for ( ; scopes.size() < parts.size(); scopes.emplace_back( parts[scopes.size()] ) )
+        {
+            text += "$scope module " + parts[scopes.size()] + " $end\n";
+        }
+
+        text += "$var wire 1 " + identifiers[i] + " " +
+                ( signalName.empty() ? "signal" + std::to_string( i ) : signalName ) + " $end\n";
+    }
+    for ( ; !scopes.empty(); scopes.pop_back() )
+    {
+        text += "$upscope $end\n";
+    }
+    text += "$upscope $end\n$enddefinitions $end\n$dumpvars\n";
+    for ( int i = 0; i < signalCount; ++i )
+    {
+        text += "x" + identifiers[i] + "\n";
+    }
+    text += "$end\n";
+
+    p_->WriteText();
+
+    // every signal starts out unknown, so the first tick records all signals with a value
+    int wordCount = ( signalCount + 63 ) / 64;
+    p_->lastValues_.assign( wordCount, 0 );
+    p_->lastHasValues_.assign( wordCount, 0 );
+    p_->laneValues_.assign( wordCount, 0 );
+    p_->tickCount_ = 0;
+    p_->lastStepTick_ = 0;
+    p_->time_ = 0;
+    p_->stop_ = false;
+
+    p_->thread_ = std::thread( &internal::VcdWriter::Run, p_.get() );
+
+    return true;
+}
+
+bool VcdWriter::IsOpen() const
+{
+    return p_->file_ != nullptr;
+}
+
+void VcdWriter::Flush()
+{
+    if ( !IsOpen() )
+    {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock( p_->mutex_ );
+
+    auto flushRequest = ++p_->flushRequests_;
+    p_->wakeCondt_.notify_one();
+    p_->flushedCondt_.wait( lock, [this, flushRequest] { return p_->flushes_ >= flushRequest; } );
+}
+
+void VcdWriter::Close()
+{
+    if ( !IsOpen() )
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock( p_->mutex_ );
+        p_->stop_ = true;
+    }
+    p_->wakeCondt_.notify_one();
+    p_->thread_.join();
+
+    std::fclose( p_->file_ );
+    p_->file_ = nullptr;
+}
+
+int64_t VcdWriter::GetTickCount() const
+{
+    return p_->tickCount_;
+}
+
+void VcdWriter::Process( SignalBus const& inputs, SignalBus& )
+{
+    if ( IsOpen() )
+    {
+        p_->Record( inputs.GetValueWords(), inputs.GetHasValueWords(), inputs.GetSignalCount() );
+    }
+}
+
+void VcdWriter::ProcessLanes( SignalBus const& inputs, SignalBus& )
+{
+    if ( !IsOpen() )
+    {
+        return;
+    }
+
+    // record lane 0 of each signal
+    auto& values = p_->laneValues_;
+    std::fill( values.begin(), values.end(), 0 );
+    for ( int i = 0; i < inputs.GetSignalCount(); ++i )
+    {
+        auto lanes = inputs.GetLanes( i );
+        if ( lanes != nullptr && ( lanes[0] & 1 ) )
+        {
+            values[i / 64] |= uint64_t( 1 ) << ( i % 64 );
+        }
+    }
+
+    p_->Record( values.data(), inputs.GetHasValueWords(), inputs.GetSignalCount() );
+}
+
+internal::VcdWriter::VcdWriter( int bufferedChanges )
+{
+    // round up to a power of 2
+    size_t capacity = 1;
+    while ( capacity < (size_t)bufferedChanges )
+    {
+        capacity *= 2;
+    }
+    ring_.resize( capacity );
+
+    text_.reserve( writeBlockSize * 2 );
+}
+
+void internal::VcdWriter::Record( uint64_t const* values, uint64_t const* hasValues, int signalCount )
+{
+    bool stepped = false;
+
+    for ( int w = 0; w * 64 < signalCount; ++w )
+    {
+        uint64_t has = hasValues[w];
+        uint64_t value = values[w] & has;
+
+        if ( signalCount - w * 64 < 64 )
+        {
+            // ignore bits beyond the last signal
+            uint64_t mask = ( uint64_t( 1 ) << ( signalCount - w * 64 ) ) - 1;
+            has &= mask;
+            value &= mask;
+        }
+
+        uint64_t changed = ( value ^ lastValues_[w] ) | ( has ^ lastHasValues_[w] );
+
+        for ( ; changed != 0; changed &= changed - 1 )
+        {
+            if ( !stepped )
+            {
+                // advance time to this tick before its first change
+                for ( int64_t ticks = tickCount_ - lastStepTick_; ; ticks -= maxPayload )
+                {
+                    Push( ( (uint32_t)std::min<int64_t>( ticks, maxPayload ) << 2 ) | TimeStep );
+                    if ( ticks <= maxPayload )
+                    {
+                        break;
+                    }
+                }
+                lastStepTick_ = tickCount_;
+                stepped = true;
+            }
+
+            int bit = __builtin_ctzll( changed );
+            uint32_t code = ( ( has >> bit ) & 1 ) ? (uint32_t)( ( value >> bit ) & 1 ) : Unknown;
+            Push( ( (uint32_t)( w * 64 + bit ) << 2 ) | code );
+        }
+
+        lastValues_[w] = value;
+        lastHasValues_[w] = has;
+    }
+
+    ++tickCount_;
+}
+
+void internal::VcdWriter::Push( uint32_t change )
+{
+    auto pushed = pushed_.load( std::memory_order_relaxed );
+
+    // wait for room if the writer thread has fallen a whole ring behind
+    while ( pushed - popped_.load( std::memory_order_acquire ) == ring_.size() )
+    {
+        wakeCondt_.notify_one();
+        std::this_thread::yield();
+    }
+
+    ring_[pushed & ( ring_.size() - 1 )] = change;
+    pushed_.store( pushed + 1, std::memory_order_release );
+
+    // wake the writer thread early once the ring is half full
+    if ( pushed + 1 - popped_.load( std::memory_order_relaxed ) == ring_.size() / 2 )
+    {
+        wakeCondt_.notify_one();
+    }
+}
+
+void internal::VcdWriter::Run()
+{
+    std::unique_lock<std::mutex> lock( mutex_ );
+
+    for ( ;; )
+    {
+        // wake up regularly anyway, so that changes never wait long to be written
+        wakeCondt_.wait_for( lock, std::chrono::milliseconds( 10 ), [this] {
+            return stop_ || flushRequests_ != flushes_ || pushed_ - popped_ >= ring_.size() / 2;
+        } );
+
+        bool stop = stop_;
+        auto flushRequests = flushRequests_;
+
+        lock.unlock();
+
+        Drain();
+
+        if ( text_.size() >= writeBlockSize || stop || flushRequests != flushes_ )
+        {
+            WriteText();
+            std::fflush( file_ );
+        }
+
+        lock.lock();
+
+        if ( flushRequests != flushes_ )
+        {
+            flushes_ = flushRequests;
+            flushedCondt_.notify_all();
+        }
+
+        if ( stop )
+        {
+            return;
+        }
+    }
+}
+
+void internal::VcdWriter::Drain()
+{
+    auto pushed = pushed_.load( std::memory_order_acquire );
+    auto popped = popped_.load( std::memory_order_relaxed );
+
+    for ( ; popped != pushed; ++popped )
+    {
+        uint32_t change = ring_[popped & ( ring_.size() - 1 )];
+        uint32_t code = change & 3;
+        uint32_t payload = change >> 2;
+
+        if ( code == TimeStep )
+        {
+            time_ += payload;
+            text_ += '#';
+            text_ += std::to_string( time_ );
+        }
+        else
+        {
+            text_ += "01x"[code];
+            text_ += identifiers_[payload];
+        }
+        text_ += '\n';
+
+        if ( text_.size() >= writeBlockSize )
+        {
+            // hand room back to the ticking thread before writing a block
+            popped_.store( popped + 1, std::memory_order_release );
+            WriteText();
+        }
+    }
+
+    popped_.store( popped, std::memory_order_release );
+}
+
+void internal::VcdWriter::WriteText()
+{
+    std::fwrite( text_.data(), 1, text_.size(), file_ );
+    text_.clear();
+}
+
+std::string internal::VcdWriter::Identifier( int signalIndex )
+{
+    // base 94, using the printable characters '!' to '~'
+    std::string identifier;
+    do
+    {
+        identifier += (char)( '!' + signalIndex % 94 );
+        signalIndex /= 94;
+    } while ( signalIndex != 0 );
+    return identifier;
+}
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Component.h"
+
+namespace internal
+{
+    class VcdWriter;
+}
+
+/**
+ * @brief Component that records its inputs to a VCD (Value Change Dump) file
+ *
+ * A VcdWriter is added to a circuit like any other component. Each call to
+ * AddSignal() adds a named input, which is then wired to the component output to
+ * record via Circuit::ConnectOutToIn(). Names may contain '.'-separated scopes
+ * (e.g. "alu.carry"), which become nested modules in the waveform viewer. Signals
+ * must be added before Open() is called, as Open() writes the file's header.
+ *
+ * Every tick of the VcdWriter is one step of simulation time (1ns). Each tick, its
+ * inputs are compared against the previous tick's, 64 signals at a time, and only
+ * the changes are queued in a ring buffer of bufferedChanges entries. A background
+ * thread formats queued changes and writes them to the file in large blocks, so
+ * that the tick itself does no I/O. Should the ring fill up faster than the file
+ * can be written, the tick waits for room. Flush() waits until all changes so far
+ * are written, and Close() (or destruction) flushes and closes the file.
+ *
+ * An input without a value is recorded as 'x'. In bit-parallel mode, lane 0 is
+ * recorded. In TickMode::EventDriven, a VcdWriter is processed every tick, like
+ * a component without inputs, so that simulation time follows the circuit's.
+ */
+
+class VcdWriter final : public Component
+{
+public:
+    NONCOPYABLE( VcdWriter );
+
+    VcdWriter( int bufferedChanges = 1 << 20 );
+    ~VcdWriter();
+
+    int AddSignal( const std::string& name );
+
+    bool Open( const std::string& filePath );
+    bool IsOpen() const;
+    void Flush();
+    void Close();
+
+    int64_t GetTickCount() const;
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override;
+    virtual void ProcessLanes( SignalBus const& inputs, SignalBus& outputs ) override;
+
+private:
+    std::unique_ptr<internal::VcdWriter> p_;
+};
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "WordAdapters.h"
+
+#include <algorithm>
+
+namespace
+{
+
+std::vector<std::string> bitNames( int width )
+{
+    std::vector<std::string> names;
+    names.reserve( width );
+    for ( int i = 0; i < width; ++i )
+    {
+        names.emplace_back( "bit" + std::to_string( i ) );
+    }
+    return names;
+}
+
+}  // namespace
+
+BitSlice::BitSlice( int width, int offset )
+    : Component( ProcessOrder::OutOfOrder )
+    , width_( std::max( 1, std::min( width, 64 ) ) )
+    , offset_( std::max( 0, std::min( offset, 64 - width_ ) ) )
+{
+    SetInputCount( 1, { "word" } );
+    SetOutputCount( width_, bitNames( width_ ) );
+}
+
+int BitSlice::GetWidth() const
+{
+    return width_;
+}
+
+int BitSlice::GetOffset() const
+{
+    return offset_;
+}
+
+std::shared_ptr<Component> BitSlice::Clone() const
+{
+    return std::make_shared<BitSlice>( width_, offset_ );
+}
+
+void BitSlice::Process( SignalBus const& inputs, SignalBus& outputs )
+{
+    auto word = inputs.GetWord( 0 );
+    if ( word == nullptr )
+    {
+        return;
+    }
+
+    for ( int i = 0; i < width_; ++i )
+    {
+        onebit bit;
+        bit.value = ( *word >> ( offset_ + i ) ) & 1;
+        outputs.SetValue( i, bit );
+    }
+}
+
+BitConcat::BitConcat( int width )
+    : Component( ProcessOrder::OutOfOrder )
+    , width_( std::max( 1, std::min( width, 64 ) ) )
+{
+    SetInputCount( width_, bitNames( width_ ) );
+    SetOutputCount( 1, { "word" } );
+}
+
+int BitConcat::GetWidth() const
+{
+    return width_;
+}
+
+std::shared_ptr<Component> BitConcat::Clone() const
+{
+    return std::make_shared<BitConcat>( width_ );
+}
+
+void BitConcat::Process( SignalBus const& inputs, SignalBus& outputs )
+{
+    uint64_t word = 0;
+    bool hasValue = false;
+
+    for ( int i = 0; i < width_; ++i )
+    {
+        if ( auto bit = inputs.GetValue( i ) )
+        {
+            word |= (uint64_t)bit->value << i;
+            hasValue = true;
+        }
+    }
+
+    if ( hasValue )
+    {
+        outputs.SetWord( 0, word );
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "Component.h"
+
+/**
+ * @brief Splits a word signal into onebit signals
+ *
+ * A BitSlice has 1 input, "word", and width outputs, "bit0" to "bit<width - 1>",
+ * where output i carries bit offset + i of the input word (see 
+ * SignalBus::SetWord()). A onebit input reads as the word 0 or 1. While the input
+ * has no value, neither do the outputs. width and offset are clamped so that the 
+ * slice lies within 64 bits.
+ */
+
+class BitSlice final : public Component
+{
+public:
+    explicit BitSlice( int width, int offset = 0 );
+
+    int GetWidth() const;
+    int GetOffset() const;
+
+    virtual std::shared_ptr<Component> Clone() const override;
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override;
+
+private:
+    const int width_;
+    const int offset_;
+};
+
+/**
+ * @brief Joins onebit signals into a word signal
+ *
+ * A BitConcat has width inputs, "bit0" to "bit<width - 1>", and 1 output, "word",
+ * whose bit i is the value of input i (the lowest bit of a word input). Inputs 
+ * without a value read as 0, and the output has a value as long as any input 
+ * does. width is clamped to between 1 and 64.
+ */
+
+class BitConcat final : public Component
+{
+public:
+    explicit BitConcat( int width );
+
+    int GetWidth() const;
+
+    virtual std::shared_ptr<Component> Clone() const override;
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override;
+
+private:
+    const int width_;
+};
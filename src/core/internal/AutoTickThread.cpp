@@ -11,6 +11,10 @@
 
 #include "../Circuit.h"
 
+#ifdef SCOTTCPU_TRACE
+#include "Trace.h"
+#endif
+
 #include <thread>
 
 using namespace internal;
@@ -99,6 +103,10 @@ void AutoTickThread::Resume()
 
 void AutoTickThread::Run()
 {
+#ifdef SCOTTCPU_TRACE
+    Trace::Get().SetThreadName("AutoTickThread");
+#endif
+
     if (circuit_ != nullptr)
     {
         while (!stop_)
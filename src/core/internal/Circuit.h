@@ -0,0 +1,326 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../Circuit.h"
+#include "AutoTickThread.h"
+#include "CircuitThread.h"
+#include "LaneKernels.h"
+#include "NativeCode.h"
+#include "SyncFlag.h"
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace internal
+{
+
+/**
+ * @brief Private state of a Circuit
+ *
+ * internal::Circuit holds a circuit's components, threads and compiled schedule.
+ * Its Tick() method ticks all components once for a single buffer, and is called
+ * either directly from ::Circuit::Tick() or from each CircuitThread. 
+ * ::Circuit::Tick(), TickN() and RunUntil() all compile the circuit if needed via
+ * PrepareTick(), then dispatch ticks to Tick() or the CircuitThreads via 
+ * TickNext().
+ *
+ * Sub-circuits (see ::SubCircuit) are flattened by Compile(): only the components
+ * inside them are scheduled, and every wire is resolved through any sub-circuit 
+ * ports it passes (ResolveOutput()) to the component output that actually drives
+ * it. The resolved wires of each scheduled component are kept in inputs_, and are
+ * what the compiled tick modes read from, rather than the components' own wires.
+ */
+
+class Circuit
+{
+public:
+    struct Input
+    {
+        ::Component* fromComponent;
+        int fromOutput;
+        int toInput;
+    };
+
+    struct FanOut
+    {
+        int toIndex;  // schedule_ index of the receiving component
+        int fromOutput;
+        int toInput;
+    };
+
+    struct GateOp
+    {
+        int type;  // ::Gate::Type, or -1 if the component is not a built-in gate
+        Component* in0;
+        int in0Output;
+        Component* in1;
+        int in1Output;
+        int lut;   // luts_ index if the gate is the root of a LUT, or -1
+    };
+
+    struct Lut
+    {
+        ::Component* root;
+        std::vector<std::pair<Component*, int>> leaves;  // component:output, from the lowest index bit up
+        uint64_t table[4];                               // output bit per leaf bits (2^maxLutInputCount bits)
+    };
+
+    struct NativeRun
+    {
+        size_t end;  // schedule_ index after the run's last gate
+        NativeCode::Function function;
+    };
+
+    struct LaneBatch
+    {
+        int level;
+        LaneOp op;
+        std::vector<LaneGate> gates;
+        std::vector<::SignalBus*> outputBuses;
+    };
+
+    struct FeedbackLoop
+    {
+        std::vector<int> members;                    // schedule_ indices, in schedule order
+        std::vector<std::vector<uint64_t>> outputs;  // per buffer, the members' output words after the last pass
+    };
+
+    struct Cluster
+    {
+        std::vector<int> members;     // schedule_ indices, in schedule order
+        std::vector<int> successors;  // clusters_ indices of the clusters that wait for this one
+        int predecessorCount = 0;
+        std::vector<std::pair<size_t, int>> loopEnds;  // members index of a loop's last member:loops_ index
+
+        ThreadPool::Task task;
+        std::atomic<int> pendingCount{ 0 };
+    };
+
+    static const int minClusterSize = 256;     // components, so that a cluster outweighs its task's overhead
+    static const int clustersPerThread = 4;  // so that threads can balance uneven clusters
+
+    static const int maxLutInputCount = 8;
+
+    static const uint64_t stateMagic = 0x3341545355504353;  // "SCPUSTA3"
+    static const int stateHeaderSize = 6;
+
+    bool FindComponent(const std::shared_ptr<::Component const>& component, int& returnIndex) const;
+
+    void Flatten( const std::shared_ptr<::Component>& component, std::vector<::Component*>& leaves );
+    ::Component* ResolveOutput( ::Component* component, int& output ) const;
+    static bool OutputIs( ::Component* component, int output, int bufferNo, bool value );
+    void AddStats( const std::shared_ptr<::Component>& component, int componentIndex, std::vector<::Circuit::Stats::ComponentStats>& stats ) const;
+    void ResetStats( const std::shared_ptr<::Component>& component );
+    std::vector<Input> ResolveInputs( ::Component* component, bool resolvePorts ) const;
+    void CollectState( const std::shared_ptr<::Component>& component, std::vector<::Component*>& stateComponents ) const;
+
+    /**
+     * @brief Saves and restores the state of ::Circuit::SaveState()
+     *
+     * A saved state is a sequence of 64-bit words: a header (stateMagic, buffer
+     * count, current buffer, bus count, a hash of every bus's signal and lane
+     * count, and schedule size if compiled), followed by the packed words of
+     * every bus of every component, sub-circuit internals included
+     * (CollectState()), in a fixed order. Each bus's words are followed by its
+     * word value count (0, or its signal count if any word values were set on
+     * it), then that many word values' flag bits and words. Each component's
+     * buses are followed by the word count and words of its own state (see
+     * ::Component::SaveState()). A compiled circuit's state ends with each
+     * buffer's event-driven dirty_ bits and resync_ flag.
+     */
+
+    size_t StateShape( std::vector<::Component*> const& stateComponents, uint64_t& busCount, uint64_t& shape ) const;
+    void SaveState( std::vector<uint64_t>& state ) const;
+    bool RestoreState( std::vector<uint64_t> const& state );
+
+    void Compile();
+    void CompileLaneBatches();
+
+    /**
+     * @brief Sets the outputs of folded gates in every buffer
+     *
+     * With optimizeLogic_ set, Compile() leaves constant and dead gates (see
+     * ::Circuit::SetOptimizeLogic()) out of the schedule, keeping them in
+     * elided_ instead. The outputs of constant gates are set here, and are read
+     * over their wires like any other output. Only gates that no receiver reads
+     * over a feedback wire are folded, as such a wire reads no value on the
+     * first tick.
+     */
+
+    void ApplyConstants();
+
+    /**
+     * @brief Generates and loads native code for the gates of the schedule
+     *
+     * With codegen_ set, C++ source is generated for each run of consecutive
+     * gates in the schedule (broken after the last member of every feedback
+     * loop, where TickSeries() may settle the loop), with one statement per
+     * gate, and loaded via NativeCode. The generated functions read and write
+     * the gates' packed output bits where the interpreter would, through a flat
+     * array of pointers to the values_ and hasValues_ words of every bus
+     * involved (nativeWords_, per buffer), but keep each gate's output in a
+     * local variable for the gates later in the same run. TickRange() calls a
+     * run's function in place of evaluating its gates one by one.
+     */
+
+    void CompileNative();
+
+    /**
+     * @brief Maps cones of gates outside feedback loops onto Luts
+     *
+     * A cone is a gate (its root) and the gates that only it reads, directly or
+     * through each other, and its leaves are the distinct outputs read into the
+     * cone from elsewhere. The root stays in the schedule, its resolved wires
+     * replaced by one per leaf (with toInput -1), while the rest of the cone
+     * joins elided_. EvaluateGate() and ProcessGate() evaluate a root by
+     * indexing its Lut's truth table with its leaves' output bits. In
+     * TickMode::EventDriven, a root is marked dirty whenever one of its leaves'
+     * components is processed.
+     */
+
+    void MapLuts( std::vector<::Component*> const& order, std::unordered_map<::Component*, std::vector<Input>>& inputs,
+                  std::unordered_set<::Component*> const& loopMembers, std::unordered_set<::Component*>& elided );
+
+    /**
+     * @brief Partitions the schedule into Clusters for TickMode::Parallel
+     *
+     * Every wire orders the component that reads it and the one that drives it
+     * as they are ordered in the schedule, and components are taken in
+     * depth-first scan order, a whole feedback loop at a time, each joining the
+     * newest of the clusters it is ordered after (so that clusters grow along
+     * wires), unless that cluster is full. All wires between clusters therefore
+     * lead from an older cluster to a newer one, so the clusters form an
+     * acyclic graph, and ticking each cluster's components in schedule order
+     * once its predecessors are done reads every wire exactly as a Series tick
+     * would.
+     */
+
+    void CompileClusters( std::vector<::Component*> const& groups, std::vector<size_t> const& groupOffsets,
+                          std::unordered_map<::Component*, int>& indices );
+
+    void PrepareTick( ::Component::TickMode mode );
+    void TickNext( ::Component::TickMode mode, int64_t tickCount );
+    int64_t RunUntil( std::function<bool( int bufferNo )> const& predicate, int64_t maxTicks, ::Component::TickMode mode );
+
+    void Tick( ::Component::TickMode mode, int bufferNo );
+    void TickComponent( int scheduleIndex, int bufferNo, bool reprocess = false );
+    void TickSeries( int bufferNo );
+    void TickRange( size_t begin, size_t end, int bufferNo );
+    void TickLanes( int bufferNo );
+
+    /**
+     * @brief Ticks only the components whose inputs have changed
+     *
+     * A component is only processed when one of its inputs has changed since it
+     * was last processed (components without inputs, and VcdWriters, are always
+     * processed). After processing, each of its outputs is compared against the
+     * inputs it feeds (its "fan-out"), and any input that differs is updated
+     * and its component marked dirty for processing. As the schedule is in
+     * topological order, dirty components are reached later in the same sweep,
+     * or in the next sweep via a feedback wire.
+     */
+
+    void TickEventDriven( int bufferNo );
+    void SweepEventDriven( size_t begin, size_t end, int bufferNo, bool resync );
+    void ForwardChanges( int scheduleIndex, int bufferNo );
+    void TickClusters( int bufferNo );
+    void RunCluster( int clusterNo );
+    void ResyncEventDriven();
+
+    /**
+     * @brief Settles a FeedbackLoop once its last member has been ticked
+     *
+     * A FeedbackLoop is a strongly connected component of the wire graph. Its
+     * members are re-ticked in schedule order, now reading the current tick's
+     * outputs over their feedback wires, until their output words match a
+     * snapshot of the previous pass, or maxFeedbackIterations_ passes have been
+     * made. In TickMode::EventDriven, SettleLoopEventDriven() instead
+     * re-processes the members marked dirty via feedback wires, until none are.
+     */
+
+    void SettleLoop( FeedbackLoop& loop, int bufferNo );
+    void SettleLoopEventDriven( FeedbackLoop const& loop, int bufferNo );
+    bool UpdateLoopOutputs( FeedbackLoop& loop, int bufferNo );
+
+    /**
+     * @brief Evaluates a built-in gate without its virtual Process() method
+     *
+     * In TickMode::Series, a gate's inputs are read directly from the output
+     * buses of the components that drive it (GateOp), and its output computed
+     * with Gate::Evaluate(). In bit-parallel mode, the gates of each level are
+     * instead grouped by type into LaneBatches and evaluated with
+     * LaneKernels::EvaluateBatch() once all other components of that level have
+     * been ticked.
+     */
+
+    void EvaluateGate( int scheduleIndex, int bufferNo );
+    void EvaluateLut( int scheduleIndex, int bufferNo );
+    void EvaluateGateLanes( int scheduleIndex, int bufferNo );
+    void ProcessGate( int scheduleIndex, int bufferNo );
+
+    int pauseCount_ = 0;
+    int currentThreadNo_ = 0;
+    int laneCount_ = 0;
+    int maxFeedbackIterations_ = 1;
+    bool optimizeLogic_ = false;
+    int lutInputCount_ = 0;
+    int lutGateCount_ = 0;
+    bool codegen_ = false;
+    ::Circuit::SyncPolicy syncPolicy_ = ::Circuit::SyncPolicy::Blocking;
+
+    bool compiled_ = false;
+#ifdef SCOTTCPU_STATS
+    int64_t tickCount_ = 0;
+#endif
+    ::Component::TickMode lastMode_ = ::Component::TickMode::Parallel;
+
+    AutoTickThread autoTickThread_;
+
+    std::vector<std::shared_ptr<::Component>> components_;
+    std::vector<std::unique_ptr<CircuitThread>> circuitThreads_;
+
+    std::vector<::Component*> schedule_;  // components in levelized, topological order
+    std::vector<::Component*> roots_;     // components in the order compiled, sub-circuits flattened
+    std::vector<int> levelOffsets_;       // schedule_ index of the first component of each level
+    std::vector<std::vector<Input>> inputs_;    // per schedule_ index
+    std::vector<std::vector<FanOut>> fanOuts_;  // per schedule_ index
+    std::vector<GateOp> gateOps_;               // per schedule_ index
+    std::vector<char> alwaysProcessed_;         // per schedule_ index, by event-driven ticks
+    std::vector<::Component*> subCircuits_;     // flattened sub-circuits, at any depth
+    std::vector<FeedbackLoop> loops_;           // in order of their last member
+
+    std::vector<std::pair<::Component*, int>> watched_;     // components_ outputs watched by RunUntil()
+    std::unordered_set<::Component*> observed_;             // their drivers, as of the last Compile()
+    std::vector<::Component*> elided_;                      // gates left out of schedule_
+    std::vector<std::pair<::Component*, bool>> constants_;  // elided gates:their constant output
+    std::vector<Lut> luts_;
+
+    NativeCode nativeCode_;
+    std::vector<NativeRun> nativeRuns_;
+    std::vector<int> nativeRunNos_;                    // per schedule_ index, the run starting there, or -1
+    std::vector<std::vector<uint64_t*>> nativeWords_;  // per buffer
+
+    std::vector<std::vector<LaneBatch>> laneBatches_;  // per buffer, in level order
+    std::vector<uint64_t> zeroLanes_;                  // lanes of unconnected gate inputs
+
+    std::vector<std::vector<unsigned char>> dirty_;  // per buffer, per schedule_ index
+    std::vector<unsigned char> resync_;              // per buffer
+
+    std::vector<std::unique_ptr<Cluster>> clusters_;
+    std::vector<int> rootClusters_;  // clusters_ indices of the clusters that wait for none
+    int clusterBufferNo_ = 0;        // buffer being ticked by the clusters
+    std::atomic<int> pendingClusterCount_{ 0 };
+    SyncFlag clustersDone_;
+};
+
+}  // namespace internal
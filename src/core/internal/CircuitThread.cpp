@@ -8,6 +8,11 @@
  */
 
 #include "CircuitThread.h"
+#include "Circuit.h"
+
+#ifdef SCOTTCPU_TRACE
+#include "Trace.h"
+#endif
 
 using namespace internal;
 
@@ -20,20 +25,20 @@ CircuitThread::~CircuitThread()
     Stop();
 }
 
-void CircuitThread::Start(std::vector<std::shared_ptr<::Component>>* components, int threadNo)
+void CircuitThread::Start(Circuit* circuit, int threadNo)
 {
     if (!stopped_)
     {
         return;
     }
 
-    components_ = components;
+    circuit_ = circuit;
     threadNo_ = threadNo;
 
     stop_ = false;
     stopped_ = false;
-    gotResume_ = false;
-    gotSync_ = false;
+    resume_.Clear();
+    sync_.Clear();
 
     thread_ = std::thread(&CircuitThread::Run, this);
 
@@ -66,53 +71,59 @@ void CircuitThread::Sync()
         return;
     }
 
-    std::unique_lock<std::mutex> lock(resumeMutex_);
-
-    if (!gotSync_)  // if haven't already got sync
-    {
-        syncCondt_.wait(lock);  // wait for sync
-    }
+    Wait(sync_);  // wait for sync
 }
 
-void CircuitThread::SyncAndResume(::Component::TickMode mode)
+void CircuitThread::SyncAndResume(::Component::TickMode mode, int64_t tickCount)
 {
     if (stopped_)
     {
         return;
     }
 
-    std::unique_lock<std::mutex> lock(resumeMutex_);
+    Wait(sync_);  // wait for sync
+    sync_.Clear();  // reset the sync flag
+
+    mode_ = mode;
+    tickCount_ = tickCount;
+
+    resume_.Set();  // set the resume flag
+}
+
+void CircuitThread::SetSyncPolicy(::Circuit::SyncPolicy policy)
+{
+    resume_.SetPolicy(policy);
+    sync_.SetPolicy(policy);
+}
 
-    if (!gotSync_)  // if haven't already got sync
+void CircuitThread::Wait(SyncFlag& flag)
+{
+#ifdef SCOTTCPU_TRACE
+    if (!flag.IsSet())
     {
-        syncCondt_.wait(lock);  // wait for sync
+        Trace::Scope traceScope("SyncWait", "wait", threadNo_);
+        flag.Wait();
+        return;
     }
-    gotSync_ = false;  // reset the sync flag
-
-    mode_ = mode;
+#endif
 
-    gotResume_ = true;  // set the resume flag
-    resumeCondt_.notify_all();
+    flag.Wait();
 }
 
 void CircuitThread::Run()
 {
-    if (components_ != nullptr)
+#ifdef SCOTTCPU_TRACE
+    Trace::Get().SetThreadName("CircuitThread " + std::to_string(threadNo_));
+#endif
+
+    if (circuit_ != nullptr)
     {
         while (!stop_)
         {
-            {
-                std::unique_lock<std::mutex> lock(resumeMutex_);
+            sync_.Set();  // set the sync flag
 
-                gotSync_ = true;  // set the sync flag
-                syncCondt_.notify_all();
-
-                if (!gotResume_)  // if haven't already got resume
-                {
-                    resumeCondt_.wait(lock);  // wait for resume
-                }
-                gotResume_ = false;  // reset the resume flag
-            }
+            resume_.Wait();  // wait for resume
+            resume_.Clear();  // reset the resume flag
 
             if (!stop_)
             {
@@ -126,13 +137,9 @@ void CircuitThread::Run()
 
                 // E.g. 1,2,3 and 1,2,3. Not 1,2,3 and 2,3,1,2,3.
 
-                for (auto& component : *components_ )
-                {
-                    component->Tick(mode_, threadNo_);
-                }
-                for (auto& component : *components_)
+                for (int64_t i = 0; i < tickCount_; ++i)
                 {
-                    component->Reset(threadNo_);
+                    circuit_->Tick(mode_, threadNo_);
                 }
             }
         }
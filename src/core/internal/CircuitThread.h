@@ -9,20 +9,21 @@
 
 #pragma once
 
-#include "../Component.h"
+#include "SyncFlag.h"
 
-#include <condition_variable>
 #include <thread>
 
 namespace internal
 {
 
+class Circuit;
+
 /**
  * @brief Thread class for asynchronously ticking circuit components
  *
  * A CircuitThread is responsible for ticking and reseting all components 
- * within a Circuit. Upon initialisation, a reference to the vector of circuit
- * components must be provided for the thread Run() method to loop through. 
+ * within a Circuit. Upon initialisation, a reference to the circuit must be 
+ * provided for the thread Run() method to tick. 
  * Each CircuitThread has a thread number (threadNo), which is also provided upon
  * initialisation. When creating multiple CircuitThreads, each thread must have 
  * their own unique thread number, beginning at 0 and incrementing by 1 for every
@@ -37,7 +38,10 @@ namespace internal
  * (I.e. Circuit's Tick() method) we can simply loop through our array of 
  * CircuitThreads calling SyncAndResume() on each. If a circuit thread is busy 
  * processing, a call to SyncAndResume() will block momentarily until that thread 
- * is done processing.
+ * is done processing. SyncAndResume() can also be given a number of ticks to 
+ * run back-to-back before the thread waits again (see Circuit::TickN()).
+ * The hand-over between the controlling thread and the CircuitThread goes through
+ * a pair of SyncFlags, whose waiting behaviour is set with SetSyncPolicy().
  */
 
 class CircuitThread final
@@ -48,25 +52,27 @@ public:
     CircuitThread();
     ~CircuitThread();
 
-    void Start(std::vector<std::shared_ptr<::Component>>* components, int threadNo);
+    void Start(Circuit* circuit, int threadNo);
     void Stop();
     void Sync();
-    void SyncAndResume(::Component::TickMode mode);
+    void SyncAndResume(::Component::TickMode mode, int64_t tickCount = 1);
+
+    void SetSyncPolicy(::Circuit::SyncPolicy policy);
 
 private:
+    void Wait(SyncFlag& flag);
     void Run();
 
 private:
     ::Component::TickMode mode_;
+    int64_t tickCount_ = 1;
     std::thread thread_;
-    std::vector<std::shared_ptr<::Component>>* components_ = nullptr;
+    Circuit* circuit_ = nullptr;
     int threadNo_ = 0;
     bool stop_ = false;
     bool stopped_ = true;
-    bool gotResume_ = false;
-    bool gotSync_ = true;
-    std::mutex resumeMutex_;
-    std::condition_variable resumeCondt_, syncCondt_;
+    SyncFlag resume_;
+    SyncFlag sync_;
 };
 
 }  // namespace internal
\ No newline at end of file
@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../Component.h"
+#include "ThreadPool.h"
+#include "Wire.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <algorithm>
+#include <condition_variable>
+
+namespace internal
+{
+
+/**
+ * @brief Private state of a Component
+ *
+ * internal::Component holds the buses, wires, thread and synchronisation
+ * primitives of a ::Component. It is shared with internal::Circuit so that the
+ * circuit's compile step can walk component connections without exposing them
+ * through the public Component API.
+ *
+ * In TickMode::Parallel, each buffer's tick is run as a ThreadPool task once all
+ * of its dependencies are met: every non-feedback input component has finished
+ * processing that buffer, and, for in-order components, the previous buffer has
+ * released it (see ParallelTick).
+ */
+
+class Component
+{
+public:
+
+    enum class TickStatus
+    {
+        NotTicked,
+        TickStarted,
+        Ticking
+    };
+
+    /**
+     * @brief State of one buffer's tick in TickMode::Parallel
+     *
+     * pendingCount holds the number of dependencies still to be met, plus one while
+     * they are being registered. Whichever thread decrements it to zero submits the
+     * task to the pool.
+     */
+
+    struct ParallelTick
+    {
+        ThreadPool::Task task;
+        std::atomic<int> pendingCount{ 0 };
+        bool awaitingRelease = false;  // guarded by the buffer's release mutex
+
+        std::mutex mutex;
+        std::condition_variable doneCondt;
+        bool done = true;
+        std::vector<ParallelTick*> dependents;  // ticks waiting for this one to be done
+
+        void DependencyMet()
+        {
+            if ( --pendingCount == 0 )
+            {
+                ThreadPool::GetDefault().Submit( &task );
+            }
+        }
+    };
+
+#ifdef SCOTTCPU_STATS
+    /**
+     * @brief One buffer's ::Component::Stats, updated from any thread
+     */
+
+    struct StatCounters
+    {
+        std::atomic<int64_t> tickCount{ 0 };
+        std::atomic<int64_t> processNs{ 0 };
+        std::atomic<int64_t> releaseWaitNs{ 0 };
+        std::atomic<int64_t> syncWaitNs{ 0 };
+        std::atomic<int64_t> signalCopies{ 0 };
+        std::atomic<int64_t> signalMoves{ 0 };
+
+        static void Add( std::atomic<int64_t>& counter, int64_t value )
+        {
+            counter.fetch_add( value, std::memory_order_relaxed );
+        }
+
+        static int64_t NowNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+        }
+    };
+#endif
+
+    Component(::Component::ProcessOrder processOrder) : processOrder_(processOrder)
+    {}
+
+    void WaitForRelease( int threadNo );
+    void ReleaseThread( int threadNo );
+    void SkipProcess( int threadNo );
+
+    bool AddDependent( int bufferNo, ParallelTick& dependent );
+    void ReserveDependents();
+    void AwaitRelease( int bufferNo );
+    void FinishTick( int bufferNo );
+    void SyncTick( int bufferNo );
+
+    void GetOutput( int bufferNo, int fromOutput, int toInput, ::SignalBus& toBus, ::Component::TickMode mode );
+
+    void IncRefs( int output );
+    void DecRefs(int output);
+
+    const ::Component::ProcessOrder processOrder_;
+
+    int bufferCount_ = 0;
+    int laneCount_ = 0;
+
+    std::vector<::SignalBus> inputBuses_;
+    std::vector<::SignalBus> outputBuses_;
+
+    std::vector<std::vector<std::pair<int, int>>> refs_;  // ref_total:ref_counter per output, per buffer
+    std::vector<std::vector<std::unique_ptr<std::mutex>>> refMutexes_;
+
+    std::vector<Wire> inputWires_;
+
+    std::vector<std::unique_ptr<ParallelTick>> parallelTicks_;
+    std::vector<std::vector<Wire*>> feedbackWires_;  // cleared, but not freed, after each tick
+
+    std::vector<TickStatus> tickStatuses_;
+    std::vector<bool> gotReleases_;
+    std::vector<std::unique_ptr<std::mutex>> releaseMutexes_;
+    std::vector<std::unique_ptr<std::condition_variable>> releaseCondts_;
+
+    std::vector<std::string> inputNames_;
+    std::vector<std::string> outputNames_;
+
+#ifdef SCOTTCPU_STATS
+    std::vector<std::unique_ptr<StatCounters>> stats_;  // per buffer
+#endif
+};
+
+}  // namespace internal
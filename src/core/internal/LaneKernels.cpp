@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "LaneKernels.h"
+
+#if defined( __x86_64__ ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define SCOTTCPU_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace internal;
+
+namespace
+{
+
+typedef void ( *BatchKernel )( LaneOp, LaneGate const*, int, int );
+
+// Each kernel evaluates gateCount gates of wordCount lane words. OP is expanded in the inner
+// loop for every gate type, so the switch is taken once per batch rather than once per word.
+#define SCOTTCPU_LANE_OP_CASES( EVAL )                          \
+    case LaneOp::Buf:  EVAL( in0 );                  break;    \
+    case LaneOp::Not:  EVAL( NOT( in0 ) );           break;    \
+    case LaneOp::And:  EVAL( AND( in0, in1 ) );      break;    \
+    case LaneOp::Nand: EVAL( NOT( AND( in0, in1 ) ) ); break;  \
+    case LaneOp::Or:   EVAL( OR( in0, in1 ) );       break;    \
+    case LaneOp::Nor:  EVAL( NOT( OR( in0, in1 ) ) ); break;   \
+    case LaneOp::Xor:  EVAL( XOR( in0, in1 ) );      break;    \
+    case LaneOp::Xnor: EVAL( NOT( XOR( in0, in1 ) ) ); break
+
+void ScalarKernel( LaneOp op, LaneGate const* gates, int gateCount, int wordCount, int firstWord )
+{
+#define NOT( a ) ~( a )
+#define AND( a, b ) ( ( a ) & ( b ) )
+#define OR( a, b ) ( ( a ) | ( b ) )
+#define XOR( a, b ) ( ( a ) ^ ( b ) )
+#define EVAL( expr )                                                  \
+    for ( int g = 0; g < gateCount; ++g )                             \
+    {                                                                 \
+        for ( int w = firstWord; w < wordCount; ++w )                 \
+        {                                                             \
+            uint64_t in0 = gates[g].in0_[w];                          \
+            uint64_t in1 = op > LaneOp::Not ? gates[g].in1_[w] : 0;   \
+            (void)in1;                                                \
+            gates[g].out_[w] = expr;                                  \
+        }                                                             \
+    }
+
+    switch ( op )
+    {
+        SCOTTCPU_LANE_OP_CASES( EVAL );
+    }
+
+#undef EVAL
+#undef XOR
+#undef OR
+#undef AND
+#undef NOT
+}
+
+void ScalarBatch( LaneOp op, LaneGate const* gates, int gateCount, int wordCount )
+{
+    ScalarKernel( op, gates, gateCount, wordCount, 0 );
+}
+
+#ifdef SCOTTCPU_X86_KERNELS
+
+__attribute__( ( target( "avx2" ) ) ) void Avx2Batch( LaneOp op, LaneGate const* gates, int gateCount, int wordCount )
+{
+    if ( wordCount < 4 )
+    {
+        return ScalarBatch( op, gates, gateCount, wordCount );  // too few lanes to fill a register
+    }
+
+    const __m256i ones = _mm256_set1_epi64x( -1 );
+    const int vectorWords = wordCount & ~3;
+
+#define NOT( a ) _mm256_xor_si256( a, ones )
+#define AND( a, b ) _mm256_and_si256( a, b )
+#define OR( a, b ) _mm256_or_si256( a, b )
+#define XOR( a, b ) _mm256_xor_si256( a, b )
+#define EVAL( expr )                                                                                      \
+    for ( int g = 0; g < gateCount; ++g )                                                                 \
+    {                                                                                                     \
+        for ( int w = 0; w < vectorWords; w += 4 )                                                        \
+        {                                                                                                 \
+            __m256i in0 = _mm256_loadu_si256( (__m256i const*)( gates[g].in0_ + w ) );                     \
+            __m256i in1 = op > LaneOp::Not ? _mm256_loadu_si256( (__m256i const*)( gates[g].in1_ + w ) )  \
+                                           : _mm256_setzero_si256();                                      \
+            (void)in1;                                                                                    \
+            _mm256_storeu_si256( (__m256i*)( gates[g].out_ + w ), expr );                                 \
+        }                                                                                                 \
+    }
+
+    switch ( op )
+    {
+        SCOTTCPU_LANE_OP_CASES( EVAL );
+    }
+
+#undef EVAL
+#undef XOR
+#undef OR
+#undef AND
+#undef NOT
+
+    if ( vectorWords != wordCount )
+    {
+        ScalarKernel( op, gates, gateCount, wordCount, vectorWords );
+    }
+}
+
+__attribute__( ( target( "avx512f" ) ) ) void Avx512Batch( LaneOp op, LaneGate const* gates, int gateCount, int wordCount )
+{
+    if ( wordCount < 8 )
+    {
+        return Avx2Batch( op, gates, gateCount, wordCount );  // too few lanes to fill a register
+    }
+
+    const __m512i ones = _mm512_set1_epi64( -1 );
+    const int vectorWords = wordCount & ~7;
+
+#define NOT( a ) _mm512_xor_si512( a, ones )
+#define AND( a, b ) _mm512_and_si512( a, b )
+#define OR( a, b ) _mm512_or_si512( a, b )
+#define XOR( a, b ) _mm512_xor_si512( a, b )
+#define EVAL( expr )                                                                                  \
+    for ( int g = 0; g < gateCount; ++g )                                                             \
+    {                                                                                                 \
+        for ( int w = 0; w < vectorWords; w += 8 )                                                    \
+        {                                                                                             \
+            __m512i in0 = _mm512_loadu_si512( gates[g].in0_ + w );                                    \
+            __m512i in1 = op > LaneOp::Not ? _mm512_loadu_si512( gates[g].in1_ + w )                  \
+                                           : _mm512_setzero_si512();                                  \
+            (void)in1;                                                                                \
+            _mm512_storeu_si512( gates[g].out_ + w, expr );                                           \
+        }                                                                                             \
+    }
+
+    switch ( op )
+    {
+        SCOTTCPU_LANE_OP_CASES( EVAL );
+    }
+
+#undef EVAL
+#undef XOR
+#undef OR
+#undef AND
+#undef NOT
+
+    if ( vectorWords != wordCount )
+    {
+        ScalarKernel( op, gates, gateCount, wordCount, vectorWords );
+    }
+}
+
+#endif
+
+LaneKernels::Isa DetectIsa()
+{
+#ifdef SCOTTCPU_X86_KERNELS
+    __builtin_cpu_init();
+
+    if ( __builtin_cpu_supports( "avx512f" ) )
+    {
+        return LaneKernels::Isa::Avx512;
+    }
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        return LaneKernels::Isa::Avx2;
+    }
+#endif
+    return LaneKernels::Isa::Scalar;
+}
+
+BatchKernel KernelFor( LaneKernels::Isa isa )
+{
+    switch ( isa )
+    {
+#ifdef SCOTTCPU_X86_KERNELS
+        case LaneKernels::Isa::Avx512:
+            return Avx512Batch;
+        case LaneKernels::Isa::Avx2:
+            return Avx2Batch;
+#endif
+        default:
+            return ScalarBatch;
+    }
+}
+
+const LaneKernels::Isa supportedIsa = DetectIsa();
+
+LaneKernels::Isa activeIsa = supportedIsa;
+BatchKernel activeKernel = KernelFor( supportedIsa );
+
+}  // namespace
+
+LaneKernels::Isa LaneKernels::GetSupportedIsa()
+{
+    return supportedIsa;
+}
+
+LaneKernels::Isa LaneKernels::GetIsa()
+{
+    return activeIsa;
+}
+
+LaneKernels::Isa LaneKernels::SetIsa( Isa isa )
+{
+    if ( isa > supportedIsa )
+    {
+        isa = supportedIsa;  // can't select an instruction set that the CPU doesn't support
+    }
+
+    activeIsa = isa;
+    activeKernel = KernelFor( isa );
+
+    return activeIsa;
+}
+
+void LaneKernels::Evaluate( LaneOp op, uint64_t* out, uint64_t const* in0, uint64_t const* in1, int wordCount )
+{
+    LaneGate gate = { out, in0, in1 };
+    activeKernel( op, &gate, 1, wordCount );
+}
+
+void LaneKernels::EvaluateBatch( LaneOp op, LaneGate const* gates, int gateCount, int wordCount )
+{
+    activeKernel( op, gates, gateCount, wordCount );
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../../Common.h"
+
+#include <cstdint>
+
+namespace internal
+{
+
+enum class LaneOp
+{
+    Buf,
+    Not,
+    And,
+    Nand,
+    Or,
+    Nor,
+    Xor,
+    Xnor
+};
+
+/**
+ * @brief Lane words of one gate evaluation (see LaneKernels::EvaluateBatch())
+ */
+
+struct LaneGate final
+{
+    uint64_t* out_;
+    uint64_t const* in0_;
+    uint64_t const* in1_;  // ignored by Buf and Not
+};
+
+/**
+ * @brief Bitwise gate kernels for bit-parallel simulation
+ *
+ * In bit-parallel mode every signal holds one bit per lane, packed into lane words
+ * (see SignalBus::GetLanes()). LaneKernels evaluates a logic gate over all lanes of 
+ * its inputs at once. With 256 or 512 lanes, the lane words of a signal fill an AVX2
+ * or AVX-512 register, and each gate evaluation becomes a single vector operation.
+ * The instruction set is selected at runtime from what the CPU supports, falling 
+ * back to plain 64-bit word operations on other CPUs and compilers. SetIsa() can be 
+ * used to select a lesser instruction set (E.g. for benchmarking).
+ * EvaluateBatch() evaluates a batch of gates of the same type (I.e. those sharing a 
+ * level in a compiled circuit), dispatching once for the whole batch.
+ */
+
+class LaneKernels final
+{
+public:
+    enum class Isa
+    {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    static Isa GetSupportedIsa();
+
+    static Isa GetIsa();
+    static Isa SetIsa( Isa isa );
+
+    static void Evaluate( LaneOp op, uint64_t* out, uint64_t const* in0, uint64_t const* in1, int wordCount );
+    static void EvaluateBatch( LaneOp op, LaneGate const* gates, int gateCount, int wordCount );
+};
+
+}  // namespace internal
@@ -0,0 +1,290 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "NativeCode.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <dirent.h>
+#include <dlfcn.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define SCOTTCPU_DLOPEN
+extern char** environ;
+#endif
+
+using namespace internal;
+
+namespace
+{
+
+#ifdef SCOTTCPU_DLOPEN
+
+char const* const compilerFlags[] = { "-std=c++14", "-O2", "-shared", "-fPIC" };
+
+const size_t maxCachedObjects = 64;
+
+std::string getEnv( char const* name, char const* fallback )
+{
+    char const* value = std::getenv( name );
+    return value != nullptr && *value != '\0' ? value : fallback;
+}
+
+bool readFile( const std::string& filePath, std::string& data )
+{
+    std::ifstream file( filePath, std::ios::binary );
+    std::stringstream stream;
+    stream << file.rdbuf();
+    data = stream.str();
+    return file.good() || file.eof();
+}
+
+bool writeFile( const std::string& filePath, const std::string& data )
+{
+    std::ofstream file( filePath, std::ios::binary );
+    file.write( data.data(), data.size() );
+    file.close();
+    return !file.fail();
+}
+
+// whether filePath is a file or directory (as asked) of our own that no one else can write
+bool isPrivate( const std::string& filePath, bool directory )
+{
+    struct stat status;
+    return lstat( filePath.c_str(), &status ) == 0 && status.st_uid == geteuid() &&
+           ( status.st_mode & ( directory ? 077 : 022 ) ) == 0 &&
+           ( directory ? S_ISDIR( status.st_mode ) : S_ISREG( status.st_mode ) );
+}
+
+// our cache directory in the temporary directory (TMPDIR, or /tmp), or "" if it isn't safe to use
+std::string cacheDirectory()
+{
+    std::string directory = getEnv( "TMPDIR", "/tmp" ) + "/scottcpu-" + std::to_string( geteuid() );
+    mkdir( directory.c_str(), 0700 );
+    return isPrivate( directory, true ) ? directory : "";
+}
+
+// runs the compiler (with its output going to ours) and waits for it
+bool runCompiler( const std::string& compiler, const std::string& objectPath, const std::string& sourcePath )
+{
+    std::vector<char*> argv;
+    argv.push_back( const_cast<char*>( compiler.c_str() ) );
+    for ( auto flag : compilerFlags )
+    {
+        argv.push_back( const_cast<char*>( flag ) );
+    }
+    argv.push_back( const_cast<char*>( "-o" ) );
+    argv.push_back( const_cast<char*>( objectPath.c_str() ) );
+    argv.push_back( const_cast<char*>( sourcePath.c_str() ) );
+    argv.push_back( nullptr );
+
+    pid_t pid;
+    if ( posix_spawnp( &pid, compiler.c_str(), nullptr, nullptr, argv.data(), environ ) != 0 )
+    {
+        return false;
+    }
+
+    int status;
+    while ( waitpid( pid, &status, 0 ) == -1 )
+    {
+        if ( errno != EINTR )
+        {
+            return false;
+        }
+    }
+    return WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+}
+
+// removes all but the maxCachedObjects most recently used shared objects (and their keys) from
+// the cache directory, and any files left behind by builds that didn't finish within the hour
+void prune( const std::string& directory )
+{
+    DIR* dir = opendir( directory.c_str() );
+    if ( dir == nullptr )
+    {
+        return;
+    }
+
+    std::vector<std::pair<time_t, std::string>> objects;  // last used:stem
+    time_t now = time( nullptr );
+
+    while ( auto entry = readdir( dir ) )
+    {
+        std::string name = entry->d_name;
+        std::string filePath = directory + "/" + name;
+        struct stat status;
+        if ( name[0] == '.' || lstat( filePath.c_str(), &status ) != 0 || !S_ISREG( status.st_mode ) )
+        {
+            continue;
+        }
+
+        auto dot = name.find( '.' );
+        std::string extension = dot != std::string::npos ? name.substr( dot ) : "";
+        if ( extension == ".so" )
+        {
+            objects.emplace_back( status.st_mtime, directory + "/" + name.substr( 0, dot ) );
+        }
+        else if ( extension != ".key" && now - status.st_mtime > 60 * 60 )
+        {
+            std::remove( filePath.c_str() );
+        }
+    }
+    closedir( dir );
+
+    if ( objects.size() <= maxCachedObjects )
+    {
+        return;
+    }
+
+    // oldest first
+    std::sort( objects.begin(), objects.end() );
+    for ( size_t i = 0; i < objects.size() - maxCachedObjects; ++i )
+    {
+        std::remove( ( objects[i].second + ".key" ).c_str() );
+        std::remove( ( objects[i].second + ".so" ).c_str() );
+    }
+}
+
+// compiles source into a shared object, unless one was already compiled from it, and returns its path
+std::string compile( const std::string& source )
+{
+    std::string directory = cacheDirectory();
+    if ( directory.empty() )
+    {
+        return "";
+    }
+
+    // the key file holds everything that went into the shared object, so that a hit can be checked
+    std::string compiler = getEnv( "SCOTTCPU_CXX", "c++" );
+    std::string key = compiler;
+    for ( auto flag : compilerFlags )
+    {
+        key += std::string( 1, '\0' ) + flag;
+    }
+    key += std::string( 1, '\0' ) + source;
+
+    std::string stem = directory + "/" + std::to_string( std::hash<std::string>()( key ) );
+    std::string keyPath = stem + ".key";
+    std::string filePath = stem + ".so";
+
+    std::string cachedKey;
+    if ( isPrivate( keyPath, false ) && isPrivate( filePath, false ) && readFile( keyPath, cachedKey ) &&
+         cachedKey == key )
+    {
+        utimes( filePath.c_str(), nullptr );  // recently used, so pruned last
+        return filePath;
+    }
+
+    // build under names of our own, so that other threads and processes never load a partly written file
+    static std::atomic<int> buildNo( 0 );
+    std::string buildStem = stem + "." + std::to_string( getpid() ) + "." + std::to_string( buildNo++ );
+    std::string sourcePath = buildStem + ".cpp";
+    std::string objectPath = buildStem + ".so";
+    std::string buildKeyPath = buildStem + ".key";
+
+    // the shared object goes in first, so that a matching key always comes with its shared object
+    bool result = writeFile( sourcePath, source ) && writeFile( buildKeyPath, key ) &&
+                  runCompiler( compiler, objectPath, sourcePath ) && chmod( objectPath.c_str(), 0700 ) == 0 &&
+                  chmod( buildKeyPath.c_str(), 0600 ) == 0 &&
+                  std::rename( objectPath.c_str(), filePath.c_str() ) == 0 &&
+                  std::rename( buildKeyPath.c_str(), keyPath.c_str() ) == 0;
+
+    std::remove( sourcePath.c_str() );
+    std::remove( objectPath.c_str() );
+    std::remove( buildKeyPath.c_str() );
+
+    prune( directory );
+
+    return result ? filePath : "";
+}
+
+#endif
+
+}  // namespace
+
+NativeCode::~NativeCode()
+{
+    Unload();
+}
+
+bool NativeCode::Load( const std::string& source, int functionCount )
+{
+    Unload();
+
+#ifdef SCOTTCPU_DLOPEN
+    std::string filePath = compile( source );
+    if ( filePath.empty() )
+    {
+        return false;
+    }
+
+    handle_ = dlopen( filePath.c_str(), RTLD_NOW | RTLD_LOCAL );
+    if ( handle_ == nullptr )
+    {
+        return false;
+    }
+
+    for ( int i = 0; i < functionCount; ++i )
+    {
+        auto function = reinterpret_cast<Function>( dlsym( handle_, FunctionName( i ).c_str() ) );
+        if ( function == nullptr )
+        {
+            Unload();
+            return false;
+        }
+        functions_.push_back( function );
+    }
+
+    return true;
+#else
+    (void)source;
+    (void)functionCount;
+    return false;
+#endif
+}
+
+void NativeCode::Unload()
+{
+    functions_.clear();
+
+#ifdef SCOTTCPU_DLOPEN
+    if ( handle_ != nullptr )
+    {
+        dlclose( handle_ );
+        handle_ = nullptr;
+    }
+#endif
+}
+
+bool NativeCode::IsLoaded() const
+{
+    return handle_ != nullptr;
+}
+
+NativeCode::Function NativeCode::GetFunction( int functionNo ) const
+{
+    return functions_[functionNo];
+}
+
+std::string NativeCode::FunctionName( int functionNo )
+{
+    return "scottcpu_run_" + std::to_string( functionNo );
+}
@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../../Common.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace internal
+{
+
+/**
+ * @brief Generated C++ code, compiled and loaded at runtime
+ *
+ * Load() compiles C++ source that defines functionCount extern "C" functions,
+ * named by FunctionName(), into a shared object with the system compiler, loads
+ * it, and looks up the functions. The compiler is the one named by the
+ * SCOTTCPU_CXX environment variable, or "c++", and its diagnostics go to our
+ * stderr. Shared objects are kept in a private cache directory (scottcpu-<uid>
+ * in TMPDIR, or /tmp), named after a hash of the compiler, its flags and the 
+ * source, so the same source is only compiled once. A cached shared object is 
+ * only loaded if the cache directory and its files are ours and not writable by
+ * others, and the key stored beside it matches. Each build prunes the cache to
+ * its 64 most recently used shared objects.
+ *
+ * Loading is only supported on Unix-like systems. Elsewhere, Load() returns false.
+ */
+
+class NativeCode final
+{
+public:
+    NONCOPYABLE( NativeCode );
+
+    typedef void ( *Function )( uint64_t* const* words );
+
+    NativeCode() = default;
+    ~NativeCode();
+
+    bool Load( const std::string& source, int functionCount );
+    void Unload();
+
+    bool IsLoaded() const;
+    Function GetFunction( int functionNo ) const;
+
+    static std::string FunctionName( int functionNo );
+
+private:
+    void* handle_ = nullptr;
+    std::vector<Function> functions_;
+};
+
+}  // namespace internal
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../Netlist.h"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace internal
+{
+
+/**
+ * @brief Private state of a Netlist, and the layout of a netlist file
+ *
+ * A netlist file is laid out as follows, each section starting on an 8-byte
+ * boundary, in the writing machine's byte order:
+ *
+ *   Header
+ *   TypeEntry      types[typeCount]
+ *   uint32_t       componentTypes[componentCount]  (index into types)
+ *   uint64_t       wireOffsets[componentCount + 1] (into wires, of each component's first input wire)
+ *   WireEntry      wires[wireCount]
+ *   char           names[namesSize]                (type names, referred to by TypeEntry)
+ *
+ * Components are referred to by their index in componentTypes.
+ */
+
+class Netlist
+{
+public:
+    static constexpr char magic[8] = { 'S', 'C', 'P', 'U', 'N', 'E', 'T', '\0' };
+    static const uint32_t version = 1;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t typeCount;
+        uint64_t componentCount;
+        uint64_t wireCount;
+        uint64_t namesSize;
+    };
+
+    struct TypeEntry
+    {
+        uint64_t nameOffset;  // into names
+        uint32_t nameSize;
+        int32_t gateType;     // ::Gate::Type, or -1 if not a built-in gate
+        uint32_t inputCount;
+        uint32_t outputCount;
+    };
+
+    struct WireEntry
+    {
+        uint32_t fromComponent;
+        uint32_t fromOutput;
+        uint32_t toInput;
+    };
+
+    static uint64_t Align( uint64_t size )
+    {
+        return ( size + 7 ) & ~uint64_t( 7 );
+    }
+
+    std::unordered_map<std::string, ::Netlist::Factory> factories_;  // by std::type_info::name()
+};
+
+}  // namespace internal
@@ -0,0 +1,132 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../SubCircuit.h"
+
+namespace internal
+{
+
+/**
+ * @brief A sub-circuit's inputs, as seen from inside it
+ *
+ * Inner components routed from a sub-circuit input are wired to the corresponding
+ * output of this component. When the sub-circuit ticks its inner components
+ * itself, Process() copies the sub-circuit's input bus (bus_) to its outputs.
+ * A compiled circuit instead resolves such wires to the sub-circuit's own input
+ * wires (see internal::Circuit::ResolveOutput()).
+ */
+
+class SubCircuitInputs final : public ::Component
+{
+public:
+    SubCircuitInputs( ::SubCircuit* subCircuit, int inputCount )
+        : Component( ProcessOrder::OutOfOrder )
+        , subCircuit_( subCircuit )
+    {
+        SetOutputCount( inputCount );
+    }
+
+    ::SubCircuit* const subCircuit_;
+    ::SignalBus const* bus_ = nullptr;
+
+protected:
+    virtual void Process( ::SignalBus const&, ::SignalBus& outputs ) override
+    {
+        for ( int i = 0; i < outputs.GetSignalCount(); ++i )
+        {
+            outputs.CopySignal( i, *bus_, i );
+        }
+    }
+
+    virtual void ProcessLanes( ::SignalBus const& inputs, ::SignalBus& outputs ) override
+    {
+        Process( inputs, outputs );  // CopySignal() copies lanes
+    }
+};
+
+/**
+ * @brief A sub-circuit's outputs, as seen from inside it
+ *
+ * Each input of this component is driven by the inner component output routed to
+ * the corresponding sub-circuit output. Process() copies its inputs to the
+ * sub-circuit's output bus (bus_).
+ */
+
+class SubCircuitOutputs final : public ::Component
+{
+public:
+    SubCircuitOutputs( int outputCount )
+        : Component( ProcessOrder::OutOfOrder )
+    {
+        SetInputCount( outputCount );
+    }
+
+    ::SignalBus* bus_ = nullptr;
+
+protected:
+    virtual void Process( ::SignalBus const& inputs, ::SignalBus& ) override
+    {
+        for ( int i = 0; i < inputs.GetSignalCount(); ++i )
+        {
+            bus_->CopySignal( i, inputs, i );
+        }
+    }
+
+    virtual void ProcessLanes( ::SignalBus const& inputs, ::SignalBus& outputs ) override
+    {
+        Process( inputs, outputs );  // CopySignal() copies lanes
+    }
+};
+
+/**
+ * @brief Private state of a SubCircuit
+ *
+ * The template is the sub-circuit's wiring by component index (-1 standing for
+ * the sub-circuit's inputs or outputs), built on the first call to Instantiate()
+ * and discarded whenever the sub-circuit changes.
+ */
+
+class SubCircuit
+{
+public:
+    struct TemplateWire
+    {
+        int fromComponent;  // components_ index, or -1 for inputs_
+        int fromOutput;
+        int toComponent;    // components_ index, or -1 for outputs_
+        int toInput;
+    };
+
+    bool FindComponent( const std::shared_ptr<::Component const>& component, int& returnIndex ) const
+    {
+        for ( size_t i = 0; i < components_.size(); ++i )
+        {
+            if ( components_[i] == component )
+            {
+                returnIndex = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::shared_ptr<SubCircuitInputs> inputs_;
+    std::shared_ptr<SubCircuitOutputs> outputs_;
+
+    std::vector<std::shared_ptr<::Component>> components_;
+
+    std::vector<TemplateWire> template_;
+    bool templateValid_ = false;
+
+    int bufferNo_ = 0;  // the buffer being processed (see ::SubCircuit::CallProcess())
+};
+
+}  // namespace internal
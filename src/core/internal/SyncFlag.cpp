@@ -0,0 +1,156 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "SyncFlag.h"
+
+#include <climits>
+#include <thread>
+
+#if defined( __linux__ )
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace internal;
+
+namespace
+{
+
+// roughly a few microseconds, about the time it takes to put a thread to sleep and wake it again
+constexpr int adaptiveSpinCount = 4096;
+
+inline void cpuRelax()
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+    __builtin_ia32_pause();
+#elif defined( __aarch64__ )
+    asm volatile( "yield" );
+#else
+    std::this_thread::yield();
+#endif
+}
+
+bool isMultiCore()
+{
+    static const bool multiCore = std::thread::hardware_concurrency() > 1;
+    return multiCore;
+}
+
+}  // namespace
+
+SyncFlag::SyncFlag( bool set )
+    : flag_( set ? 1 : 0 )
+    , sleepingCount_( 0 )
+    , policy_( ::Circuit::SyncPolicy::Blocking )
+{
+}
+
+void SyncFlag::SetPolicy( ::Circuit::SyncPolicy policy )
+{
+    policy_ = policy;
+}
+
+::Circuit::SyncPolicy SyncFlag::GetPolicy() const
+{
+    return policy_;
+}
+
+bool SyncFlag::IsSet() const
+{
+    return flag_.load( std::memory_order_acquire ) != 0;
+}
+
+void SyncFlag::Set()
+{
+    flag_ = 1;
+
+    // A sleeping thread increments sleepingCount_ before checking flag_ one last time, while we
+    // set flag_ before checking sleepingCount_, so at least one of us sees the other's write.
+    if ( sleepingCount_ > 0 )
+    {
+#if defined( __linux__ )
+        syscall( SYS_futex, reinterpret_cast<int*>( &flag_ ), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0 );
+#endif
+        std::lock_guard<std::mutex> lock( mutex_ );
+        condt_.notify_all();
+    }
+}
+
+void SyncFlag::Clear()
+{
+    flag_.store( 0, std::memory_order_relaxed );
+}
+
+void SyncFlag::Wait()
+{
+    switch ( policy_.load( std::memory_order_relaxed ) )
+    {
+        case ::Circuit::SyncPolicy::Blocking:
+            if ( !IsSet() )
+            {
+                Sleep();
+            }
+            break;
+
+        case ::Circuit::SyncPolicy::Adaptive:
+            if ( !Spin( isMultiCore() ? adaptiveSpinCount : 0 ) )
+            {
+                Sleep();
+            }
+            break;
+
+        case ::Circuit::SyncPolicy::BusyPoll:
+            while ( !Spin( adaptiveSpinCount ) )
+            {
+                if ( policy_.load( std::memory_order_relaxed ) != ::Circuit::SyncPolicy::BusyPoll )
+                {
+                    Wait();  // policy changed while polling
+                    break;
+                }
+            }
+            break;
+    }
+}
+
+bool SyncFlag::Spin( int spinCount )
+{
+    for ( int i = 0; i < spinCount; ++i )
+    {
+        if ( IsSet() )
+        {
+            return true;
+        }
+        cpuRelax();
+    }
+    return IsSet();
+}
+
+void SyncFlag::Sleep()
+{
+#if defined( __linux__ )
+    if ( policy_.load( std::memory_order_relaxed ) == ::Circuit::SyncPolicy::Adaptive )
+    {
+        ++sleepingCount_;
+        while ( flag_ == 0 )
+        {
+            // only sleeps if flag_ is still 0 once inside the kernel
+            syscall( SYS_futex, reinterpret_cast<int*>( &flag_ ), FUTEX_WAIT_PRIVATE, 0, nullptr, nullptr, 0 );
+        }
+        --sleepingCount_;
+        return;
+    }
+#endif
+
+    std::unique_lock<std::mutex> lock( mutex_ );
+
+    ++sleepingCount_;
+    condt_.wait( lock, [this] { return flag_ != 0; } );
+    --sleepingCount_;
+}
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../Circuit.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace internal
+{
+
+/**
+ * @brief Flag for handing control from one thread to another
+ *
+ * One thread calls Set() to hand over, while the other waits for it in Wait().
+ * The flag stays set until Clear() is called. How Wait() waits depends on the
+ * flag's policy (see ::Circuit::SyncPolicy):
+ *
+ * - Blocking: wait on a condition variable.
+ * - Adaptive: spin for a short while, then wait on a futex (on Linux, otherwise a
+ *   condition variable). Spinning is skipped on single core machines.
+ * - BusyPoll: spin until the flag is set.
+ *
+ * Set() only makes a system call when a thread is asleep in Wait(), so the policy
+ * can be changed at any time, even while another thread waits.
+ */
+
+class SyncFlag final
+{
+public:
+    NONCOPYABLE( SyncFlag );
+
+    SyncFlag( bool set = false );
+
+    void SetPolicy( ::Circuit::SyncPolicy policy );
+    ::Circuit::SyncPolicy GetPolicy() const;
+
+    bool IsSet() const;
+
+    void Set();
+    void Clear();
+    void Wait();
+
+private:
+    bool Spin( int spinCount );
+    void Sleep();
+
+private:
+    std::atomic<int> flag_;
+    std::atomic<int> sleepingCount_;
+    std::atomic<::Circuit::SyncPolicy> policy_;
+    std::mutex mutex_;
+    std::condition_variable condt_;
+};
+
+}  // namespace internal
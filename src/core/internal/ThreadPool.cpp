@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "ThreadPool.h"
+
+#ifdef SCOTTCPU_TRACE
+#include "Trace.h"
+#endif
+
+#include <algorithm>
+
+using namespace internal;
+
+namespace
+{
+
+// the pool and worker that the calling thread belongs to, if any
+thread_local ThreadPool* currentPool = nullptr;
+thread_local int currentWorkerNo = -1;
+
+}  // namespace
+
+ThreadPool::ThreadPool( int threadCount )
+    : queuedCount_( 0 )
+    , sleepingCount_( 0 )
+    , nextWorker_( 0 )
+{
+    threadCount = std::max( threadCount, 1 );
+
+    // create all queues before starting any thread, as threads steal from one another
+    for ( int i = 0; i < threadCount; ++i )
+    {
+        workers_.emplace_back( new Worker() );
+    }
+    for ( int i = 0; i < threadCount; ++i )
+    {
+        workers_[i]->thread = std::thread( &ThreadPool::Run, this, i );
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( sleepMutex_ );
+        stop_ = true;
+    }
+    sleepCondt_.notify_all();
+
+    for ( auto& worker : workers_ )
+    {
+        worker->thread.join();
+    }
+}
+
+ThreadPool& ThreadPool::GetDefault()
+{
+    static ThreadPool pool( std::thread::hardware_concurrency() );
+    return pool;
+}
+
+int ThreadPool::GetThreadCount() const
+{
+    return workers_.size();
+}
+
+void ThreadPool::Submit( Task const* task )
+{
+    int workerNo = currentPool == this ? currentWorkerNo : nextWorker_++ % workers_.size();
+
+    {
+        std::lock_guard<std::mutex> lock( workers_[workerNo]->mutex );
+        workers_[workerNo]->tasks.PushBack( task );
+    }
+
+    // A sleeping thread increments sleepingCount_ before checking queuedCount_ one last time,
+    // while we increment queuedCount_ before checking sleepingCount_, so at least one of us sees
+    // the other's increment.
+    ++queuedCount_;
+    if ( sleepingCount_ > 0 )
+    {
+        std::lock_guard<std::mutex> lock( sleepMutex_ );
+        sleepCondt_.notify_one();
+    }
+}
+
+ThreadPool::Task const* ThreadPool::Pop( int workerNo )
+{
+    // take our own most recent task first...
+    {
+        auto& worker = *workers_[workerNo];
+        std::lock_guard<std::mutex> lock( worker.mutex );
+        if ( !worker.tasks.IsEmpty() )
+        {
+            return worker.tasks.PopBack();
+        }
+    }
+
+    // ...otherwise steal the oldest task of another thread
+    for ( size_t i = 1; i < workers_.size(); ++i )
+    {
+        auto& victim = *workers_[( workerNo + i ) % workers_.size()];
+        std::lock_guard<std::mutex> lock( victim.mutex );
+        if ( !victim.tasks.IsEmpty() )
+        {
+            return victim.tasks.PopFront();
+        }
+    }
+
+    return nullptr;
+}
+
+void ThreadPool::Run( int workerNo )
+{
+    currentPool = this;
+    currentWorkerNo = workerNo;
+
+#ifdef SCOTTCPU_TRACE
+    Trace::Get().SetThreadName( "ThreadPool worker " + std::to_string( workerNo ) );
+#endif
+
+    for ( ;; )
+    {
+        if ( auto task = Pop( workerNo ) )
+        {
+            --queuedCount_;
+            ( *task )();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( sleepMutex_ );
+
+        ++sleepingCount_;
+        sleepCondt_.wait( lock, [this] { return stop_ || queuedCount_ > 0; } );
+        --sleepingCount_;
+
+        if ( stop_ )
+        {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::TaskQueue::IsEmpty() const
+{
+    return size_ == 0;
+}
+
+void ThreadPool::TaskQueue::PushBack( Task const* task )
+{
+    if ( size_ == ring_.size() )
+    {
+        // double the capacity, unwrapping the queue to start at index 0
+        std::vector<Task const*> ring( std::max<size_t>( ring_.size() * 2, 64 ) );
+        for ( size_t i = 0; i < size_; ++i )
+        {
+            ring[i] = ring_[( front_ + i ) & ( ring_.size() - 1 )];
+        }
+        ring_.swap( ring );
+        front_ = 0;
+    }
+
+    ring_[( front_ + size_++ ) & ( ring_.size() - 1 )] = task;
+}
+
+ThreadPool::Task const* ThreadPool::TaskQueue::PopBack()
+{
+    return ring_[( front_ + --size_ ) & ( ring_.size() - 1 )];
+}
+
+ThreadPool::Task const* ThreadPool::TaskQueue::PopFront()
+{
+    auto task = ring_[front_];
+    front_ = ( front_ + 1 ) & ( ring_.size() - 1 );
+    --size_;
+    return task;
+}
@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../../Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace internal
+{
+
+/**
+ * @brief Fixed-size, work-stealing pool of threads for running component ticks
+ *
+ * Each pool thread has its own queue of tasks. A task submitted from a pool thread
+ * is pushed onto that thread's queue, and is popped from the same end next (so the
+ * components a task makes ready run straight after it, while their inputs are
+ * still in cache). Tasks submitted from other threads are dealt round-robin across
+ * the queues. A pool thread whose queue is empty steals from the other end of the
+ * other threads' queues, and sleeps once there is no work left anywhere.
+ *
+ * Tasks are passed by pointer and are not copied, so must outlive their execution.
+ * Queues are ring buffers that only ever grow, so once they have grown to fit the
+ * largest tick, submitting and running tasks no longer allocates memory.
+ * A task must not block waiting for another task, as there may be no free pool
+ * thread left to run it.
+ *
+ * GetDefault() returns a process-wide pool with one thread per hardware core,
+ * used to tick components in TickMode::Parallel.
+ */
+
+class ThreadPool final
+{
+public:
+    NONCOPYABLE( ThreadPool );
+
+    using Task = std::function<void()>;
+
+    ThreadPool( int threadCount );
+    ~ThreadPool();
+
+    static ThreadPool& GetDefault();
+
+    int GetThreadCount() const;
+
+    void Submit( Task const* task );
+
+private:
+    class TaskQueue
+    {
+    public:
+        bool IsEmpty() const;
+        void PushBack( Task const* task );
+        Task const* PopBack();
+        Task const* PopFront();
+
+    private:
+        std::vector<Task const*> ring_;  // capacity is always a power of 2
+        size_t front_ = 0;
+        size_t size_ = 0;
+    };
+
+    struct Worker
+    {
+        std::mutex mutex;
+        TaskQueue tasks;
+        std::thread thread;
+    };
+
+    void Run( int workerNo );
+    Task const* Pop( int workerNo );
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<int> queuedCount_;
+    std::atomic<int> sleepingCount_;
+    std::atomic<unsigned> nextWorker_;
+    bool stop_ = false;
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondt_;
+};
+
+}  // namespace internal
@@ -0,0 +1,235 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#if defined( __GNUG__ )
+#include <cxxabi.h>
+#endif
+
+using namespace internal;
+
+namespace
+{
+
+// the calling thread's ring, and the name to give it
+thread_local void* currentRing = nullptr;
+thread_local std::string currentThreadName;
+
+int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+std::string typeName( std::type_info const& type )
+{
+#if defined( __GNUG__ )
+    int status = 0;
+    char* demangled = abi::__cxa_demangle( type.name(), nullptr, nullptr, &status );
+    if ( status == 0 && demangled != nullptr )
+    {
+        std::string name = demangled;
+        std::free( demangled );
+        return name;
+    }
+#endif
+    return type.name();
+}
+
+void writeString( std::ostream& out, std::string const& string )
+{
+    out << '"';
+    for ( char c : string )
+    {
+        if ( c == '"' || c == '\\' )
+        {
+            out << '\\';
+        }
+        out << c;
+    }
+    out << '"';
+}
+
+}  // namespace
+
+Trace::Scope::Scope( const char* name, const char* category, int bufferNo, const std::type_info* type, const void* component )
+    : recording_( Trace::Get().IsRecording() )
+    , name_( name )
+    , category_( category )
+    , bufferNo_( bufferNo )
+    , type_( type )
+    , component_( component )
+{
+    if ( recording_ )
+    {
+        Trace::Get().Begin( name_, category_, bufferNo_, type_, component_ );
+    }
+}
+
+Trace::Scope::~Scope()
+{
+    // end what we began, even if tracing stopped in between
+    if ( recording_ )
+    {
+        Trace::Get().Record( 'E', name_, category_, bufferNo_, type_, component_ );
+    }
+}
+
+Trace& Trace::Get()
+{
+    // never destroyed, as pool threads may still be running at exit
+    static Trace* trace = new Trace();
+    return *trace;
+}
+
+void Trace::Start( int eventsPerThread )
+{
+    std::lock_guard<std::mutex> lock( ringsMutex_ );
+
+    // round up to a power of 2
+    capacity_ = 1;
+    while ( capacity_ < eventsPerThread )
+    {
+        capacity_ *= 2;
+    }
+
+    for ( auto& ring : rings_ )
+    {
+        ring->Clear( capacity_ );
+    }
+
+    startNs_ = nowNs();
+    recording_ = true;
+}
+
+void Trace::Stop()
+{
+    recording_ = false;
+}
+
+bool Trace::IsRecording() const
+{
+    return recording_.load( std::memory_order_relaxed );
+}
+
+void Trace::SetThreadName( std::string const& threadName )
+{
+    currentThreadName = threadName;
+
+    if ( currentRing != nullptr )
+    {
+        std::lock_guard<std::mutex> lock( ringsMutex_ );
+        static_cast<Ring*>( currentRing )->threadName_ = threadName;
+    }
+}
+
+void Trace::Begin( const char* name, const char* category, int bufferNo, const std::type_info* type, const void* component )
+{
+    if ( IsRecording() )
+    {
+        Record( 'B', name, category, bufferNo, type, component );
+    }
+}
+
+void Trace::End( const char* name, const char* category, int bufferNo, const std::type_info* type, const void* component )
+{
+    if ( IsRecording() )
+    {
+        Record( 'E', name, category, bufferNo, type, component );
+    }
+}
+
+Trace::Ring* Trace::GetRing()
+{
+    if ( currentRing == nullptr )
+    {
+        // first event recorded by this thread
+        std::lock_guard<std::mutex> lock( ringsMutex_ );
+
+        rings_.emplace_back( new Ring( rings_.size() + 1, capacity_ ) );
+        rings_.back()->threadName_ = currentThreadName;
+        currentRing = rings_.back().get();
+    }
+    return static_cast<Ring*>( currentRing );
+}
+
+void Trace::Record( char phase, const char* name, const char* category, int bufferNo, const std::type_info* type,
+                    const void* component )
+{
+    GetRing()->Push( Event{ nowNs(), phase, bufferNo, name, category, type, component } );
+}
+
+void Trace::Write( std::ostream& out ) const
+{
+    std::lock_guard<std::mutex> lock( ringsMutex_ );
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    bool first = true;
+    auto separate = [&out, &first] {
+        out << ( first ? "\n" : ",\n" );
+        first = false;
+    };
+
+    for ( auto& ring : rings_ )
+    {
+        separate();
+        out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << ring->threadId_ << ",\"args\":{\"name\":";
+        writeString( out, ring->threadName_.empty() ? "thread " + std::to_string( ring->threadId_ ) : ring->threadName_ );
+        out << "}}";
+
+        // only the most recent events are left once a ring has wrapped around
+        uint64_t written = ring->written_.load( std::memory_order_acquire );
+        uint64_t capacity = ring->events_.size();
+        uint64_t begin = written > capacity ? written - capacity : 0;
+
+        for ( uint64_t i = begin; i < written; ++i )
+        {
+            auto& event = ring->events_[i & ( capacity - 1 )];
+
+            separate();
+            out << "{\"name\":";
+            writeString( out, event.type != nullptr ? typeName( *event.type ) : event.name );
+            out << ",\"cat\":\"" << event.category << "\",\"ph\":\"" << event.phase << "\",\"ts\":"
+                << ( event.ns - startNs_ ) / 1000 << '.' << std::to_string( 1000 + ( event.ns - startNs_ ) % 1000 ).substr( 1 )
+                << ",\"pid\":1,\"tid\":" << ring->threadId_ << ",\"args\":{\"buffer\":" << event.bufferNo;
+            if ( event.component != nullptr )
+            {
+                out << ",\"component\":\"" << event.component << '"';
+            }
+            out << "}}";
+        }
+    }
+
+    out << "\n]}\n";
+}
+
+Trace::Ring::Ring( int threadId, int capacity )
+    : threadId_( threadId )
+    , events_( capacity )
+    , written_( 0 )
+{
+}
+
+void Trace::Ring::Push( Event const& event )
+{
+    auto written = written_.load( std::memory_order_relaxed );
+    events_[written & ( events_.size() - 1 )] = event;
+    written_.store( written + 1, std::memory_order_release );
+}
+
+void Trace::Ring::Clear( int capacity )
+{
+    events_.assign( capacity, Event() );
+    written_ = 0;
+}
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../../Common.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace internal
+{
+
+/**
+ * @brief Process-wide recorder of begin/end events, for ::Trace
+ *
+ * Each thread records into its own ring buffer of events, created the first time
+ * the thread records while tracing. Only the owning thread writes to a ring, so
+ * recording takes no lock: an event is written into the next slot, then published
+ * by advancing the ring's atomic write count. Once full, a ring overwrites its
+ * oldest events.
+ *
+ * Event names and categories must be string literals, as only their pointers are
+ * stored. A Process event stores its component's type, from which Write() takes
+ * the event's name.
+ *
+ * Begin() and End() are only called from code built with SCOTTCPU_TRACE defined.
+ */
+
+class Trace final
+{
+public:
+    NONCOPYABLE( Trace );
+
+    struct Event
+    {
+        int64_t ns;
+        char phase;  // 'B'egin or 'E'nd
+        int bufferNo;
+        const char* name;
+        const char* category;
+        const std::type_info* type;  // if not null, names the event instead of name
+        const void* component;
+    };
+
+    /**
+     * @brief Records a begin event on construction, and its end event on destruction
+     */
+
+    class Scope final
+    {
+    public:
+        NONCOPYABLE( Scope );
+
+        Scope( const char* name, const char* category, int bufferNo, const std::type_info* type = nullptr,
+               const void* component = nullptr );
+        ~Scope();
+
+    private:
+        bool recording_;
+        const char* name_;
+        const char* category_;
+        int bufferNo_;
+        const std::type_info* type_;
+        const void* component_;
+    };
+
+    static Trace& Get();
+
+    void Start( int eventsPerThread );
+    void Stop();
+    bool IsRecording() const;
+
+    void SetThreadName( std::string const& threadName );
+
+    void Begin( const char* name, const char* category, int bufferNo, const std::type_info* type = nullptr,
+                const void* component = nullptr );
+    void End( const char* name, const char* category, int bufferNo, const std::type_info* type = nullptr,
+              const void* component = nullptr );
+
+    void Write( std::ostream& out ) const;
+
+private:
+    class Ring
+    {
+    public:
+        Ring( int threadId, int capacity );
+
+        void Push( Event const& event );
+        void Clear( int capacity );
+
+        int threadId_;
+        std::string threadName_;
+        std::vector<Event> events_;  // capacity is always a power of 2
+        std::atomic<uint64_t> written_;
+    };
+
+    Trace() = default;
+
+    Ring* GetRing();
+    void Record( char phase, const char* name, const char* category, int bufferNo, const std::type_info* type,
+                 const void* component );
+
+private:
+    std::atomic<bool> recording_{ false };
+    int capacity_ = 1 << 16;
+    int64_t startNs_ = 0;
+
+    mutable std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+}  // namespace internal
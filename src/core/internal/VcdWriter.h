@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "../VcdWriter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace internal
+{
+
+/**
+ * @brief Private state of a VcdWriter
+ *
+ * The ticking thread (there is only ever one at a time, as a VcdWriter processes in
+ * order) pushes Changes into ring_, and the writer thread pops them. Each side only
+ * writes its own index, so the ring needs no lock. A change is a packed 32-bit
+ * entry: the low 2 bits hold the new value ('0', '1' or 'x'), or 3 for a time step,
+ * and the high 30 bits the signal index, or the number of ticks to advance time by.
+ */
+
+class VcdWriter
+{
+public:
+    enum Code : uint32_t
+    {
+        Zero = 0,
+        One = 1,
+        Unknown = 2,
+        TimeStep = 3
+    };
+
+    static const uint32_t maxPayload = ( 1u << 30 ) - 1;
+
+    VcdWriter( int bufferedChanges );
+
+    void Record( uint64_t const* values, uint64_t const* hasValues, int signalCount );
+    void Push( uint32_t change );
+
+    void Run();
+    void Drain();
+    void WriteText();
+
+    static std::string Identifier( int signalIndex );
+
+    std::vector<uint32_t> ring_;  // capacity is always a power of 2
+    std::atomic<uint64_t> pushed_{ 0 };
+    std::atomic<uint64_t> popped_{ 0 };
+
+    // ticking thread only
+    std::vector<uint64_t> lastValues_;
+    std::vector<uint64_t> lastHasValues_;
+    std::vector<uint64_t> laneValues_;
+    int64_t tickCount_ = 0;
+    int64_t lastStepTick_ = 0;
+
+    // writer thread only, while open
+    std::FILE* file_ = nullptr;
+    std::string text_;
+    std::vector<std::string> identifiers_;
+    int64_t time_ = 0;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable wakeCondt_;
+    std::condition_variable flushedCondt_;
+    bool stop_ = false;
+    uint64_t flushRequests_ = 0;
+    uint64_t flushes_ = 0;
+};
+
+}  // namespace internal
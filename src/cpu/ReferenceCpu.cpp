@@ -0,0 +1,160 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "ReferenceCpu.h"
+
+#include "core/Memory.h"
+
+#include <algorithm>
+
+bool ReferenceCpu::State::operator==( State const& other ) const
+{
+    return registers == other.registers && iar == other.iar && ir == other.ir && carry == other.carry &&
+           aLarger == other.aLarger && equal == other.equal && zero == other.zero && ram == other.ram;
+}
+
+bool ReferenceCpu::State::operator!=( State const& other ) const
+{
+    return !( *this == other );
+}
+
+ReferenceCpu::State const& ReferenceCpu::GetState() const
+{
+    return state_;
+}
+
+void ReferenceCpu::SetState( State const& state )
+{
+    state_ = state;
+}
+
+void ReferenceCpu::Step()
+{
+    auto& s = state_;
+
+    s.ir = s.ram[s.iar++];
+
+    auto& ra = s.registers[( s.ir >> 2 ) & 3];
+    auto& rb = s.registers[s.ir & 3];
+
+    if ( s.ir & 0x80 )
+    {
+        int a = ra;
+        int b = rb;
+        int result = 0;
+        bool carry = false;
+
+        switch ( ( s.ir >> 4 ) & 7 )
+        {
+            case 0:  // ADD
+                result = a + b + s.carry;
+                carry = result > 0xFF;
+                break;
+            case 1:  // SHR
+                result = ( a >> 1 ) | ( s.carry << 7 );
+                carry = a & 1;
+                break;
+            case 2:  // SHL
+                result = ( a << 1 ) | s.carry;
+                carry = a & 0x80;
+                break;
+            case 3:  // NOT
+                result = ~a;
+                break;
+            case 4:  // AND
+                result = a & b;
+                break;
+            case 5:  // OR
+                result = a | b;
+                break;
+            case 6:  // XOR
+                result = a ^ b;
+                break;
+            case 7:  // CMP
+                break;
+        }
+
+        result &= 0xFF;
+
+        s.carry = carry;
+        s.aLarger = a > b;
+        s.equal = a == b;
+        s.zero = result == 0;
+
+        if ( ( s.ir & 0x70 ) != 0x70 )
+        {
+            rb = result;
+        }
+        return;
+    }
+
+    switch ( s.ir >> 4 )
+    {
+        case 0:  // LD
+            rb = s.ram[ra];
+            break;
+        case 1:  // ST
+            s.ram[ra] = rb;
+            break;
+        case 2:  // DATA
+            rb = s.ram[s.iar++];
+            break;
+        case 3:  // JMPR
+            s.iar = rb;
+            break;
+        case 4:  // JMP
+            s.iar = s.ram[s.iar];
+            break;
+        case 5:  // JCAEZ
+        {
+            int flags = ( s.carry << 3 ) | ( s.aLarger << 2 ) | ( s.equal << 1 ) | (int)s.zero;
+            s.iar = ( s.ir & flags ) != 0 ? s.ram[s.iar] : s.iar + 1;
+            break;
+        }
+        case 6:  // CLF
+            s.carry = s.aLarger = s.equal = s.zero = false;
+            break;
+        case 7:  // IO
+            if ( ( s.ir & 0x08 ) == 0 )
+            {
+                rb = 0;  // IN
+            }
+            break;
+    }
+}
+
+void ReferenceCpu::Run( int64_t instructionCount )
+{
+    for ( int64_t i = 0; i < instructionCount; ++i )
+    {
+        Step();
+    }
+}
+
+bool ReferenceCpu::LoadRam( Memory const& memory )
+{
+    auto image = memory.Dump();
+    if ( image.size() != state_.ram.size() || memory.GetWidth() != 8 )
+    {
+        return false;
+    }
+
+    std::copy( image.begin(), image.end(), state_.ram.begin() );
+    return true;
+}
+
+bool ReferenceCpu::StoreRam( Memory& memory ) const
+{
+    if ( memory.GetSize() != state_.ram.size() || memory.GetWidth() != 8 )
+    {
+        return false;
+    }
+
+    return memory.LoadImage( std::vector<uint8_t>( state_.ram.begin(), state_.ram.end() ) );
+}
@@ -0,0 +1,78 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+class Memory;
+
+/**
+ * @brief Instruction-level reference model of the Scott CPU
+ *
+ * ReferenceCpu executes the Scott CPU's instruction set a whole instruction at a
+ * time, without simulating any gates, to quickly run a program up to the point 
+ * of interest before switching to a gate-level simulation, and to check a 
+ * gate-level CPU against. Its architectural State is 4 general purpose registers
+ * (R0 to R3), the instruction address register (IAR), the instruction register
+ * (IR), the carry, a-larger, equal and zero flags, and 256 bytes of RAM.
+ *
+ * Each Step() fetches the instruction at IAR into IR, increments IAR, and 
+ * executes it. Instructions are encoded as follows (RA and RB are 2-bit register
+ * numbers, and "addr" is the byte following the instruction):
+ *
+ *   1ooo RA RB   ALU: RB = RA op RB (ooo: ADD, SHR, SHL, NOT, AND, OR, XOR, CMP)
+ *   0000 RA RB   LD:  RB = RAM[RA]
+ *   0001 RA RB   ST:  RAM[RA] = RB
+ *   0010 00 RB   DATA: RB = addr
+ *   0011 00 RB   JMPR: IAR = RB
+ *   0100 0000    JMP: IAR = addr
+ *   0101 CAEZ    JCAEZ: IAR = addr if any of the given flags is set
+ *   0110 0000    CLF: clear all flags
+ *   0111 xx RB   IO (no devices are modelled: IN reads 0, OUT is ignored)
+ *
+ * ALU instructions set all flags: carry from ADD (which adds the carry flag in),
+ * SHR and SHL (which shift it in), a-larger and equal from comparing RA with RB,
+ * and zero from the result. CMP writes no register, and its result is 0.
+ *
+ * LoadRam() and StoreRam() transfer the RAM to and from a native 256-byte Memory
+ * (see ::Memory), such as the RAM of a gate-level CPU's circuit.
+ */
+
+class ReferenceCpu final
+{
+public:
+    struct State
+    {
+        std::array<uint8_t, 4> registers{};
+        uint8_t iar = 0;
+        uint8_t ir = 0;
+        bool carry = false;
+        bool aLarger = false;
+        bool equal = false;
+        bool zero = false;
+        std::array<uint8_t, 256> ram{};
+
+        bool operator==( State const& other ) const;
+        bool operator!=( State const& other ) const;
+    };
+
+    State const& GetState() const;
+    void SetState( State const& state );
+
+    void Step();
+    void Run( int64_t instructionCount );
+
+    bool LoadRam( Memory const& memory );
+    bool StoreRam( Memory& memory ) const;
+
+private:
+    State state_;
+};
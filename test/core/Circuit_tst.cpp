@@ -0,0 +1,851 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+
+#include "TestCircuits.h"
+
+/**
+ * @brief Unit tests for Circuit class
+ */
+
+using test::Counter;
+using test::Probe;
+
+class WhenWorkingWithCircuit : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        circuit_ = std::make_shared<Circuit>();
+    }
+
+    void TearDown() override
+    {
+    }
+
+    static bool getBit( SignalBus const& bus, int signalIndex )
+    {
+        auto value = bus.GetValue( signalIndex );
+        return value != nullptr && value->value == 1;
+    }
+
+    static void setBit( SignalBus& bus, int signalIndex, bool bit )
+    {
+        onebit retval;
+        retval.value = bit;
+        bus.SetValue( signalIndex, retval );
+    }
+
+    class NAND : public Component
+    {
+    public:
+        NAND()
+        {
+            SetInputCount(2);
+            SetOutputCount(1);
+        }
+
+    protected:
+        virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override
+        {
+            setBit( outputs, 0, !( getBit( inputs, 0 ) && getBit( inputs, 1 ) ) );
+        }
+    };
+
+    class NOT : public Component
+    {
+    public:
+        NOT()
+        {
+            SetInputCount(1);
+            SetOutputCount(1);
+        }
+
+        int processCount_ = 0;
+
+    protected:
+        virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override
+        {
+            ++processCount_;
+            setBit( outputs, 0, !getBit( inputs, 0 ) );
+        }
+    };
+
+    // outputs a fixed lane pattern per output in bit-parallel mode
+    class LaneSource : public Component
+    {
+    public:
+        LaneSource( std::vector<uint64_t> const& lanes ) : lanes_( lanes )
+        {
+            SetOutputCount( lanes.size() );
+        }
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& ) override
+        {
+        }
+
+        virtual void ProcessLanes( SignalBus const&, SignalBus& outputs ) override
+        {
+            for ( size_t i = 0; i < lanes_.size(); ++i )
+            {
+                outputs.SetLanes( i, &lanes_[i] );
+            }
+        }
+
+    private:
+        std::vector<uint64_t> lanes_;
+    };
+
+    std::shared_ptr<Circuit> circuit_;
+};
+
+TEST_F(WhenWorkingWithCircuit, seriesTickCompilesTheCircuit)
+{
+    auto counter = std::make_shared<Counter>( 2 );
+    auto nand = std::make_shared<NAND>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    // add components in reverse order to make sure that ticking doesn't depend on insertion order
+    circuit_->AddComponent( probe );
+    circuit_->AddComponent( nand );
+    circuit_->AddComponent( counter );
+
+    EXPECT_TRUE( circuit_->ConnectOutToIn( counter, 0, nand, 0 ) );
+    EXPECT_TRUE( circuit_->ConnectOutToIn( counter, 1, nand, 1 ) );
+    EXPECT_TRUE( circuit_->ConnectOutToIn( nand, 0, probe, 0 ) );
+
+    EXPECT_FALSE( circuit_->IsCompiled() );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit_->Tick( Component::TickMode::Series );
+    }
+
+    EXPECT_TRUE( circuit_->IsCompiled() );
+    EXPECT_EQ( circuit_->GetLevelCount(), 3 );
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 1, 1, 1, 0 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, connectingComponentsInvalidatesTheSchedule)
+{
+    auto counter = std::make_shared<Counter>( 1 );
+    auto notGate = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( counter );
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe );
+
+    circuit_->ConnectOutToIn( counter, 0, probe, 0 );
+    circuit_->Compile();
+    EXPECT_TRUE( circuit_->IsCompiled() );
+    EXPECT_EQ( circuit_->GetLevelCount(), 2 );
+
+    circuit_->Tick( Component::TickMode::Series );
+    circuit_->Tick( Component::TickMode::Series );
+
+    circuit_->ConnectOutToIn( counter, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe, 0 );
+    EXPECT_FALSE( circuit_->IsCompiled() );
+
+    circuit_->Tick( Component::TickMode::Series );
+    circuit_->Tick( Component::TickMode::Series );
+
+    EXPECT_EQ( circuit_->GetLevelCount(), 3 );
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 0, 1, 1, 0 ) );
+
+    circuit_->RemoveComponent( notGate );
+    EXPECT_FALSE( circuit_->IsCompiled() );
+
+    // the probe's only input wire was removed along with the NOT gate
+    circuit_->Compile();
+    EXPECT_EQ( circuit_->GetLevelCount(), 1 );
+}
+
+TEST_F(WhenWorkingWithCircuit, feedbackWiresReadThePreviousTick)
+{
+    // a NOT gate driving its own input toggles on every tick
+    auto notGate = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe );
+
+    circuit_->ConnectOutToIn( notGate, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe, 0 );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit_->Tick( Component::TickMode::Series );
+    }
+
+    EXPECT_EQ( circuit_->GetLevelCount(), 2 );
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 1, 0, 1, 0 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, feedbackLoopsSettleWithinATick)
+{
+    // 128 NAND SR latches, driven by set (active low), hold, reset (active low), hold, set
+    class SetReset : public Component
+    {
+    public:
+        SetReset()
+        {
+            SetOutputCount( 2 );
+        }
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& outputs ) override
+        {
+            static const bool set[] = { false, true, true, true, false };
+            static const bool reset[] = { true, true, false, true, true };
+            setBit( outputs, 0, set[count_ % 5] );
+            setBit( outputs, 1, reset[count_ % 5] );
+            ++count_;
+        }
+
+    private:
+        int count_ = 0;
+    };
+
+    for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+    {
+        Circuit circuit;
+        auto setReset = std::make_shared<SetReset>();
+        circuit.AddComponent( setReset );
+
+        std::vector<std::shared_ptr<Probe>> probes;
+        for ( int i = 0; i < 128; ++i )
+        {
+            auto q = std::make_shared<NandGate>();
+            auto notQ = std::make_shared<NandGate>();
+            probes.emplace_back( std::make_shared<Probe>( 1 ) );
+            probes.emplace_back( std::make_shared<Probe>( 1 ) );
+
+            circuit.AddComponent( q );
+            circuit.AddComponent( notQ );
+            circuit.AddComponent( probes[i * 2] );
+            circuit.AddComponent( probes[i * 2 + 1] );
+
+            circuit.ConnectOutToIn( setReset, 0, q, 0 );
+            circuit.ConnectOutToIn( notQ, 0, q, 1 );
+            circuit.ConnectOutToIn( setReset, 1, notQ, 0 );
+            circuit.ConnectOutToIn( q, 0, notQ, 1 );
+            circuit.ConnectOutToIn( q, 0, probes[i * 2], 0 );
+            circuit.ConnectOutToIn( notQ, 0, probes[i * 2 + 1], 0 );
+        }
+
+        EXPECT_EQ( circuit.GetMaxFeedbackIterations(), 1 );
+        circuit.SetMaxFeedbackIterations( 8 );
+        EXPECT_EQ( circuit.GetMaxFeedbackIterations(), 8 );
+
+        for ( int i = 0; i < 5; ++i )
+        {
+            circuit.Tick( mode );
+        }
+
+        EXPECT_EQ( circuit.GetFeedbackLoopCount(), 128 );
+
+        // event-driven probes only process when the latch changes
+        std::vector<uint64_t> q = { 1, 1, 0, 0, 1 };
+        if ( mode == Component::TickMode::EventDriven )
+        {
+            q = { 1, 0, 1 };
+        }
+        std::vector<uint64_t> notQ( q.size() );
+        std::transform( q.begin(), q.end(), notQ.begin(), []( uint64_t value ) { return !value; } );
+
+        for ( int i = 0; i < 128; ++i )
+        {
+            EXPECT_EQ( probes[i * 2]->values_, q ) << "mode " << (int)mode;
+            EXPECT_EQ( probes[i * 2 + 1]->values_, notQ ) << "mode " << (int)mode;
+        }
+    }
+}
+
+TEST_F(WhenWorkingWithCircuit, unsettledFeedbackLoopsStopAtTheIterationCap)
+{
+    // a NOT gate driving its own input never settles
+    auto notGate = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe );
+
+    circuit_->ConnectOutToIn( notGate, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe, 0 );
+
+    circuit_->SetMaxFeedbackIterations( 3 );
+    circuit_->Tick( Component::TickMode::Series );
+    circuit_->Tick( Component::TickMode::Parallel );
+
+    EXPECT_EQ( circuit_->GetFeedbackLoopCount(), 1 );
+    EXPECT_EQ( notGate->processCount_, 6 );
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 1, 0 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, seriesTickWithBuffers)
+{
+    auto counter = std::make_shared<Counter>( 1 );
+    auto notGate = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( counter );
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe );
+
+    circuit_->ConnectOutToIn( counter, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe, 0 );
+
+    circuit_->SetBufferCount( 2 );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit_->Tick( Component::TickMode::Series );
+    }
+
+    circuit_->SetBufferCount( 0 );
+
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 1, 0, 1, 0 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, tickNTicksLikeRepeatedTicks)
+{
+    for ( int bufferCount : { 0, 3 } )
+    {
+        for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel } )
+        {
+            std::vector<std::vector<uint64_t>> values;
+
+            for ( bool batched : { false, true } )
+            {
+                Circuit circuit;
+                auto counter = std::make_shared<Counter>( 2 );
+                auto notGate = std::make_shared<NOT>();
+                auto probe = std::make_shared<Probe>( 1 );
+
+                circuit.AddComponent( counter );
+                circuit.AddComponent( notGate );
+                circuit.AddComponent( probe );
+                circuit.ConnectOutToIn( counter, 1, notGate, 0 );
+                circuit.ConnectOutToIn( notGate, 0, probe, 0 );
+                circuit.SetBufferCount( bufferCount );
+
+                if ( batched )
+                {
+                    // a count that doesn't divide evenly between the buffers
+                    circuit.TickN( 10, mode );
+                    circuit.TickN( 0, mode );
+                    circuit.TickN( 7, mode );
+                }
+                else
+                {
+                    for ( int i = 0; i < 17; ++i )
+                    {
+                        circuit.Tick( mode );
+                    }
+                }
+
+                circuit.SetBufferCount( 0 );
+                values.emplace_back( probe->values_ );
+            }
+
+            ASSERT_EQ( values[0].size(), 17u );
+            EXPECT_EQ( values[1], values[0] );
+        }
+    }
+}
+
+TEST_F(WhenWorkingWithCircuit, runUntilStopsOnceThePredicateHolds)
+{
+    for ( int bufferCount : { 0, 2 } )
+    {
+        Circuit circuit;
+        auto counter = std::make_shared<Counter>( 4 );
+        auto probe = std::make_shared<Probe>( 1 );
+
+        circuit.AddComponent( counter );
+        circuit.AddComponent( probe );
+        circuit.ConnectOutToIn( counter, 0, probe, 0 );
+        circuit.SetBufferCount( bufferCount );
+
+        // the counter's bit 3 is first set on its 9th tick (a count of 8)
+        EXPECT_EQ( circuit.RunUntil( counter, 3, true, 100, Component::TickMode::Series ), 9 );
+        EXPECT_EQ( probe->values_.size(), 9u );
+        EXPECT_EQ( circuit.RunUntil( counter, 3, false, 100, Component::TickMode::Series ), 8 );
+
+        EXPECT_EQ( circuit.RunUntil( [&probe] { return probe->values_.size() == 20; }, 100 ), 3 );
+        EXPECT_EQ( circuit.RunUntil( [] { return false; }, 5 ), 5 );
+        EXPECT_EQ( probe->values_.size(), 25u );
+
+        // nothing to wait for
+        EXPECT_EQ( circuit.RunUntil( probe, 0, true, 100 ), 0 );
+        EXPECT_EQ( circuit.RunUntil( counter, 3, true, 0 ), 0 );
+
+        circuit.SetBufferCount( 0 );
+    }
+}
+
+TEST_F(WhenWorkingWithCircuit, ticksWithEverySyncPolicy)
+{
+    auto counter = std::make_shared<Counter>( 1 );
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( counter );
+    circuit_->AddComponent( probe );
+    circuit_->ConnectOutToIn( counter, 0, probe, 0 );
+
+    circuit_->SetBufferCount( 2 );
+
+    for ( auto policy : { Circuit::SyncPolicy::Adaptive, Circuit::SyncPolicy::BusyPoll, Circuit::SyncPolicy::Blocking } )
+    {
+        circuit_->SetSyncPolicy( policy );
+        EXPECT_EQ( circuit_->GetSyncPolicy(), policy );
+
+        circuit_->Tick( Component::TickMode::Series );
+        circuit_->Tick( Component::TickMode::Series );
+    }
+
+    circuit_->SetBufferCount( 0 );
+
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 0, 1, 0, 1, 0, 1 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, parallelTickRunsManyComponents)
+{
+    // a counter driving 1000 parallel chains of 2 NOTs, all joined into a single probe by NANDs
+    auto counter = std::make_shared<Counter>( 1 );
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( counter );
+    circuit_->AddComponent( probe );
+
+    std::shared_ptr<Component> joined;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        auto not0 = std::make_shared<NOT>();
+        auto not1 = std::make_shared<NOT>();
+        circuit_->AddComponent( not0 );
+        circuit_->AddComponent( not1 );
+        circuit_->ConnectOutToIn( counter, 0, not0, 0 );
+        circuit_->ConnectOutToIn( not0, 0, not1, 0 );
+
+        if ( !joined )
+        {
+            joined = not1;
+            continue;
+        }
+
+        // NAND( NOT( a ), NOT( b ) ) == a || b, so all chains agree with the counter
+        auto nand = std::make_shared<NAND>();
+        auto notA = std::make_shared<NOT>();
+        auto notB = std::make_shared<NOT>();
+        circuit_->AddComponent( nand );
+        circuit_->AddComponent( notA );
+        circuit_->AddComponent( notB );
+        circuit_->ConnectOutToIn( joined, 0, notA, 0 );
+        circuit_->ConnectOutToIn( not1, 0, notB, 0 );
+        circuit_->ConnectOutToIn( notA, 0, nand, 0 );
+        circuit_->ConnectOutToIn( notB, 0, nand, 1 );
+        joined = nand;
+    }
+    circuit_->ConnectOutToIn( joined, 0, probe, 0 );
+
+    for ( int bufferCount : { 0, 3 } )
+    {
+        circuit_->SetBufferCount( bufferCount );
+        for ( int i = 0; i < 4; ++i )
+        {
+            circuit_->Tick( Component::TickMode::Parallel );
+        }
+    }
+    circuit_->SetBufferCount( 0 );
+
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 0, 1, 0, 1, 0, 1, 0, 1 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, parallelTickRunsClustersLikeSeriesTick)
+{
+    // 8 accumulators, each XORing a counter bit into its own previous output via a feedback wire
+    // through a chain of 300 inverters (alternately built-in gates and components)
+    auto buildCircuit = []( Circuit& circuit, std::vector<std::shared_ptr<Probe>>& probes ) {
+        auto counter = std::make_shared<Counter>( 8 );
+        circuit.AddComponent( counter );
+
+        for ( int bit = 0; bit < 8; ++bit )
+        {
+            auto xorGate = std::make_shared<XorGate>();
+            circuit.AddComponent( xorGate );
+            circuit.ConnectOutToIn( counter, bit, xorGate, 0 );
+
+            std::shared_ptr<Component> last = xorGate;
+            for ( int i = 0; i < 300; ++i )
+            {
+                std::shared_ptr<Component> inverter;
+                if ( i % 2 == 0 )
+                {
+                    inverter = std::make_shared<NotGate>();
+                }
+                else
+                {
+                    inverter = std::make_shared<NOT>();
+                }
+                circuit.AddComponent( inverter );
+                circuit.ConnectOutToIn( last, 0, inverter, 0 );
+                last = inverter;
+            }
+            circuit.ConnectOutToIn( last, 0, xorGate, 1 );
+
+            probes.emplace_back( std::make_shared<Probe>( 1 ) );
+            circuit.AddComponent( probes.back() );
+            circuit.ConnectOutToIn( last, 0, probes.back(), 0 );
+        }
+    };
+
+    Circuit series;
+    Circuit parallel;
+    std::vector<std::shared_ptr<Probe>> seriesProbes;
+    std::vector<std::shared_ptr<Probe>> parallelProbes;
+    buildCircuit( series, seriesProbes );
+    buildCircuit( parallel, parallelProbes );
+
+    EXPECT_EQ( parallel.GetClusterCount(), 0 );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        series.Tick( Component::TickMode::Series );
+        parallel.Tick( Component::TickMode::Parallel );
+    }
+
+    EXPECT_GT( parallel.GetClusterCount(), 1 );
+    EXPECT_LT( parallel.GetClusterCount(), parallel.GetComponentCount() / 100 );
+
+    for ( int bit = 0; bit < 8; ++bit )
+    {
+        ASSERT_EQ( parallelProbes[bit]->values_.size(), 16u );
+        EXPECT_EQ( parallelProbes[bit]->values_, seriesProbes[bit]->values_ ) << "bit " << bit;
+    }
+
+    // the accumulators differ, and toggle whenever their counter bit is set
+    EXPECT_NE( parallelProbes[0]->values_, parallelProbes[1]->values_ );
+    EXPECT_THAT( parallelProbes[0]->values_, testing::Contains( true ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, bitParallelTickEvaluatesEveryLane)
+{
+    auto source = std::make_shared<LaneSource>( std::vector<uint64_t>{ 0xAAAAAAAAAAAAAAAA, 0xCCCCCCCCCCCCCCCC } );
+    auto nand = std::make_shared<NAND>();
+    auto notGate = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->SetLaneCount( 64 );
+    EXPECT_EQ( circuit_->GetLaneCount(), 64 );
+
+    circuit_->AddComponent( source );
+    circuit_->AddComponent( nand );
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe );
+
+    EXPECT_EQ( nand->GetLaneCount(), 64 );
+
+    // NAND and NOT have no ProcessLanes(), so are evaluated lane-by-lane via Process()
+    circuit_->ConnectOutToIn( source, 0, nand, 0 );
+    circuit_->ConnectOutToIn( source, 1, nand, 1 );
+    circuit_->ConnectOutToIn( nand, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe, 0 );
+
+    circuit_->Tick( Component::TickMode::Series );
+
+    EXPECT_THAT( probe->lanes_[0], testing::ElementsAre( 0x8888888888888888 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, bitParallelFeedbackLoopsSettleInEveryLane)
+{
+    // a NAND SR latch, set in odd lanes and reset in even lanes
+    auto source = std::make_shared<LaneSource>( std::vector<uint64_t>{ 0x5555555555555555, 0xAAAAAAAAAAAAAAAA } );
+    auto q = std::make_shared<NandGate>();
+    auto notQ = std::make_shared<NandGate>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->SetLaneCount( 64 );
+    circuit_->SetMaxFeedbackIterations( 8 );
+
+    circuit_->AddComponent( source );
+    circuit_->AddComponent( q );
+    circuit_->AddComponent( notQ );
+    circuit_->AddComponent( probe );
+
+    circuit_->ConnectOutToIn( source, 0, q, 0 );
+    circuit_->ConnectOutToIn( notQ, 0, q, 1 );
+    circuit_->ConnectOutToIn( source, 1, notQ, 0 );
+    circuit_->ConnectOutToIn( q, 0, notQ, 1 );
+    circuit_->ConnectOutToIn( q, 0, probe, 0 );
+
+    circuit_->Tick( Component::TickMode::Series );
+
+    EXPECT_THAT( probe->lanes_[0], testing::ElementsAre( 0xAAAAAAAAAAAAAAAA ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, eventDrivenTickSkipsQuiescentComponents)
+{
+    // counter bit 1 -> NOT -> NOT -> probe, counter bit 0 -> NOT
+    auto counter = std::make_shared<Counter>( 2 );
+    auto not0 = std::make_shared<NOT>();
+    auto not1 = std::make_shared<NOT>();
+    auto not2 = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( counter );
+    circuit_->AddComponent( not0 );
+    circuit_->AddComponent( not1 );
+    circuit_->AddComponent( not2 );
+    circuit_->AddComponent( probe );
+
+    circuit_->ConnectOutToIn( counter, 0, not0, 0 );
+    circuit_->ConnectOutToIn( counter, 1, not1, 0 );
+    circuit_->ConnectOutToIn( not1, 0, not2, 0 );
+    circuit_->ConnectOutToIn( not2, 0, probe, 0 );
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        circuit_->Tick( Component::TickMode::EventDriven );
+    }
+
+    // bit 0 changes every tick, bit 1 every second tick
+    EXPECT_EQ( not0->processCount_, 8 );
+    EXPECT_EQ( not1->processCount_, 4 );
+    EXPECT_EQ( not2->processCount_, 4 );
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 0, 1, 0, 1 ) );
+}
+
+TEST_F(WhenWorkingWithCircuit, eventDrivenTickMatchesSeriesTick)
+{
+    auto runCircuit = []( Component::TickMode mode ) {
+        Circuit circuit;
+
+        auto counter = std::make_shared<Counter>( 2 );
+        auto nand = std::make_shared<NAND>();
+        auto feedbackNand = std::make_shared<NAND>();
+        auto probe = std::make_shared<Probe>( 1 );
+
+        circuit.AddComponent( counter );
+        circuit.AddComponent( nand );
+        circuit.AddComponent( feedbackNand );
+        circuit.AddComponent( probe );
+
+        // feedbackNand = NAND( NAND( bit0, bit1 ), feedbackNand )
+        circuit.ConnectOutToIn( counter, 0, nand, 0 );
+        circuit.ConnectOutToIn( counter, 1, nand, 1 );
+        circuit.ConnectOutToIn( nand, 0, feedbackNand, 0 );
+        circuit.ConnectOutToIn( feedbackNand, 0, feedbackNand, 1 );
+        circuit.ConnectOutToIn( feedbackNand, 0, probe, 0 );
+
+        for ( int i = 0; i < 16; ++i )
+        {
+            circuit.Tick( mode );
+        }
+
+        return probe->values_;
+    };
+
+    auto seriesValues = runCircuit( Component::TickMode::Series );
+    auto eventValues = runCircuit( Component::TickMode::EventDriven );
+
+    // in event-driven mode, the probe is only processed when its input changes
+    std::vector<uint64_t> seriesChanges;
+    for ( size_t i = 0; i < seriesValues.size(); ++i )
+    {
+        if ( i == 0 || seriesValues[i] != seriesValues[i - 1] )
+        {
+            seriesChanges.push_back( seriesValues[i] );
+        }
+    }
+
+    EXPECT_GT( seriesChanges.size(), 2u );
+    EXPECT_EQ( eventValues, seriesChanges );
+}
+
+TEST_F(WhenWorkingWithCircuit, statsCountTicksAndSignals)
+{
+    // counter -> NOT -> probe, where the NOT's output is also wired to a second probe
+    auto counter = std::make_shared<Counter>( 1 );
+    auto notGate = std::make_shared<NOT>();
+    auto probe0 = std::make_shared<Probe>( 1 );
+    auto probe1 = std::make_shared<Probe>( 1 );
+
+    circuit_->AddComponent( counter );
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe0 );
+    circuit_->AddComponent( probe1 );
+
+    circuit_->ConnectOutToIn( counter, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe0, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe1, 0 );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit_->Tick( Component::TickMode::Parallel );
+    }
+
+    auto stats = circuit_->GetStats();
+    ASSERT_EQ( stats.components.size(), 4u );
+    EXPECT_EQ( stats.components[1].component, notGate );
+    EXPECT_EQ( stats.components[1].componentIndex, 1 );
+    ASSERT_EQ( stats.components[1].buffers.size(), 1u );
+
+    if ( !stats.enabled )
+    {
+        EXPECT_EQ( stats.tickCount, 0 );
+        EXPECT_EQ( stats.components[1].total.tickCount, 0 );
+        return;
+    }
+
+    EXPECT_EQ( stats.tickCount, 4 );
+    for ( auto& componentStats : stats.components )
+    {
+        EXPECT_EQ( componentStats.total.tickCount, 4 );
+    }
+
+    // compiled ticks always copy: the counter's output to its only receiver, the NOT's to both
+    EXPECT_EQ( stats.components[0].total.signalMoves, 0 );
+    EXPECT_EQ( stats.components[0].total.signalCopies, 4 );
+    EXPECT_EQ( stats.components[1].total.signalMoves, 0 );
+    EXPECT_EQ( stats.components[1].total.signalCopies, 8 );
+
+    circuit_->ResetStats();
+    circuit_->Tick( Component::TickMode::Series );
+
+    stats = circuit_->GetStats();
+    EXPECT_EQ( stats.tickCount, 1 );
+    EXPECT_EQ( stats.components[1].total.tickCount, 1 );
+    EXPECT_EQ( stats.components[1].total.signalCopies, 2 );
+    EXPECT_EQ( stats.components[1].total.signalMoves, 0 );
+}
+
+TEST_F(WhenWorkingWithCircuit, restoredStateTicksLikeTheSavedState)
+{
+    // a NOT gate toggling on every tick, and a NAND-built XOR accumulating the toggle into its
+    // own previous output, i.e. a 2-bit counter held entirely in feedback wires
+    auto buildCircuit = []( Circuit& circuit ) {
+        auto toggle = std::make_shared<NOT>();
+        auto nand0 = std::make_shared<NAND>();
+        auto nand1 = std::make_shared<NAND>();
+        auto nand2 = std::make_shared<NAND>();
+        auto nand3 = std::make_shared<NAND>();
+        auto probe = std::make_shared<Probe>( 1 );
+
+        for ( auto component : std::vector<std::shared_ptr<Component>>{ toggle, nand0, nand1, nand2, nand3, probe } )
+        {
+            circuit.AddComponent( component );
+        }
+
+        circuit.ConnectOutToIn( toggle, 0, toggle, 0 );
+        circuit.ConnectOutToIn( nand3, 0, nand0, 0 );
+        circuit.ConnectOutToIn( toggle, 0, nand0, 1 );
+        circuit.ConnectOutToIn( nand3, 0, nand1, 0 );
+        circuit.ConnectOutToIn( nand0, 0, nand1, 1 );
+        circuit.ConnectOutToIn( toggle, 0, nand2, 0 );
+        circuit.ConnectOutToIn( nand0, 0, nand2, 1 );
+        circuit.ConnectOutToIn( nand1, 0, nand3, 0 );
+        circuit.ConnectOutToIn( nand2, 0, nand3, 1 );
+        circuit.ConnectOutToIn( nand3, 0, probe, 0 );
+
+        return probe;
+    };
+
+    for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+    {
+        for ( int bufferCount : { 0, 2 } )
+        {
+            Circuit circuit;
+            auto probe = buildCircuit( circuit );
+            circuit.SetBufferCount( bufferCount );
+
+            // an odd number of ticks, so that the second buffer ticks next
+            for ( int i = 0; i < 3; ++i )
+            {
+                circuit.Tick( mode );
+            }
+            auto state = circuit.SaveState();
+
+            probe->values_.clear();
+            for ( int i = 0; i < 8; ++i )
+            {
+                circuit.Tick( mode );
+            }
+            circuit.SaveState();  // waits for the last tick to finish
+            auto values = probe->values_;
+
+            for ( int run = 0; run < 2; ++run )
+            {
+                EXPECT_TRUE( circuit.RestoreState( state ) );
+
+                probe->values_.clear();
+                for ( int i = 0; i < 8; ++i )
+                {
+                    circuit.Tick( mode );
+                }
+                circuit.SaveState();
+
+                EXPECT_EQ( probe->values_, values ) << "mode " << (int)mode << ", " << bufferCount << " buffers";
+            }
+        }
+    }
+}
+
+TEST_F(WhenWorkingWithCircuit, stateIsOnlyRestoredIntoTheSameCircuit)
+{
+    auto notGate = std::make_shared<NOT>();
+    auto probe = std::make_shared<Probe>( 1 );
+    circuit_->AddComponent( notGate );
+    circuit_->AddComponent( probe );
+    circuit_->ConnectOutToIn( notGate, 0, notGate, 0 );
+    circuit_->ConnectOutToIn( notGate, 0, probe, 0 );
+
+    circuit_->Tick( Component::TickMode::Series );
+
+    auto path = testing::TempDir() + "scottcpu_Circuit_tst.state";
+    ASSERT_TRUE( circuit_->SaveState( path ) );
+
+    // restored from file into a copy of the circuit
+    Circuit copy;
+    auto copyNotGate = std::make_shared<NOT>();
+    auto copyProbe = std::make_shared<Probe>( 1 );
+    copy.AddComponent( copyNotGate );
+    copy.AddComponent( copyProbe );
+    copy.ConnectOutToIn( copyNotGate, 0, copyNotGate, 0 );
+    copy.ConnectOutToIn( copyNotGate, 0, copyProbe, 0 );
+
+    EXPECT_TRUE( copy.RestoreState( path ) );
+    for ( int i = 0; i < 3; ++i )
+    {
+        circuit_->Tick( Component::TickMode::Series );
+        copy.Tick( Component::TickMode::Series );
+    }
+    EXPECT_THAT( copyProbe->values_, testing::ElementsAre( 0, 1, 0 ) );
+
+    // not into a circuit of another shape or buffer count
+    auto state = circuit_->SaveState();
+    copy.SetBufferCount( 2 );
+    EXPECT_FALSE( copy.RestoreState( state ) );
+    copy.SetBufferCount( 0 );
+    copy.AddComponent( std::make_shared<NOT>() );
+    EXPECT_FALSE( copy.RestoreState( state ) );
+
+    EXPECT_FALSE( copy.RestoreState( std::vector<uint64_t>() ) );
+    EXPECT_FALSE( copy.RestoreState( path + ".missing" ) );
+
+    std::remove( path.c_str() );
+}
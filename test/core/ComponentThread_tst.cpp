@@ -1,37 +0,0 @@
-/**
- * Copyright (c) 2014-present, The scottcpu authors
- *
- * This source code is licensed as defined by the LICENSE file found in the
- * root directory of this source tree.
- *
- * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
- */
-
-#include "gtest/gtest.h"
-#include "gmock/gmock.h"
-
-#include "core/internal/ComponentThread.h"
-
-/**
- * @brief Unit tests for ComponentThread class
- */
-
-
-class WhenWorkingWithComponentThread : public testing::Test 
-{
-protected:    
-    void SetUp() override 
-    {
-    }
-
-    void TearDown() override 
-    {
-    } 
-};
-
-TEST_F(WhenWorkingWithComponentThread, x) 
-{
-//    internal::ComponentThread cmpTh;
-//    cmpTh.Start();
-//     std::this_thread::sleep_for(std::chrono::seconds(5));
-}
\ No newline at end of file
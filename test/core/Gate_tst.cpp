@@ -0,0 +1,575 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+
+#include "TestCircuits.h"
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+#include <ftw.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Unit tests for Gate class
+ */
+
+using test::Counter;
+using test::Probe;
+
+class WhenWorkingWithGate : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    static std::shared_ptr<Gate> makeGate( Gate::Type type )
+    {
+        switch ( type )
+        {
+            case Gate::Type::Buf:  return std::make_shared<BufGate>();
+            case Gate::Type::Not:  return std::make_shared<NotGate>();
+            case Gate::Type::And:  return std::make_shared<AndGate>();
+            case Gate::Type::Nand: return std::make_shared<NandGate>();
+            case Gate::Type::Or:   return std::make_shared<OrGate>();
+            case Gate::Type::Nor:  return std::make_shared<NorGate>();
+            case Gate::Type::Xor:  return std::make_shared<XorGate>();
+            case Gate::Type::Xnor: return std::make_shared<XnorGate>();
+        }
+        return nullptr;
+    }
+
+    static std::vector<uint64_t> truthTable( Gate::Type type )
+    {
+        std::vector<uint64_t> table;
+        for ( int count = 0; count < 4; ++count )
+        {
+            table.push_back( Gate::Evaluate( type, count & 1, count & 2 ) );
+        }
+        return table;
+    }
+
+    // counter -> gate -> probe
+    void build( Circuit& circuit, Gate::Type type )
+    {
+        counter_ = std::make_shared<Counter>( 2 );
+        gate_ = makeGate( type );
+        probe_ = std::make_shared<Probe>( 1 );
+
+        circuit.AddComponent( counter_ );
+        circuit.AddComponent( gate_ );
+        circuit.AddComponent( probe_ );
+
+        circuit.ConnectOutToIn( counter_, 0, gate_, 0 );
+        if ( gate_->GetInputCount() == 2 )
+        {
+            circuit.ConnectOutToIn( counter_, 1, gate_, 1 );
+        }
+        circuit.ConnectOutToIn( gate_, 0, probe_, 0 );
+    }
+
+    // 48 gates of every type, each reading 2 of a counter's 6 bits or earlier gates' outputs,
+    // with every 8th gate probed
+    static std::vector<std::shared_ptr<Probe>> buildNetwork( Circuit& circuit )
+    {
+        auto counter = std::make_shared<Counter>( 6 );
+        circuit.AddComponent( counter );
+
+        std::vector<std::pair<std::shared_ptr<Component>, int>> outputs;
+        for ( int i = 0; i < 6; ++i )
+        {
+            outputs.emplace_back( counter, i );
+        }
+
+        std::vector<std::shared_ptr<Probe>> probes;
+        unsigned seed = 1;
+        for ( int i = 0; i < 48; ++i )
+        {
+            auto gate = makeGate( (Gate::Type)( i % 8 ) );
+            circuit.AddComponent( gate );
+
+            for ( int in = 0; in < gate->GetInputCount(); ++in )
+            {
+                seed = seed * 1103515245 + 12345;
+                auto& output = outputs[outputs.size() - 1 - ( seed >> 16 ) % std::min<size_t>( outputs.size(), 8 )];
+                if ( i % 16 != 15 || in == 0 )  // leave some inputs unconnected
+                {
+                    circuit.ConnectOutToIn( output.first, output.second, gate, in );
+                }
+            }
+            outputs.emplace_back( gate, 0 );
+
+            if ( i % 8 == 7 )
+            {
+                probes.emplace_back( std::make_shared<Probe>( 1 ) );
+                circuit.AddComponent( probes.back() );
+                circuit.ConnectOutToIn( gate, 0, probes.back(), 0 );
+            }
+        }
+        return probes;
+    }
+
+    std::shared_ptr<Counter> counter_;
+    std::shared_ptr<Gate> gate_;
+    std::shared_ptr<Probe> probe_;
+};
+
+TEST_F(WhenWorkingWithGate, gatesHaveTheExpectedTruthTables)
+{
+    EXPECT_THAT( truthTable( Gate::Type::Nand ), testing::ElementsAre( 1, 1, 1, 0 ) );
+    EXPECT_THAT( truthTable( Gate::Type::Xor ), testing::ElementsAre( 0, 1, 1, 0 ) );
+    EXPECT_THAT( truthTable( Gate::Type::Not ), testing::ElementsAre( 1, 0, 1, 0 ) );
+    EXPECT_EQ( std::make_shared<NotGate>()->GetInputCount(), 1 );
+    EXPECT_EQ( std::make_shared<OrGate>()->GetInputCount(), 2 );
+}
+
+TEST_F(WhenWorkingWithGate, compiledCircuitEvaluatesGates)
+{
+    for ( int type = (int)Gate::Type::Buf; type <= (int)Gate::Type::Xnor; ++type )
+    {
+        Circuit circuit;
+        build( circuit, (Gate::Type)type );
+
+        for ( int i = 0; i < 4; ++i )
+        {
+            circuit.Tick( Component::TickMode::Series );
+        }
+
+        EXPECT_EQ( probe_->values_, truthTable( (Gate::Type)type ) ) << "gate type " << type;
+    }
+}
+
+TEST_F(WhenWorkingWithGate, uncompiledTickProcessesGates)
+{
+    Circuit circuit;
+    build( circuit, Gate::Type::Nand );
+
+    // ticking components directly goes through Gate::Process()
+    for ( int i = 0; i < 4; ++i )
+    {
+        probe_->Tick( Component::TickMode::Series );
+        counter_->Reset();
+        gate_->Reset();
+        probe_->Reset();
+    }
+
+    EXPECT_EQ( probe_->values_, truthTable( Gate::Type::Nand ) );
+}
+
+TEST_F(WhenWorkingWithGate, eventDrivenCircuitEvaluatesGates)
+{
+    Circuit circuit;
+    build( circuit, Gate::Type::Or );
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        circuit.Tick( Component::TickMode::EventDriven );
+    }
+
+    // OR over the counter only changes between counts 0 and 1, and 3 and 0
+    EXPECT_THAT( probe_->values_, testing::ElementsAre( 0, 1, 0, 1 ) );
+}
+
+TEST_F(WhenWorkingWithGate, bitParallelCircuitBatchesGates)
+{
+    for ( int laneCount : { 64, 512 } )
+    {
+        Circuit circuit;
+        circuit.SetLaneCount( laneCount );
+
+        // counter -> XOR -> NOT -> probe, and counter -> NAND (same level as XOR)
+        build( circuit, Gate::Type::Xor );
+        auto nand = std::make_shared<NandGate>();
+        auto notGate = std::make_shared<NotGate>();
+        circuit.AddComponent( nand );
+        circuit.AddComponent( notGate );
+        circuit.ConnectOutToIn( counter_, 0, nand, 0 );
+        circuit.ConnectOutToIn( counter_, 1, nand, 1 );
+        circuit.ConnectOutToIn( gate_, 0, notGate, 0 );
+        circuit.ConnectOutToIn( notGate, 0, probe_, 0 );
+
+        circuit.Tick( Component::TickMode::Series );
+
+        EXPECT_EQ( probe_->lanes_[0], std::vector<uint64_t>( laneCount / 64, ~( 0xAAAAAAAAAAAAAAAA ^ 0xCCCCCCCCCCCCCCCC ) ) );
+
+        circuit.Tick( Component::TickMode::EventDriven );
+
+        EXPECT_EQ( probe_->lanes_[0], std::vector<uint64_t>( laneCount / 64, ~( 0xAAAAAAAAAAAAAAAA ^ 0xCCCCCCCCCCCCCCCC ) ) );
+    }
+}
+
+TEST_F(WhenWorkingWithGate, latchesHoldTheirLaneZeroValueOnLeavingBitParallelMode)
+{
+    // outputs set and reset bits, to every lane
+    class Switches : public Component
+    {
+    public:
+        Switches()
+        {
+            SetOutputCount( 2 );
+        }
+
+        bool set_ = false;
+        bool reset_ = false;
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& outputs ) override
+        {
+            onebit bit;
+            bit.value = set_;
+            outputs.SetValue( 0, bit );
+            bit.value = reset_;
+            outputs.SetValue( 1, bit );
+        }
+
+        virtual void ProcessLanes( SignalBus const&, SignalBus& outputs ) override
+        {
+            std::vector<uint64_t> lanes( outputs.GetLaneWordCount() );
+            for ( int i = 0; i < 2; ++i )
+            {
+                std::fill( lanes.begin(), lanes.end(), ( i == 0 ? set_ : reset_ ) ? ~uint64_t( 0 ) : 0 );
+                outputs.SetLanes( i, lanes.data() );
+            }
+        }
+    };
+
+    // q = !( reset | !q ), !q = !( set | q )
+    Circuit circuit;
+    auto switches = std::make_shared<Switches>();
+    auto q = std::make_shared<NorGate>();
+    auto notQ = std::make_shared<NorGate>();
+    auto probe = std::make_shared<Probe>( 1 );
+    circuit.AddComponent( switches );
+    circuit.AddComponent( q );
+    circuit.AddComponent( notQ );
+    circuit.AddComponent( probe );
+    circuit.ConnectOutToIn( switches, 1, q, 0 );
+    circuit.ConnectOutToIn( notQ, 0, q, 1 );
+    circuit.ConnectOutToIn( switches, 0, notQ, 0 );
+    circuit.ConnectOutToIn( q, 0, notQ, 1 );
+    circuit.ConnectOutToIn( q, 0, probe, 0 );
+
+    auto tick = [&circuit]() {
+        for ( int i = 0; i < 4; ++i )
+        {
+            circuit.Tick( Component::TickMode::Series );
+        }
+    };
+
+    switches->reset_ = true;
+    tick();
+    switches->reset_ = false;
+    tick();
+    ASSERT_FALSE( probe->values_.back() );
+
+    circuit.SetLaneCount( 64 );
+    switches->set_ = true;
+    tick();
+    switches->set_ = false;
+    tick();
+    ASSERT_EQ( probe->lanes_[0].size(), 1u );
+    ASSERT_EQ( probe->lanes_[0][0], ~uint64_t( 0 ) );
+
+    circuit.SetLaneCount( 0 );
+    tick();
+    EXPECT_TRUE( probe->values_.back() );
+}
+
+TEST_F(WhenWorkingWithGate, optimizedCircuitFoldsConstantAndDeadGates)
+{
+    struct Probes
+    {
+        std::shared_ptr<Probe> live, folded, loop;
+        std::shared_ptr<Gate> dead;
+    };
+
+    auto buildOptimizable = [this]( Circuit& circuit ) {
+        build( circuit, Gate::Type::Or );
+        Probes probes{ probe_, std::make_shared<Probe>( 1 ), std::make_shared<Probe>( 1 ), std::make_shared<XorGate>() };
+
+        // NAND (unconnected) = 1 -> NOT = 0 -> AND with counter 0 = 0, into the OR with counter 1
+        auto one = std::make_shared<NandGate>();
+        auto zero = std::make_shared<NotGate>();
+        auto masked = std::make_shared<AndGate>();
+        // counter 0 -> BUF, read only by an AND with the constant 0
+        auto buf = std::make_shared<BufGate>();
+        auto maskedBuf = std::make_shared<AndGate>();
+        // a loop through a NAND with constant 0, whose output is 1, but first reads as no value
+        // over the loop's feedback wire
+        auto loopNand = std::make_shared<NandGate>();
+        auto loopBuf = std::make_shared<BufGate>();
+
+        for ( auto component : std::vector<std::shared_ptr<Component>>{ one, zero, masked, buf, maskedBuf, loopNand, loopBuf,
+                                                                         probes.folded, probes.loop, probes.dead } )
+        {
+            circuit.AddComponent( component );
+        }
+
+        circuit.ConnectOutToIn( one, 0, zero, 0 );
+        circuit.ConnectOutToIn( counter_, 0, masked, 0 );
+        circuit.ConnectOutToIn( zero, 0, masked, 1 );
+        circuit.ConnectOutToIn( masked, 0, gate_, 0 );
+
+        circuit.ConnectOutToIn( counter_, 0, buf, 0 );
+        circuit.ConnectOutToIn( buf, 0, maskedBuf, 0 );
+        circuit.ConnectOutToIn( zero, 0, maskedBuf, 1 );
+        circuit.ConnectOutToIn( maskedBuf, 0, probes.folded, 0 );
+
+        circuit.ConnectOutToIn( loopNand, 0, loopBuf, 0 );
+        circuit.ConnectOutToIn( loopBuf, 0, loopNand, 0 );
+        circuit.ConnectOutToIn( zero, 0, loopNand, 1 );
+        circuit.ConnectOutToIn( loopBuf, 0, probes.loop, 0 );
+
+        circuit.ConnectOutToIn( counter_, 0, probes.dead, 0 );
+        circuit.ConnectOutToIn( counter_, 1, probes.dead, 1 );
+
+        return probes;
+    };
+
+    for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+    {
+        Circuit plain;
+        auto expected = buildOptimizable( plain );
+
+        Circuit optimized;
+        auto actual = buildOptimizable( optimized );
+        optimized.SetOptimizeLogic( true );
+        EXPECT_TRUE( optimized.GetOptimizeLogic() );
+
+        for ( int i = 0; i < 8; ++i )
+        {
+            plain.Tick( mode );
+            optimized.Tick( mode );
+        }
+
+        // the NOT and both masking ANDs are folded, the loop's NAND isn't, and the XOR, and the
+        // NAND and BUF read only by folded gates, are dead
+        EXPECT_EQ( plain.GetFoldedGateCount(), 0 );
+        EXPECT_EQ( optimized.GetFoldedGateCount(), 3 );
+        EXPECT_EQ( optimized.GetDeadGateCount(), 3 );
+        EXPECT_EQ( optimized.GetComponentCount(), plain.GetComponentCount() );
+
+        EXPECT_EQ( actual.live->values_, expected.live->values_ );
+        EXPECT_EQ( actual.folded->values_, expected.folded->values_ );
+        EXPECT_EQ( actual.loop->values_, expected.loop->values_ );
+        EXPECT_FALSE( actual.loop->values_[0] );
+
+        // a restored state keeps the constants
+        auto state = optimized.SaveState();
+        optimized.Tick( mode );
+        ASSERT_TRUE( optimized.RestoreState( state ) );
+        optimized.Tick( mode );
+        plain.Tick( mode );
+        EXPECT_EQ( actual.folded->values_.back(), expected.folded->values_.back() );
+
+        // watching an output keeps its gate ticking
+        EXPECT_EQ( optimized.RunUntil( actual.dead, 0, true, 8, mode ), plain.RunUntil( expected.dead, 0, true, 8, mode ) );
+        EXPECT_EQ( optimized.GetDeadGateCount(), 2 );
+
+        // a removed gate is no longer watched, even once added back
+        optimized.RemoveComponent( actual.dead );
+        optimized.AddComponent( actual.dead );
+        optimized.ConnectOutToIn( counter_, 0, actual.dead, 0 );
+        optimized.ConnectOutToIn( counter_, 1, actual.dead, 1 );
+        optimized.Compile();
+        EXPECT_EQ( optimized.GetDeadGateCount(), 3 );
+    }
+
+    // in bit-parallel mode, constants fill every lane
+    Circuit plain;
+    plain.SetLaneCount( 128 );
+    auto expected = buildOptimizable( plain );
+
+    Circuit optimized;
+    optimized.SetLaneCount( 128 );
+    optimized.SetOptimizeLogic( true );
+    auto actual = buildOptimizable( optimized );
+
+    plain.Tick( Component::TickMode::Series );
+    optimized.Tick( Component::TickMode::Series );
+
+    EXPECT_EQ( actual.live->lanes_[0], expected.live->lanes_[0] );
+    EXPECT_EQ( actual.folded->lanes_[0], std::vector<uint64_t>( 2, 0 ) );
+}
+
+TEST_F(WhenWorkingWithGate, lutsTickLikeTheirGates)
+{
+    for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+    {
+        for ( int inputCount : { 1, 2, 4, 6, 8 } )
+        {
+            Circuit plain;
+            Circuit mapped;
+            mapped.SetLutInputCount( inputCount );
+            auto expected = buildNetwork( plain );
+            auto actual = buildNetwork( mapped );
+
+            // the counter's count is shared by all buffers
+            int bufferCount = inputCount == 4 ? 3 : 0;
+            plain.SetBufferCount( bufferCount );
+            mapped.SetBufferCount( bufferCount );
+            for ( int i = 0; i < 64; ++i )
+            {
+                plain.Tick( mode );
+                mapped.Tick( mode );
+            }
+            plain.SetBufferCount( 0 );
+            mapped.SetBufferCount( 0 );
+
+            EXPECT_EQ( plain.GetLutCount(), 0 );
+            EXPECT_GT( mapped.GetLutCount(), 0 ) << inputCount;
+            EXPECT_GT( mapped.GetLutGateCount(), mapped.GetLutCount() ) << inputCount;
+            EXPECT_EQ( mapped.GetDeadGateCount(), 0 );
+
+            for ( size_t i = 0; i < expected.size(); ++i )
+            {
+                EXPECT_EQ( actual[i]->values_, expected[i]->values_ ) << "k = " << inputCount << ", probe " << i;
+            }
+        }
+    }
+
+    // bigger LUTs stand in for more gates, and inputs are capped at 8
+    Circuit small, large;
+    small.SetLutInputCount( 2 );
+    large.SetLutInputCount( 100 );
+    EXPECT_EQ( large.GetLutInputCount(), 8 );
+    buildNetwork( small );
+    buildNetwork( large );
+    small.Compile();
+    large.Compile();
+    EXPECT_GT( large.GetLutGateCount() - large.GetLutCount(), small.GetLutGateCount() - small.GetLutCount() );
+}
+
+TEST_F(WhenWorkingWithGate, generatedCodeTicksLikeTheGates)
+{
+    // the network, plus a NOT gate feeding itself and a probe
+    auto build = [this]( Circuit& circuit ) {
+        auto probes = buildNetwork( circuit );
+        auto notGate = std::make_shared<NotGate>();
+        probes.emplace_back( std::make_shared<Probe>( 1 ) );
+        circuit.AddComponent( notGate );
+        circuit.AddComponent( probes.back() );
+        circuit.ConnectOutToIn( notGate, 0, notGate, 0 );
+        circuit.ConnectOutToIn( notGate, 0, probes.back(), 0 );
+        return probes;
+    };
+
+#if defined( __unix__ ) || defined( __APPLE__ )
+    // build in a temporary directory of our own, removed (with the cached shared objects) when done
+    struct TempDir
+    {
+        TempDir()
+        {
+            char const* tmpDir = std::getenv( "TMPDIR" );
+            oldTmpDir = tmpDir != nullptr ? tmpDir : "";
+            std::string pattern = ( oldTmpDir.empty() ? "/tmp" : oldTmpDir ) + "/scottcpu_tst.XXXXXX";
+            path = mkdtemp( &pattern[0] ) != nullptr ? pattern : "";
+            if ( !path.empty() )
+            {
+                setenv( "TMPDIR", path.c_str(), 1 );
+            }
+        }
+
+        ~TempDir()
+        {
+            if ( path.empty() )
+            {
+                return;
+            }
+            oldTmpDir.empty() ? unsetenv( "TMPDIR" ) : setenv( "TMPDIR", oldTmpDir.c_str(), 1 );
+            nftw(
+                path.c_str(), []( char const* filePath, struct stat const*, int, struct FTW* ) { return remove( filePath ); },
+                16, FTW_DEPTH | FTW_PHYS );
+        }
+
+        std::string oldTmpDir;
+        std::string path;
+    } tempDir;
+    ASSERT_FALSE( tempDir.path.empty() );
+#endif
+
+    for ( int variant = 0; variant < 3; ++variant )
+    {
+        Circuit plain;
+        Circuit native;
+        native.SetCodegen( true );
+        EXPECT_TRUE( native.GetCodegen() );
+        native.SetLutInputCount( variant == 1 ? 4 : 0 );
+        native.SetMaxFeedbackIterations( variant == 2 ? 4 : 1 );
+        plain.SetMaxFeedbackIterations( variant == 2 ? 4 : 1 );
+
+        auto expected = build( plain );
+        auto actual = build( native );
+
+        // the counter's count is shared by all buffers
+        int bufferCount = variant == 2 ? 3 : 0;
+        plain.SetBufferCount( bufferCount );
+        native.SetBufferCount( bufferCount );
+
+        native.Compile();
+        if ( !native.IsNative() )
+        {
+            GTEST_SKIP() << "no system compiler";
+        }
+
+        for ( int i = 0; i < 64; ++i )
+        {
+            plain.Tick( Component::TickMode::Series );
+            native.Tick( Component::TickMode::Series );
+        }
+
+        // restored states tick on just the same (the counts, not being state, carry on in both)
+        for ( auto circuit : { &plain, &native } )
+        {
+            auto state = circuit->SaveState();
+            for ( int i = 0; i < 8; ++i )
+            {
+                circuit->Tick( Component::TickMode::Series );
+            }
+            ASSERT_TRUE( circuit->RestoreState( state ) );
+        }
+        for ( auto probes : { &expected, &actual } )
+        {
+            for ( auto& probe : *probes )
+            {
+                probe->values_.resize( probe->values_.size() - 8 );
+            }
+        }
+        for ( int i = 0; i < 8; ++i )
+        {
+            plain.Tick( Component::TickMode::Series );
+            native.Tick( Component::TickMode::Series );
+        }
+
+        plain.SetBufferCount( 0 );
+        native.SetBufferCount( 0 );
+
+        for ( size_t i = 0; i < expected.size(); ++i )
+        {
+            EXPECT_EQ( actual[i]->values_, expected[i]->values_ ) << "variant " << variant << ", probe " << i;
+        }
+    }
+
+    // bit-parallel circuits aren't generated
+    Circuit lanes;
+    lanes.SetCodegen( true );
+    lanes.SetLaneCount( 64 );
+    build( lanes );
+    lanes.Compile();
+    EXPECT_FALSE( lanes.IsNative() );
+}
@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/internal/LaneKernels.h"
+
+#include <random>
+#include <vector>
+
+/**
+ * @brief Unit tests for LaneKernels class
+ */
+
+using internal::LaneKernels;
+using internal::LaneOp;
+
+class WhenWorkingWithLaneKernels : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        std::mt19937_64 random( 42 );
+        for ( auto& word : in0_ )
+        {
+            word = random();
+        }
+        for ( auto& word : in1_ )
+        {
+            word = random();
+        }
+    }
+
+    void TearDown() override
+    {
+        LaneKernels::SetIsa( LaneKernels::GetSupportedIsa() );
+    }
+
+    static uint64_t expected( LaneOp op, uint64_t in0, uint64_t in1 )
+    {
+        switch ( op )
+        {
+            case LaneOp::Buf:  return in0;
+            case LaneOp::Not:  return ~in0;
+            case LaneOp::And:  return in0 & in1;
+            case LaneOp::Nand: return ~( in0 & in1 );
+            case LaneOp::Or:   return in0 | in1;
+            case LaneOp::Nor:  return ~( in0 | in1 );
+            case LaneOp::Xor:  return in0 ^ in1;
+            case LaneOp::Xnor: return ~( in0 ^ in1 );
+        }
+        return 0;
+    }
+
+    void checkAllOps( int wordCount )
+    {
+        for ( int op = (int)LaneOp::Buf; op <= (int)LaneOp::Xnor; ++op )
+        {
+            std::vector<uint64_t> out( wordCount * 2, 0 );
+
+            // two gates per batch, the second reading the upper half of each input
+            internal::LaneGate gates[2] = { { &out[0], &in0_[0], &in1_[0] },
+                                            { &out[wordCount], &in0_[wordCount], &in1_[wordCount] } };
+
+            LaneKernels::EvaluateBatch( (LaneOp)op, gates, 2, wordCount );
+
+            for ( int w = 0; w < wordCount * 2; ++w )
+            {
+                ASSERT_EQ( out[w], expected( (LaneOp)op, in0_[w], in1_[w] ) ) << "op " << op << ", word " << w;
+            }
+        }
+    }
+
+    uint64_t in0_[32];
+    uint64_t in1_[32];
+};
+
+TEST_F(WhenWorkingWithLaneKernels, everyIsaMatchesTheScalarDefinition)
+{
+    for ( int isa = (int)LaneKernels::Isa::Scalar; isa <= (int)LaneKernels::GetSupportedIsa(); ++isa )
+    {
+        EXPECT_EQ( LaneKernels::SetIsa( (LaneKernels::Isa)isa ), (LaneKernels::Isa)isa );
+
+        // word counts that do and don't fill whole vector registers
+        for ( int wordCount : { 1, 3, 4, 8, 12, 16 } )
+        {
+            checkAllOps( wordCount );
+        }
+    }
+}
+
+TEST_F(WhenWorkingWithLaneKernels, evaluateASingleGate)
+{
+    uint64_t out[8];
+    LaneKernels::Evaluate( LaneOp::Nand, out, in0_, in1_, 8 );
+
+    for ( int w = 0; w < 8; ++w )
+    {
+        EXPECT_EQ( out[w], ~( in0_[w] & in1_[w] ) );
+    }
+}
+
+TEST_F(WhenWorkingWithLaneKernels, everyWordIsEvaluatedOnce)
+{
+    // a gate writing over its own input shows any word evaluated twice
+    for ( int isa = (int)LaneKernels::Isa::Scalar; isa <= (int)LaneKernels::GetSupportedIsa(); ++isa )
+    {
+        LaneKernels::SetIsa( (LaneKernels::Isa)isa );
+
+        for ( int wordCount : { 3, 12, 13 } )
+        {
+            std::vector<uint64_t> words( in0_, in0_ + wordCount );
+            LaneKernels::Evaluate( LaneOp::Not, words.data(), words.data(), nullptr, wordCount );
+
+            for ( int w = 0; w < wordCount; ++w )
+            {
+                ASSERT_EQ( words[w], ~in0_[w] ) << "isa " << isa << ", word count " << wordCount << ", word " << w;
+            }
+        }
+    }
+}
@@ -0,0 +1,365 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+#include "core/Memory.h"
+
+#include "TestCircuits.h"
+
+#include <cstdio>
+
+/**
+ * @brief Unit tests for Memory class
+ */
+
+using test::Probe;
+
+namespace
+{
+
+const int addressBits = 4;
+const int width = 8;
+
+}  // namespace
+
+class WhenWorkingWithMemory : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path_ = testing::TempDir() + "scottcpu_Memory_tst.bin";
+    }
+
+    void TearDown() override
+    {
+        std::remove( path_.c_str() );
+    }
+
+    // drives address, data, set and enable with a new pseudo-random pattern every tick
+    // (every lane a different one in bit-parallel mode)
+    class Driver : public Component
+    {
+    public:
+        Driver()
+        {
+            SetOutputCount( addressBits + width + 2 );
+        }
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& outputs ) override
+        {
+            auto bits = next();
+            for ( int i = 0; i < GetOutputCount(); ++i )
+            {
+                onebit bit;
+                bit.value = ( bits >> i ) & 1;
+                outputs.SetValue( i, bit );
+            }
+        }
+
+        virtual void ProcessLanes( SignalBus const&, SignalBus& outputs ) override
+        {
+            for ( int i = 0; i < GetOutputCount(); ++i )
+            {
+                std::vector<uint64_t> lanes( outputs.GetLaneWordCount() );
+                for ( auto& lane : lanes )
+                {
+                    lane = next();
+                }
+                outputs.SetLanes( i, lanes.data() );
+            }
+        }
+
+    private:
+        uint64_t next()
+        {
+            state_ = state_ * 6364136223846793005 + 1442695040888963407;
+            return state_ >> 16;
+        }
+
+        uint64_t state_ = 42;
+    };
+
+    // the same memory built out of gates: an address decoder and a latch per bit, with
+    // q = ( select & d ) | ( !select & q ), read out through an AND-OR tree
+    static std::vector<std::shared_ptr<Component>> buildGateMemory( Circuit& circuit, std::shared_ptr<Driver> const& driver )
+    {
+        int set = addressBits + width;
+        int enable = set + 1;
+
+        auto add = [&circuit]( std::shared_ptr<Component> const& component ) {
+            circuit.AddComponent( component );
+            return component;
+        };
+
+        std::vector<std::shared_ptr<Component>> addressNots;
+        for ( int i = 0; i < addressBits; ++i )
+        {
+            addressNots.emplace_back( add( std::make_shared<NotGate>() ) );
+            circuit.ConnectOutToIn( driver, i, addressNots[i], 0 );
+        }
+
+        auto decode = [&]( int selectOutput, int r ) {
+            std::shared_ptr<Component> select = driver;
+            for ( int i = 0; i < addressBits; ++i )
+            {
+                auto andGate = add( std::make_shared<AndGate>() );
+                circuit.ConnectOutToIn( select, selectOutput, andGate, 0 );
+                if ( ( r >> i ) & 1 )
+                {
+                    circuit.ConnectOutToIn( driver, i, andGate, 1 );
+                }
+                else
+                {
+                    circuit.ConnectOutToIn( addressNots[i], 0, andGate, 1 );
+                }
+                select = andGate;
+                selectOutput = 0;
+            }
+            return select;
+        };
+
+        std::vector<std::shared_ptr<Component>> outputs( width );
+        for ( int r = 0; r < ( 1 << addressBits ); ++r )
+        {
+            auto writeSelect = decode( set, r );
+            auto writeNotSelect = add( std::make_shared<NotGate>() );
+            circuit.ConnectOutToIn( writeSelect, 0, writeNotSelect, 0 );
+            auto readSelect = decode( enable, r );
+
+            for ( int b = 0; b < width; ++b )
+            {
+                auto load = add( std::make_shared<AndGate>() );
+                auto hold = add( std::make_shared<AndGate>() );
+                auto q = add( std::make_shared<OrGate>() );
+                circuit.ConnectOutToIn( writeSelect, 0, load, 0 );
+                circuit.ConnectOutToIn( driver, addressBits + b, load, 1 );
+                circuit.ConnectOutToIn( writeNotSelect, 0, hold, 0 );
+                circuit.ConnectOutToIn( q, 0, hold, 1 );
+                circuit.ConnectOutToIn( load, 0, q, 0 );
+                circuit.ConnectOutToIn( hold, 0, q, 1 );
+
+                auto read = add( std::make_shared<AndGate>() );
+                circuit.ConnectOutToIn( readSelect, 0, read, 0 );
+                circuit.ConnectOutToIn( q, 0, read, 1 );
+
+                if ( outputs[b] )
+                {
+                    auto orGate = add( std::make_shared<OrGate>() );
+                    circuit.ConnectOutToIn( outputs[b], 0, orGate, 0 );
+                    circuit.ConnectOutToIn( read, 0, orGate, 1 );
+                    outputs[b] = orGate;
+                }
+                else
+                {
+                    outputs[b] = read;
+                }
+            }
+        }
+
+        return outputs;
+    }
+
+    // driver -> native memory and gate memory -> probe (native outputs low, gate outputs high)
+    static std::shared_ptr<Probe> buildCircuit( Circuit& circuit )
+    {
+        auto driver = std::make_shared<Driver>();
+        auto memory = std::make_shared<Memory>( addressBits, width );
+        auto probe = std::make_shared<Probe>( width * 2 );
+
+        circuit.AddComponent( driver );
+        circuit.AddComponent( memory );
+        circuit.AddComponent( probe );
+
+        for ( int i = 0; i < addressBits + width + 2; ++i )
+        {
+            circuit.ConnectOutToIn( driver, i, memory, i );
+        }
+
+        auto gateOutputs = buildGateMemory( circuit, driver );
+        for ( int b = 0; b < width; ++b )
+        {
+            circuit.ConnectOutToIn( memory, b, probe, b );
+            circuit.ConnectOutToIn( gateOutputs[b], 0, probe, width + b );
+        }
+
+        return probe;
+    }
+
+    std::string path_;
+};
+
+TEST_F(WhenWorkingWithMemory, memoryMatchesAGateMemoryOnItsPorts)
+{
+    for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+    {
+        Circuit circuit;
+        auto probe = buildCircuit( circuit );
+
+        for ( int i = 0; i < 200; ++i )
+        {
+            circuit.Tick( mode );
+        }
+
+        ASSERT_FALSE( probe->values_.empty() );
+        int reads = 0;
+        for ( auto value : probe->values_ )
+        {
+            EXPECT_EQ( value & 0xFF, value >> 8 );
+            reads += ( value & 0xFF ) != 0;
+        }
+        EXPECT_GT( reads, 10 );
+    }
+}
+
+TEST_F(WhenWorkingWithMemory, everyLaneHasItsOwnMemory)
+{
+    Circuit circuit;
+    circuit.SetLaneCount( 128 );
+    auto probe = buildCircuit( circuit );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+
+        ASSERT_EQ( probe->lanes_.size(), (size_t)width * 2 );
+        for ( int b = 0; b < width; ++b )
+        {
+            EXPECT_EQ( probe->lanes_[b], probe->lanes_[width + b] );
+        }
+    }
+}
+
+TEST_F(WhenWorkingWithMemory, imagesAreLoadedAndDumped)
+{
+    Memory memory( 4, 12 );
+    EXPECT_EQ( memory.GetSize(), 32u );
+    EXPECT_EQ( memory.GetInputCount(), 4 + 12 + 2 );
+    EXPECT_EQ( memory.GetInputName( memory.GetSetInput() ), "set" );
+    EXPECT_EQ( memory.GetOutputName( 11 ), "q11" );
+
+    std::vector<uint8_t> image = { 1, 2, 3, 4 };
+    EXPECT_TRUE( memory.LoadImage( image, 28 ) );
+    EXPECT_FALSE( memory.LoadImage( image, 29 ) );
+    EXPECT_FALSE( memory.LoadImage( image, 100 ) );
+
+    auto dump = memory.Dump();
+    ASSERT_EQ( dump.size(), 32u );
+    EXPECT_THAT( std::vector<uint8_t>( dump.begin() + 26, dump.end() ), testing::ElementsAre( 0, 0, 1, 2, 3, 4 ) );
+    EXPECT_TRUE( memory.Dump( 1 ).empty() );
+
+    ASSERT_TRUE( memory.Dump( path_ ) );
+    Memory copy( 4, 12 );
+    EXPECT_TRUE( copy.LoadImage( path_ ) );
+    EXPECT_EQ( copy.Dump(), dump );
+
+    // too large for the offset, or missing
+    EXPECT_FALSE( copy.LoadImage( path_, 2 ) );
+    EXPECT_FALSE( copy.LoadImage( path_ + ".missing" ) );
+
+    auto clone = std::dynamic_pointer_cast<Memory>( memory.Clone() );
+    ASSERT_NE( clone, nullptr );
+    EXPECT_EQ( clone->Dump(), dump );
+}
+
+TEST_F(WhenWorkingWithMemory, romsOnlyChangeByLoadingAnImage)
+{
+    Circuit circuit;
+    auto driver = std::make_shared<Driver>();
+    auto rom = std::make_shared<Memory>( addressBits, width, true );
+    auto probe = std::make_shared<Probe>( width + addressBits );
+
+    std::vector<uint8_t> image( rom->GetSize() );
+    for ( size_t i = 0; i < image.size(); ++i )
+    {
+        image[i] = (uint8_t)( i * 17 + 5 );
+    }
+    ASSERT_TRUE( rom->LoadImage( image ) );
+
+    circuit.AddComponent( driver );
+    circuit.AddComponent( rom );
+    circuit.AddComponent( probe );
+    for ( int i = 0; i < addressBits + width + 2; ++i )
+    {
+        circuit.ConnectOutToIn( driver, i, rom, i );
+    }
+    for ( int b = 0; b < width; ++b )
+    {
+        circuit.ConnectOutToIn( rom, b, probe, b );
+    }
+    for ( int i = 0; i < addressBits; ++i )
+    {
+        circuit.ConnectOutToIn( driver, i, probe, width + i );
+    }
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    int reads = 0;
+    for ( auto value : probe->values_ )
+    {
+        auto data = value & 0xFF;
+        auto address = value >> width;
+        EXPECT_TRUE( data == 0 || data == image[address] );
+        reads += data != 0;
+    }
+    EXPECT_GT( reads, 10 );
+    EXPECT_EQ( rom->Dump(), image );
+}
+
+TEST_F(WhenWorkingWithMemory, savedStatesIncludeTheMemory)
+{
+    for ( int laneCount : { 0, 128 } )
+    {
+        Circuit circuit;
+        circuit.SetLaneCount( laneCount );
+        auto driver = std::make_shared<Driver>();
+        auto memory = std::make_shared<Memory>( addressBits, width );
+        circuit.AddComponent( driver );
+        circuit.AddComponent( memory );
+        for ( int i = 0; i < addressBits + width + 2; ++i )
+        {
+            circuit.ConnectOutToIn( driver, i, memory, i );
+        }
+
+        auto tick = [&circuit]( int count ) {
+            for ( int i = 0; i < count; ++i )
+            {
+                circuit.Tick( Component::TickMode::Series );
+            }
+        };
+
+        auto dumps = [&memory, laneCount] {
+            std::vector<std::vector<uint8_t>> result;
+            for ( int lane = 0; lane < std::max( laneCount, 1 ); ++lane )
+            {
+                result.emplace_back( memory->Dump( lane ) );
+            }
+            return result;
+        };
+
+        tick( 50 );
+        auto saved = dumps();
+        auto state = circuit.SaveState();
+
+        // write the RAM, by ticking and by loading an image
+        tick( 50 );
+        ASSERT_TRUE( memory->LoadImage( std::vector<uint8_t>( 4, 0xFF ) ) );
+        EXPECT_NE( dumps(), saved );
+
+        ASSERT_TRUE( circuit.RestoreState( state ) );
+        EXPECT_EQ( dumps(), saved ) << "lane count " << laneCount;
+    }
+}
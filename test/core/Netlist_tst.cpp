@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+#include "core/Netlist.h"
+#include "core/SubCircuit.h"
+
+#include "TestCircuits.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Unit tests for Netlist class
+ */
+
+using test::Counter;
+using test::Probe;
+using test::makeFullAdder;
+
+
+class WhenWorkingWithNetlist : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path_ = testing::TempDir() + "scottcpu_Netlist_tst.net";
+    }
+
+    void TearDown() override
+    {
+        std::remove( path_.c_str() );
+    }
+
+    // counter -> 2 full adders -> probe, and a NOT gate feeding itself back into the probe
+    static std::shared_ptr<Probe> buildCircuit( Circuit& circuit )
+    {
+        auto counter = std::make_shared<Counter>();
+        auto fullAdder = makeFullAdder();
+        auto bit0 = fullAdder->Instantiate();
+        auto bit1 = fullAdder->Instantiate();
+        auto notGate = std::make_shared<NotGate>();
+        auto probe = std::make_shared<Probe>();
+
+        circuit.AddComponent( counter );
+        circuit.AddComponent( bit0 );
+        circuit.AddComponent( bit1 );
+        circuit.AddComponent( notGate );
+        circuit.AddComponent( probe );
+
+        circuit.ConnectOutToIn( counter, 0, bit0, 0 );
+        circuit.ConnectOutToIn( counter, 2, bit0, 1 );
+        circuit.ConnectOutToIn( counter, 1, bit1, 0 );
+        circuit.ConnectOutToIn( counter, 3, bit1, 1 );
+        circuit.ConnectOutToIn( bit0, 1, bit1, 2 );
+        circuit.ConnectOutToIn( notGate, 0, notGate, 0 );
+        circuit.ConnectOutToIn( bit0, 0, probe, 0 );
+        circuit.ConnectOutToIn( bit1, 0, probe, 1 );
+        circuit.ConnectOutToIn( bit1, 1, probe, 2 );
+        circuit.ConnectOutToIn( notGate, 0, probe, 3 );
+
+        return probe;
+    }
+
+    std::string read() const
+    {
+        std::ifstream file( path_, std::ios::binary );
+        std::stringstream data;
+        data << file.rdbuf();
+        return data.str();
+    }
+
+    void write( std::string const& data ) const
+    {
+        std::ofstream file( path_, std::ios::binary );
+        file << data;
+    }
+
+    std::string path_;
+};
+
+TEST_F(WhenWorkingWithNetlist, loadedCircuitsTickLikeTheOriginal)
+{
+    Circuit original;
+    auto originalProbe = buildCircuit( original );
+    ASSERT_TRUE( Netlist::Write( original, path_ ) );
+
+    std::vector<std::shared_ptr<Probe>> probes;
+    Netlist netlist;
+    netlist.RegisterType<Counter>();
+    netlist.RegisterType( typeid( Probe ), [&probes] {
+        probes.emplace_back( std::make_shared<Probe>() );
+        return probes.back();
+    } );
+
+    Circuit loaded;
+    ASSERT_TRUE( netlist.Load( path_, loaded ) );
+    ASSERT_EQ( probes.size(), 1u );
+
+    // the full adders are flattened into their gates
+    EXPECT_EQ( loaded.GetComponentCount(), 1 + 2 * 5 + 1 + 1 );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        original.Tick( Component::TickMode::Series );
+        loaded.Tick( Component::TickMode::Series );
+    }
+    for ( int i = 0; i < 16; ++i )
+    {
+        original.Tick( Component::TickMode::Parallel );
+        loaded.Tick( Component::TickMode::Parallel );
+    }
+
+    ASSERT_EQ( originalProbe->values_.size(), 32u );
+    EXPECT_EQ( probes[0]->values_, originalProbe->values_ );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        int a = ( i & 1 ) | ( ( i >> 1 ) & 1 ) << 1;
+        int b = ( ( i >> 2 ) & 1 ) | ( ( i >> 3 ) & 1 ) << 1;
+        EXPECT_EQ( probes[0]->values_[i] & 7, a + b );
+        EXPECT_EQ( probes[0]->values_[i] >> 3, i % 2 == 0 );
+    }
+}
+
+TEST_F(WhenWorkingWithNetlist, loadedFeedbackLoopsTickLikeTheOriginal)
+{
+    // a loop's feedback wire is the one its compile walk reaches last, so depends on the order
+    // in which components were added: small random gate circuits, wired back on themselves
+    uint32_t random = 1;
+    auto next = [&random]( int count ) {
+        random = random * 1103515245 + 12345;
+        return (int)( ( random >> 16 ) % count );
+    };
+
+    for ( int circuitNo = 0; circuitNo < 50; ++circuitNo )
+    {
+        const int gateCount = 6;
+
+        Circuit original;
+        auto counter = std::make_shared<Counter>();
+        auto probe = std::make_shared<Probe>( gateCount );
+        std::vector<std::shared_ptr<Component>> gates;
+        for ( int i = 0; i < gateCount; ++i )
+        {
+            gates.emplace_back( std::make_shared<Gate>( (Gate::Type)( 1 + next( 7 ) ) ) );
+            original.AddComponent( gates.back() );
+        }
+        original.AddComponent( counter );
+        original.AddComponent( probe );
+
+        for ( int i = 0; i < gateCount; ++i )
+        {
+            for ( int input = 0; input < gates[i]->GetInputCount(); ++input )
+            {
+                int from = next( gateCount + 1 );
+                from == gateCount ? original.ConnectOutToIn( counter, next( 4 ), gates[i], input )
+                                  : original.ConnectOutToIn( gates[from], 0, gates[i], input );
+            }
+            original.ConnectOutToIn( gates[i], 0, probe, i );
+        }
+
+        ASSERT_TRUE( Netlist::Write( original, path_ ) );
+
+        std::vector<std::shared_ptr<Probe>> probes;
+        Netlist netlist;
+        netlist.RegisterType<Counter>();
+        netlist.RegisterType( typeid( Probe ), [&probes, gateCount] {
+            probes.emplace_back( std::make_shared<Probe>( gateCount ) );
+            return probes.back();
+        } );
+
+        Circuit loaded;
+        ASSERT_TRUE( netlist.Load( path_, loaded ) );
+        ASSERT_EQ( probes.size(), 1u );
+
+        for ( int i = 0; i < 16; ++i )
+        {
+            original.Tick( Component::TickMode::Series );
+            loaded.Tick( Component::TickMode::Series );
+        }
+        EXPECT_EQ( probes[0]->values_, probe->values_ ) << "circuit " << circuitNo;
+    }
+}
+
+TEST_F(WhenWorkingWithNetlist, optimizedCircuitsAreWrittenWhole)
+{
+    Circuit original;
+    auto originalProbe = buildCircuit( original );
+    original.AddComponent( std::make_shared<AndGate>() );
+    original.SetOptimizeLogic( true );
+    original.SetLutInputCount( 4 );
+    original.Compile();
+    ASSERT_EQ( original.GetDeadGateCount(), 1 );
+    ASSERT_GT( original.GetLutCount(), 0 );
+    ASSERT_TRUE( Netlist::Write( original, path_ ) );
+
+    std::vector<std::shared_ptr<Probe>> probes;
+    Netlist netlist;
+    netlist.RegisterType<Counter>();
+    netlist.RegisterType( typeid( Probe ), [&probes] {
+        probes.emplace_back( std::make_shared<Probe>() );
+        return probes.back();
+    } );
+
+    Circuit loaded;
+    ASSERT_TRUE( netlist.Load( path_, loaded ) );
+    ASSERT_EQ( probes.size(), 1u );
+    EXPECT_EQ( loaded.GetComponentCount(), 1 + 2 * 5 + 1 + 1 + 1 );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        original.Tick( Component::TickMode::Series );
+        loaded.Tick( Component::TickMode::Series );
+    }
+    EXPECT_EQ( probes[0]->values_, originalProbe->values_ );
+}
+
+TEST_F(WhenWorkingWithNetlist, loadingAppendsToACircuit)
+{
+    Circuit original;
+    buildCircuit( original );
+    ASSERT_TRUE( Netlist::Write( original, path_ ) );
+
+    Netlist netlist;
+    netlist.RegisterType<Counter>();
+    netlist.RegisterType<Probe>();
+
+    Circuit loaded;
+    loaded.SetBufferCount( 3 );
+    loaded.AddComponent( std::make_shared<Counter>() );
+    ASSERT_TRUE( netlist.Load( path_, loaded ) );
+    ASSERT_TRUE( netlist.Load( path_, loaded ) );
+    EXPECT_EQ( loaded.GetComponentCount(), 1 + 2 * 13 );
+
+    for ( int i = 0; i < 8; ++i )
+    {
+        loaded.Tick( Component::TickMode::Parallel );
+        loaded.Tick( Component::TickMode::Series );
+    }
+}
+
+TEST_F(WhenWorkingWithNetlist, unregisteredTypesAreNotLoaded)
+{
+    Circuit original;
+    buildCircuit( original );
+    ASSERT_TRUE( Netlist::Write( original, path_ ) );
+
+    Netlist netlist;
+    netlist.RegisterType<Counter>();
+
+    Circuit loaded;
+    EXPECT_FALSE( netlist.Load( path_, loaded ) );
+    EXPECT_EQ( loaded.GetComponentCount(), 0 );
+
+    // nor are types whose factory creates something else
+    netlist.RegisterType( typeid( Probe ), [] { return std::make_shared<Counter>(); } );
+    EXPECT_FALSE( netlist.Load( path_, loaded ) );
+    EXPECT_EQ( loaded.GetComponentCount(), 0 );
+}
+
+TEST_F(WhenWorkingWithNetlist, invalidFilesAreNotLoaded)
+{
+    Netlist netlist;
+    netlist.RegisterType<Counter>();
+    netlist.RegisterType<Probe>();
+
+    Circuit loaded;
+    EXPECT_FALSE( netlist.Load( path_ + ".missing", loaded ) );
+
+    Circuit original;
+    buildCircuit( original );
+    ASSERT_TRUE( Netlist::Write( original, path_ ) );
+    auto data = read();
+
+    // truncated
+    for ( size_t size : { (size_t)0, (size_t)16, data.size() / 2, data.size() - 8 } )
+    {
+        write( data.substr( 0, size ) );
+        EXPECT_FALSE( netlist.Load( path_, loaded ) );
+    }
+
+    // wrong magic
+    auto corrupt = data;
+    corrupt[0] = 'X';
+    write( corrupt );
+    EXPECT_FALSE( netlist.Load( path_, loaded ) );
+
+    // the last wire, just before the type names, corrupted
+    corrupt = data;
+    auto names = std::string( typeid( Counter ).name() );
+    auto wireEnd = corrupt.find( names.substr( 0, 8 ) );
+    ASSERT_NE( wireEnd, std::string::npos );
+    for ( size_t i = wireEnd - 12; i < wireEnd; ++i )
+    {
+        corrupt[i] = '\xff';
+    }
+    write( corrupt );
+    EXPECT_FALSE( netlist.Load( path_, loaded ) );
+
+    EXPECT_EQ( loaded.GetComponentCount(), 0 );
+
+    write( data );
+    EXPECT_TRUE( netlist.Load( path_, loaded ) );
+}
@@ -58,7 +58,7 @@ protected:
 
     void checkSignalEnabled(const std::shared_ptr<SignalBus>& signalBus, int signalCount)
     {
-        onebit* ptrBit = signalBus->GetValue(signalCount);
+        onebit const* ptrBit = signalBus->GetValue(signalCount);
         ASSERT_EQ(ptrBit->value, 1);
     }
 
@@ -75,8 +75,11 @@ TEST_F(WhenWorkingWithSignalBus, getInvalidSignal)
 {
     initialize(signalBus_, 8);
 
-    std::shared_ptr<Signal> s = signalBus_->GetSignal(8);
-    EXPECT_EQ(s, nullptr);
+    onebit b;
+    b.value = 1;
+    EXPECT_FALSE(signalBus_->SetValue(8, b));
+    EXPECT_FALSE(signalBus_->HasValue(8));
+    EXPECT_EQ(signalBus_->GetValue(8), nullptr);
 }
 
 TEST_F(WhenWorkingWithSignalBus, aGivenSignalHasAValue) 
@@ -88,9 +91,7 @@ TEST_F(WhenWorkingWithSignalBus, aGivenSignalHasAValue)
     EXPECT_FALSE(signalBus_->HasValue(0));
 
     // Arrange
-    std::shared_ptr<Signal> s0 = signalBus_->GetSignal(0);
-    EXPECT_NE(s0, nullptr);
-    enableSignal(s0);
+    enableSignal(signalBus_, 0);
 
     // Act & Assert
     EXPECT_TRUE(signalBus_->HasValue(0));
@@ -114,7 +115,7 @@ TEST_F(WhenWorkingWithSignalBus, GetAnUnassignedSingleSignal)
 
     int signalIndex = 1;
 
-    onebit* pBit = signalBus_->GetValue(signalIndex);
+    onebit const* pBit = signalBus_->GetValue(signalIndex);
     EXPECT_EQ(pBit, nullptr);
 }
 
@@ -147,6 +148,70 @@ TEST_F(WhenWorkingWithSignalBus, MoveASingleSignal_HappyPath)
     EXPECT_FALSE(fromSignal->HasValue());
 }
 
+TEST_F(WhenWorkingWithSignalBus, CopyBetweenBuses_HappyPath) 
+{
+    initialize(signalBus_, 70);
+
+    SignalBus toBus;
+    toBus.SetSignalCount(70);
+
+    enableSignal(signalBus_, 65);
+
+    EXPECT_TRUE(toBus.CopySignal(3, *signalBus_, 65));
+    EXPECT_TRUE(toBus.HasValue(3));
+    EXPECT_EQ(toBus.GetValue(3)->value, 1);
+    EXPECT_TRUE(signalBus_->HasValue(65));
+
+    EXPECT_TRUE(toBus.MoveSignal(66, *signalBus_, 65));
+    EXPECT_EQ(toBus.GetValue(66)->value, 1);
+    EXPECT_FALSE(signalBus_->HasValue(65));
+
+    // nothing to copy from a signal without a value
+    EXPECT_FALSE(toBus.CopySignal(4, *signalBus_, 65));
+    EXPECT_FALSE(toBus.HasValue(4));
+}
+
+TEST_F(WhenWorkingWithSignalBus, SetGetLanes_HappyPath) 
+{
+    initialize(signalBus_, 8);
+
+    uint64_t lanes[2] = { 0x0123456789ABCDEF, 0xFEDCBA9876543210 };
+
+    // lanes are disabled by default
+    EXPECT_FALSE(signalBus_->SetLanes(1, lanes));
+
+    signalBus_->SetLaneCount(100);
+    EXPECT_EQ(signalBus_->GetLaneCount(), 128);
+    EXPECT_EQ(signalBus_->GetLaneWordCount(), 2);
+
+    EXPECT_EQ(signalBus_->GetLanes(1), nullptr);
+    EXPECT_TRUE(signalBus_->SetLanes(1, lanes));
+    EXPECT_TRUE(signalBus_->HasValue(1));
+    EXPECT_EQ(signalBus_->GetLanes(1)[0], lanes[0]);
+    EXPECT_EQ(signalBus_->GetLanes(1)[1], lanes[1]);
+
+    // the onebit value follows lane 0
+    ASSERT_NE(signalBus_->GetValue(1), nullptr);
+    EXPECT_EQ(signalBus_->GetValue(1)->value, 1);
+    EXPECT_EQ(signalBus_->GetValueWords()[0] & 2, 2u);
+    uint64_t evenLanes[2] = { 0xAAAAAAAAAAAAAAAA, 0x5555555555555555 };
+    onebit one;
+    one.value = 1;
+    EXPECT_TRUE(signalBus_->SetValue(2, one));
+    EXPECT_TRUE(signalBus_->SetLanes(2, evenLanes));
+    EXPECT_EQ(signalBus_->GetValue(2)->value, 0);
+    EXPECT_EQ(signalBus_->GetValueWords()[0] & 4, 0u);
+
+    SignalBus toBus;
+    toBus.SetSignalCount(8);
+    toBus.SetLaneCount(128);
+    EXPECT_TRUE(toBus.CopySignal(7, *signalBus_, 1));
+    EXPECT_EQ(toBus.GetLanes(7)[1], lanes[1]);
+
+    signalBus_->ClearAllValues();
+    EXPECT_EQ(signalBus_->GetLanes(1), nullptr);
+}
+
 TEST_F(WhenWorkingWithSignalBus, ClearAllValues) 
 {
     initialize(signalBus_, 8);
@@ -159,3 +224,60 @@ TEST_F(WhenWorkingWithSignalBus, ClearAllValues)
 }
     
     
+
+TEST_F(WhenWorkingWithSignalBus, SetGetWords_HappyPath) 
+{
+    initialize(signalBus_, 70);
+
+    EXPECT_EQ(signalBus_->GetWord(65), nullptr);
+    EXPECT_FALSE(signalBus_->SetWord(70, 0xAB));
+
+    EXPECT_TRUE(signalBus_->SetWord(65, 0xAB));
+    EXPECT_TRUE(signalBus_->IsWord(65));
+    EXPECT_EQ(*signalBus_->GetWord(65), 0xABu);
+    EXPECT_EQ(signalBus_->GetValue(65)->value, 1);
+
+    // a onebit signal reads as the word 0 or 1, and setting one replaces a word
+    enableSignal(signalBus_, 2);
+    EXPECT_FALSE(signalBus_->IsWord(2));
+    EXPECT_EQ(*signalBus_->GetWord(2), 1u);
+
+    onebit bit;
+    bit.value = 0;
+    EXPECT_TRUE(signalBus_->SetValue(65, bit));
+    EXPECT_FALSE(signalBus_->IsWord(65));
+    EXPECT_EQ(*signalBus_->GetWord(65), 0u);
+}
+
+TEST_F(WhenWorkingWithSignalBus, CopyWordsBetweenBuses_HappyPath) 
+{
+    initialize(signalBus_, 70);
+
+    SignalBus toBus;
+    toBus.SetSignalCount(70);
+
+    EXPECT_TRUE(signalBus_->SetWord(65, 0x1234));
+    EXPECT_TRUE(toBus.CopySignal(3, *signalBus_, 65));
+    EXPECT_EQ(*toBus.GetWord(3), 0x1234u);
+
+    // updates only report a change if the word differs
+    EXPECT_FALSE(toBus.UpdateSignal(3, *signalBus_, 65));
+    EXPECT_TRUE(signalBus_->SetWord(65, 0x1235));
+    EXPECT_TRUE(toBus.UpdateSignal(3, *signalBus_, 65));
+    EXPECT_EQ(*toBus.GetWord(3), 0x1235u);
+
+    EXPECT_TRUE(toBus.MoveSignal(66, *signalBus_, 65));
+    EXPECT_EQ(*toBus.GetWord(66), 0x1235u);
+    EXPECT_FALSE(signalBus_->HasValue(65));
+
+    std::shared_ptr<Signal> signal = std::make_shared<Signal>();
+    signal->SetWord(0xFFFFFFFFFFFFFFFF);
+    EXPECT_TRUE(toBus.CopySignal(4, signal));
+    EXPECT_EQ(*toBus.GetWord(4), 0xFFFFFFFFFFFFFFFFu);
+
+    // words beyond a shrunk signal count are dropped
+    toBus.SetSignalCount(4);
+    toBus.SetSignalCount(70);
+    EXPECT_EQ(toBus.GetWord(4), nullptr);
+    EXPECT_EQ(*toBus.GetWord(3), 0x1235u);
+}
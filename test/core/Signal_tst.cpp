@@ -149,4 +149,27 @@ TEST_F(WhenWorkingWithSignal, moveFromAnEnabledSignalToASignalWithValue)
     checkSignalEnabled(signal_);
     ASSERT_TRUE(signal_->HasValue());
     ASSERT_FALSE(fromSignal->HasValue());
-}
\ No newline at end of file
+}
+TEST_F(WhenWorkingWithSignal, copyAndMoveAWord) 
+{
+    // Arrange
+    std::shared_ptr<Signal> fromSignal = std::make_shared<Signal>();
+    fromSignal->SetWord(0xBEEF);
+    ASSERT_TRUE(fromSignal->IsWord());
+    ASSERT_EQ(fromSignal->GetValue()->value, 1);
+
+    // Act
+    EXPECT_TRUE(signal_->CopySignal(fromSignal));
+    std::shared_ptr<Signal> s = std::make_shared<Signal>();
+    EXPECT_TRUE(s->MoveSignal(fromSignal));
+
+    // Assert
+    EXPECT_EQ(*signal_->GetWord(), 0xBEEFu);
+    EXPECT_EQ(*s->GetWord(), 0xBEEFu);
+    ASSERT_EQ(fromSignal->GetWord(), nullptr);
+
+    // setting a onebit value replaces the word
+    enableSignal(s);
+    EXPECT_FALSE(s->IsWord());
+    EXPECT_EQ(*s->GetWord(), 1u);
+}
@@ -0,0 +1,243 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+#include "core/SubCircuit.h"
+
+#include "TestCircuits.h"
+
+#include <algorithm>
+
+/**
+ * @brief Unit tests for SubCircuit class
+ */
+
+using test::Counter;
+using test::Probe;
+using test::makeFullAdder;
+
+
+class WhenWorkingWithSubCircuit : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    // a 2-bit ripple-carry adder built from 2 full adder instances
+    static std::shared_ptr<SubCircuit> makeAdder2( SubCircuit const& fullAdder )
+    {
+        auto adder = std::make_shared<SubCircuit>( std::vector<std::string>{ "a0", "a1", "b0", "b1" },
+                                                   std::vector<std::string>{ "s0", "s1", "cout" } );
+
+        auto bit0 = fullAdder.Instantiate();
+        auto bit1 = fullAdder.Instantiate();
+        adder->AddComponent( bit0 );
+        adder->AddComponent( bit1 );
+
+        adder->ConnectInToIn( "a0", bit0, 0 );
+        adder->ConnectInToIn( "b0", bit0, 1 );
+        adder->ConnectInToIn( "a1", bit1, 0 );
+        adder->ConnectInToIn( "b1", bit1, 1 );
+        adder->ConnectOutToIn( bit0, 1, bit1, 2 );
+        adder->ConnectOutToOut( bit0, 0, "s0" );
+        adder->ConnectOutToOut( bit1, 0, "s1" );
+        adder->ConnectOutToOut( bit1, 1, "cout" );
+
+        return adder;
+    }
+
+    // counter -> 2-bit adder -> probe, where a is counter bits 0-1, and b bits 2-3
+    void build( Circuit& circuit )
+    {
+        counter_ = std::make_shared<Counter>();
+        adder_ = makeAdder2( *makeFullAdder() );
+        probe_ = std::make_shared<Probe>( 3 );
+
+        circuit.AddComponent( counter_ );
+        circuit.AddComponent( adder_ );
+        circuit.AddComponent( probe_ );
+
+        for ( int i = 0; i < 4; ++i )
+        {
+            circuit.ConnectOutToIn( counter_, i, adder_, i );
+        }
+        for ( int i = 0; i < 3; ++i )
+        {
+            circuit.ConnectOutToIn( adder_, i, probe_, i );
+        }
+    }
+
+    static std::vector<uint64_t> expectedSums( int tickCount )
+    {
+        std::vector<uint64_t> sums;
+        for ( int count = 0; count < tickCount; ++count )
+        {
+            sums.push_back( ( ( count & 3 ) + ( ( count >> 2 ) & 3 ) ) );
+        }
+        return sums;
+    }
+
+    std::shared_ptr<Counter> counter_;
+    std::shared_ptr<SubCircuit> adder_;
+    std::shared_ptr<Probe> probe_;
+};
+
+TEST_F(WhenWorkingWithSubCircuit, portsCanBeFoundByName)
+{
+    auto adder = makeFullAdder();
+
+    EXPECT_EQ( adder->GetInputCount(), 3 );
+    EXPECT_EQ( adder->GetOutputCount(), 2 );
+    EXPECT_EQ( adder->FindInput( "cin" ), 2 );
+    EXPECT_EQ( adder->FindOutput( "cout" ), 1 );
+    EXPECT_EQ( adder->FindInput( "cout" ), -1 );
+    EXPECT_EQ( adder->GetInputName( 1 ), "b" );
+
+    EXPECT_FALSE( adder->ConnectInToIn( "x", std::make_shared<NotGate>(), 0 ) );  // unknown port and component
+}
+
+TEST_F(WhenWorkingWithSubCircuit, compiledCircuitFlattensSubCircuits)
+{
+    Circuit circuit;
+    build( circuit );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    EXPECT_EQ( probe_->values_, expectedSums( 16 ) );
+
+    // counter, then both adders' input gates, bit 0's carry (and -> or), bit 1's carry (and -> or),
+    // then the probe
+    EXPECT_EQ( circuit.GetLevelCount(), 7 );
+}
+
+TEST_F(WhenWorkingWithSubCircuit, uncompiledTickMatchesCompiledTick)
+{
+    for ( int bufferCount : { 0, 3 } )
+    {
+        Circuit circuit;
+        circuit.SetBufferCount( bufferCount );
+        build( circuit );
+
+        for ( int i = 0; i < 16; ++i )
+        {
+            circuit.Tick( Component::TickMode::Parallel );
+        }
+        circuit.SetBufferCount( 0 );
+
+        EXPECT_EQ( probe_->values_, expectedSums( 16 ) ) << "buffer count " << bufferCount;
+    }
+}
+
+TEST_F(WhenWorkingWithSubCircuit, eventDrivenAndMultiBufferedTicksMatch)
+{
+    Circuit circuit;
+    build( circuit );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::EventDriven );
+    }
+
+    // the probe only processes when the sum changes
+    auto sums = expectedSums( 16 );
+    sums.erase( std::unique( sums.begin(), sums.end() ), sums.end() );
+    EXPECT_EQ( probe_->values_, sums );
+
+    Circuit bufferedCircuit;
+    bufferedCircuit.SetBufferCount( 3 );
+    build( bufferedCircuit );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        bufferedCircuit.Tick( Component::TickMode::Series );
+    }
+    bufferedCircuit.SetBufferCount( 0 );
+
+    EXPECT_EQ( probe_->values_, expectedSums( 16 ) );
+}
+
+TEST_F(WhenWorkingWithSubCircuit, instancesAreIndependentCopies)
+{
+    auto fullAdder = makeFullAdder();
+    auto instance = fullAdder->Instantiate();
+
+    ASSERT_NE( instance, nullptr );
+    EXPECT_NE( instance, fullAdder );
+    EXPECT_EQ( instance->GetComponentCount(), fullAdder->GetComponentCount() );
+    EXPECT_EQ( instance->FindOutput( "sum" ), 0 );
+
+    // instances of instances share the same wiring
+    auto adder = makeAdder2( *instance );
+    auto copy = adder->Instantiate();
+    ASSERT_NE( copy, nullptr );
+
+    Circuit circuit;
+    auto counter = std::make_shared<Counter>();
+    auto probe = std::make_shared<Probe>( 3 );
+    circuit.AddComponent( counter );
+    circuit.AddComponent( copy );
+    circuit.AddComponent( probe );
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit.ConnectOutToIn( counter, i, copy, i );
+    }
+    for ( int i = 0; i < 3; ++i )
+    {
+        circuit.ConnectOutToIn( copy, i, probe, i );
+    }
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    EXPECT_EQ( probe->values_, expectedSums( 16 ) );
+
+    // user-defined components can't be copied unless they override Clone()
+    auto subCircuit = std::make_shared<SubCircuit>( std::vector<std::string>{}, std::vector<std::string>{ "out" } );
+    subCircuit->AddComponent( std::make_shared<Counter>() );
+    EXPECT_EQ( subCircuit->Instantiate(), nullptr );
+}
+
+TEST_F(WhenWorkingWithSubCircuit, statsListComponentsInsideSubCircuits)
+{
+    Circuit circuit;
+    build( circuit );
+
+    for ( int i = 0; i < 16; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+
+    // counter, 2-bit adder, full adder 0 and its 5 gates, full adder 1 and its 5 gates, probe
+    auto stats = circuit.GetStats();
+    ASSERT_EQ( stats.components.size(), 15u );
+    EXPECT_EQ( stats.components[1].component, adder_ );
+    EXPECT_EQ( stats.components[2].componentIndex, 1 );
+    EXPECT_EQ( stats.components[13].componentIndex, 1 );
+    EXPECT_EQ( stats.components[14].component, probe_ );
+    EXPECT_EQ( stats.components[14].componentIndex, 2 );
+
+    // flattened sub-circuits aren't processed themselves, but the gates inside them are
+    EXPECT_EQ( stats.components[1].total.tickCount, 0 );
+    EXPECT_EQ( stats.components[3].total.tickCount, stats.enabled ? 16 : 0 );
+    EXPECT_EQ( stats.components[14].total.tickCount, stats.enabled ? 16 : 0 );
+}
@@ -0,0 +1,96 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/internal/SyncFlag.h"
+
+#include <thread>
+
+/**
+ * @brief Unit tests for SyncFlag class
+ */
+
+
+class WhenWorkingWithSyncFlag : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    // bounces between two threads via a pair of flags, returning the number of round trips
+    static int pingPong( Circuit::SyncPolicy policy, int roundTrips )
+    {
+        internal::SyncFlag ping, pong;
+        ping.SetPolicy( policy );
+        pong.SetPolicy( policy );
+
+        int count = 0;
+        std::thread thread( [&] {
+            for ( int i = 0; i < roundTrips; ++i )
+            {
+                ping.Wait();
+                ping.Clear();
+                ++count;
+                pong.Set();
+            }
+        } );
+
+        for ( int i = 0; i < roundTrips; ++i )
+        {
+            ping.Set();
+            pong.Wait();
+            pong.Clear();
+        }
+
+        thread.join();
+        return count;
+    }
+};
+
+TEST_F(WhenWorkingWithSyncFlag, flagStaysSetUntilCleared)
+{
+    internal::SyncFlag flag( true );
+    EXPECT_TRUE( flag.IsSet() );
+    EXPECT_EQ( flag.GetPolicy(), Circuit::SyncPolicy::Blocking );
+
+    flag.Wait();
+    EXPECT_TRUE( flag.IsSet() );
+
+    flag.Clear();
+    EXPECT_FALSE( flag.IsSet() );
+}
+
+TEST_F(WhenWorkingWithSyncFlag, everyPolicyHandsOver)
+{
+    EXPECT_EQ( pingPong( Circuit::SyncPolicy::Blocking, 100 ), 100 );
+    EXPECT_EQ( pingPong( Circuit::SyncPolicy::Adaptive, 100 ), 100 );
+    EXPECT_EQ( pingPong( Circuit::SyncPolicy::BusyPoll, 10 ), 10 );
+}
+
+TEST_F(WhenWorkingWithSyncFlag, policyCanChangeWhileWaiting)
+{
+    internal::SyncFlag flag;
+
+    std::thread thread( [&flag] { flag.Wait(); } );
+
+    // the waiting thread may already be asleep on a condition variable
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    flag.SetPolicy( Circuit::SyncPolicy::Adaptive );
+    flag.Set();
+
+    thread.join();
+    EXPECT_TRUE( flag.IsSet() );
+}
@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#pragma once
+
+#include "core/Component.h"
+#include "core/Gate.h"
+#include "core/SubCircuit.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Components and circuits shared by the unit tests
+ *
+ * A Counter drives a circuit's inputs with the bits of a count that increments
+ * every tick (in bit-parallel mode, each lane with the bits of its own index), 
+ * and a Probe records its inputs on every tick, so that a test can compare what
+ * two circuits, or two ways of ticking one circuit, produce.
+ */
+
+namespace test
+{
+
+// outputs the bits of a counter that increments every tick, or in bit-parallel mode, the bits of
+// each lane's index
+class Counter final : public Component
+{
+public:
+    Counter( int bitCount = 4 )
+        : bitCount_( bitCount )
+    {
+        SetOutputCount( bitCount );
+    }
+
+protected:
+    virtual void Process( SignalBus const&, SignalBus& outputs ) override
+    {
+        for ( int i = 0; i < bitCount_; ++i )
+        {
+            onebit bit;
+            bit.value = ( count_ >> i ) & 1;
+            outputs.SetValue( i, bit );
+        }
+        ++count_;
+    }
+
+    virtual void ProcessLanes( SignalBus const&, SignalBus& outputs ) override
+    {
+        lanes_.resize( outputs.GetLaneWordCount() );
+        for ( int i = 0; i < bitCount_; ++i )
+        {
+            for ( size_t word = 0; word < lanes_.size(); ++word )
+            {
+                lanes_[word] = 0;
+                for ( int lane = 0; lane < 64; ++lane )
+                {
+                    lanes_[word] |= uint64_t( ( ( word * 64 + lane ) >> i ) & 1 ) << lane;
+                }
+            }
+            outputs.SetLanes( i, lanes_.data() );
+        }
+    }
+
+private:
+    const int bitCount_;
+    int count_ = 0;
+    std::vector<uint64_t> lanes_;
+};
+
+// records its inputs as an integer on every tick, or in bit-parallel mode, the lanes of each input
+class Probe final : public Component
+{
+public:
+    Probe( int inputCount = 4 )
+    {
+        SetInputCount( inputCount );
+    }
+
+    std::vector<uint64_t> values_;
+    std::vector<std::vector<uint64_t>> lanes_;
+
+protected:
+    virtual void Process( SignalBus const& inputs, SignalBus& ) override
+    {
+        uint64_t value = 0;
+        for ( int i = 0; i < GetInputCount(); ++i )
+        {
+            auto bit = inputs.GetValue( i );
+            value |= uint64_t( bit != nullptr && bit->value ) << i;
+        }
+        values_.push_back( value );
+    }
+
+    virtual void ProcessLanes( SignalBus const& inputs, SignalBus& ) override
+    {
+        lanes_.resize( GetInputCount() );
+        for ( int i = 0; i < GetInputCount(); ++i )
+        {
+            auto lanes = inputs.GetLanes( i );
+            lanes_[i].assign( lanes, lanes + inputs.GetLaneWordCount() );
+        }
+    }
+};
+
+// sum = a ^ b ^ cin, cout = ( a & b ) | ( cin & ( a ^ b ) )
+inline std::shared_ptr<SubCircuit> makeFullAdder()
+{
+    auto adder = std::make_shared<SubCircuit>( std::vector<std::string>{ "a", "b", "cin" },
+                                               std::vector<std::string>{ "sum", "cout" } );
+
+    auto xor0 = std::make_shared<XorGate>();
+    auto xor1 = std::make_shared<XorGate>();
+    auto and0 = std::make_shared<AndGate>();
+    auto and1 = std::make_shared<AndGate>();
+    auto or0 = std::make_shared<OrGate>();
+
+    for ( auto gate : std::vector<std::shared_ptr<Component>>{ xor0, xor1, and0, and1, or0 } )
+    {
+        adder->AddComponent( gate );
+    }
+
+    adder->ConnectInToIn( "a", xor0, 0 );
+    adder->ConnectInToIn( "b", xor0, 1 );
+    adder->ConnectInToIn( "a", and0, 0 );
+    adder->ConnectInToIn( "b", and0, 1 );
+    adder->ConnectOutToIn( xor0, 0, xor1, 0 );
+    adder->ConnectInToIn( "cin", xor1, 1 );
+    adder->ConnectOutToIn( xor0, 0, and1, 0 );
+    adder->ConnectInToIn( "cin", and1, 1 );
+    adder->ConnectOutToIn( and0, 0, or0, 0 );
+    adder->ConnectOutToIn( and1, 0, or0, 1 );
+    adder->ConnectOutToOut( xor1, 0, "sum" );
+    adder->ConnectOutToOut( or0, 0, "cout" );
+
+    return adder;
+}
+
+}  // namespace test
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/internal/ThreadPool.h"
+
+/**
+ * @brief Unit tests for ThreadPool class
+ */
+
+
+class WhenWorkingWithThreadPool : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    // blocks until count_ reaches the given value
+    void waitForCount( int count )
+    {
+        std::unique_lock<std::mutex> lock( mutex_ );
+        condt_.wait( lock, [this, count] { return count_ == count; } );
+    }
+
+    void increment()
+    {
+        std::lock_guard<std::mutex> lock( mutex_ );
+        ++count_;
+        condt_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable condt_;
+    int count_ = 0;
+};
+
+TEST_F(WhenWorkingWithThreadPool, defaultPoolHasAThreadPerCore)
+{
+    EXPECT_EQ( internal::ThreadPool::GetDefault().GetThreadCount(), (int)std::max( 1u, std::thread::hardware_concurrency() ) );
+    EXPECT_EQ( internal::ThreadPool( 0 ).GetThreadCount(), 1 );
+}
+
+TEST_F(WhenWorkingWithThreadPool, runsEverySubmittedTask)
+{
+    // tasks must outlive the pool's threads
+    std::vector<internal::ThreadPool::Task> innerTasks( 100, [this] { increment(); } );
+    std::vector<internal::ThreadPool::Task> outerTasks;
+
+    internal::ThreadPool pool( 4 );
+
+    // each outer task submits an inner task from within the pool
+    for ( auto& innerTask : innerTasks )
+    {
+        outerTasks.emplace_back( [this, &pool, &innerTask] {
+            pool.Submit( &innerTask );
+            increment();
+        } );
+    }
+
+    for ( auto& outerTask : outerTasks )
+    {
+        pool.Submit( &outerTask );
+    }
+
+    waitForCount( 200 );
+    EXPECT_EQ( count_, 200 );
+}
@@ -0,0 +1,238 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+#include "core/SubCircuit.h"
+
+#include "TestCircuits.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief Tests that ticking a circuit does not allocate memory once warmed up
+ */
+
+using test::Counter;
+using test::Probe;
+using test::makeFullAdder;
+
+namespace
+{
+
+// counts every heap allocation made by any thread while counting is enabled
+std::atomic<bool> countingAllocations( false );
+std::atomic<int> allocationCount( 0 );
+
+void* countedAlloc( std::size_t size )
+{
+    if ( countingAllocations.load( std::memory_order_relaxed ) )
+    {
+        ++allocationCount;
+    }
+
+    if ( auto ptr = std::malloc( size == 0 ? 1 : size ) )
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+void* operator new( std::size_t size )
+{
+    return countedAlloc( size );
+}
+
+void* operator new[]( std::size_t size )
+{
+    return countedAlloc( size );
+}
+
+void operator delete( void* ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void* ptr ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete( void* ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+void operator delete[]( void* ptr, std::size_t ) noexcept
+{
+    std::free( ptr );
+}
+
+class WhenTickingACircuit : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        circuit_ = std::make_shared<Circuit>();
+        build();
+
+        // so that recording doesn't allocate while ticking
+        probe_->values_.reserve( 1 << 20 );
+    }
+
+    void TearDown() override
+    {
+        circuit_->SetBufferCount( 0 );
+    }
+
+    // counter -> 2-bit ripple-carry adder -> probe, with the carry out fed back into the first
+    // carry in through a NOT gate
+    void build()
+    {
+        counter_ = std::make_shared<Counter>();
+        probe_ = std::make_shared<Probe>( 3 );
+
+        auto bit0 = makeFullAdder();
+        auto bit1 = bit0->Instantiate();
+        auto notGate = std::make_shared<NotGate>();
+
+        circuit_->AddComponent( counter_ );
+        circuit_->AddComponent( bit0 );
+        circuit_->AddComponent( bit1 );
+        circuit_->AddComponent( notGate );
+        circuit_->AddComponent( probe_ );
+
+        circuit_->ConnectOutToIn( counter_, 0, bit0, 0 );
+        circuit_->ConnectOutToIn( counter_, 2, bit0, 1 );
+        circuit_->ConnectOutToIn( counter_, 1, bit1, 0 );
+        circuit_->ConnectOutToIn( counter_, 3, bit1, 1 );
+        circuit_->ConnectOutToIn( bit0, 1, bit1, 2 );
+        circuit_->ConnectOutToIn( bit1, 1, notGate, 0 );
+        circuit_->ConnectOutToIn( notGate, 0, bit0, 2 );
+        circuit_->ConnectOutToIn( bit0, 0, probe_, 0 );
+        circuit_->ConnectOutToIn( bit1, 0, probe_, 1 );
+        circuit_->ConnectOutToIn( bit1, 1, probe_, 2 );
+    }
+
+    // returns the number of allocations made by tickCount ticks, after a few warm-up ticks
+    int countTickAllocations( Component::TickMode mode, int tickCount = 1000 )
+    {
+        for ( int i = 0; i < 16; ++i )
+        {
+            circuit_->Tick( mode );
+        }
+
+        allocationCount = 0;
+        countingAllocations = true;
+        for ( int i = 0; i < tickCount; ++i )
+        {
+            circuit_->Tick( mode );
+        }
+        countingAllocations = false;
+
+        return allocationCount;
+    }
+
+    std::shared_ptr<Circuit> circuit_;
+    std::shared_ptr<Counter> counter_;
+    std::shared_ptr<Probe> probe_;
+};
+
+TEST_F(WhenTickingACircuit, allocationsAreCounted)
+{
+    countingAllocations = true;
+    allocationCount = 0;
+    auto bus = std::unique_ptr<SignalBus>( new SignalBus() );
+    countingAllocations = false;
+
+    EXPECT_GE( allocationCount, 1 );
+}
+
+TEST_F(WhenTickingACircuit, steadyStateTicksDoNotAllocate)
+{
+    for ( int bufferCount : { 0, 3 } )
+    {
+        circuit_->SetBufferCount( bufferCount );
+
+        for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+        {
+            EXPECT_EQ( countTickAllocations( mode ), 0 ) << "buffer count " << bufferCount << ", tick mode " << (int)mode;
+        }
+    }
+
+    EXPECT_THAT( probe_->values_, testing::Contains( testing::Gt( 0 ) ) );
+}
+
+TEST_F(WhenTickingACircuit, bitParallelTicksDoNotAllocate)
+{
+    circuit_->SetLaneCount( 128 );
+
+    EXPECT_EQ( countTickAllocations( Component::TickMode::Series ), 0 );
+    EXPECT_EQ( countTickAllocations( Component::TickMode::Parallel ), 0 );
+}
+
+TEST_F(WhenTickingACircuit, uncompiledTicksDoNotAllocate)
+{
+    // a sub-circuit ticked directly (rather than flattened into a compiled circuit) ticks its own
+    // components in series
+    auto adder = makeFullAdder();
+    for ( int i = 0; i < 16; ++i )
+    {
+        adder->Tick( Component::TickMode::Series );
+        adder->Reset();
+    }
+
+    allocationCount = 0;
+    countingAllocations = true;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        adder->Tick( Component::TickMode::Series );
+        adder->Reset();
+    }
+    countingAllocations = false;
+
+    EXPECT_EQ( allocationCount, 0 );
+}
+
+TEST_F(WhenTickingACircuit, multiClusterTicksDoNotAllocate)
+{
+    // a 128-bit ripple-carry adder (640 gates) is too large for a single cluster, so Parallel ticks
+    // run its clusters as tasks
+    circuit_->RemoveAllComponents();
+    circuit_->AddComponent( counter_ );
+    circuit_->AddComponent( probe_ );
+
+    auto adder = makeFullAdder();
+    std::shared_ptr<Component> carry = counter_;
+    int carryOutput = 2;
+    for ( int i = 0; i < 128; ++i )
+    {
+        auto bit = adder->Instantiate();
+        circuit_->AddComponent( bit );
+        circuit_->ConnectOutToIn( counter_, i % 2, bit, 0 );
+        circuit_->ConnectOutToIn( counter_, 3, bit, 1 );
+        circuit_->ConnectOutToIn( carry, carryOutput, bit, 2 );
+        carry = bit;
+        carryOutput = 1;
+    }
+    circuit_->ConnectOutToIn( carry, 1, probe_, 0 );
+
+    circuit_->Compile();
+    ASSERT_GT( circuit_->GetClusterCount(), 1 );
+
+    EXPECT_EQ( countTickAllocations( Component::TickMode::Parallel ), 0 );
+    EXPECT_THAT( probe_->values_, testing::Contains( testing::Gt( 0 ) ) );
+}
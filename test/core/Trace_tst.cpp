@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Trace.h"
+
+#include <sstream>
+
+/**
+ * @brief Unit tests for Trace class
+ */
+
+
+class WhenWorkingWithTrace : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+        Trace::Stop();
+    }
+
+    class Inverter : public Component
+    {
+    public:
+        Inverter()
+        {
+            SetInputCount(1);
+            SetOutputCount(1);
+        }
+
+    protected:
+        virtual void Process( SignalBus const& inputs, SignalBus& outputs ) override
+        {
+            auto in = inputs.GetValue( 0 );
+            onebit out;
+            out.value = in == nullptr || !in->value;
+            outputs.SetValue( 0, out );
+        }
+    };
+
+    static int count( std::string const& text, std::string const& pattern )
+    {
+        int result = 0;
+        for ( auto pos = text.find( pattern ); pos != std::string::npos; pos = text.find( pattern, pos + 1 ) )
+        {
+            ++result;
+        }
+        return result;
+    }
+};
+
+TEST_F(WhenWorkingWithTrace, tickPhasesAreWrittenAsChromeTraceEvents)
+{
+    Circuit circuit;
+    auto inverter0 = std::make_shared<Inverter>();
+    auto inverter1 = std::make_shared<Inverter>();
+    circuit.AddComponent( inverter0 );
+    circuit.AddComponent( inverter1 );
+    circuit.ConnectOutToIn( inverter0, 0, inverter1, 0 );
+    circuit.ConnectOutToIn( inverter1, 0, inverter0, 0 );
+    circuit.SetBufferCount( 2 );
+
+    Trace::Start();
+    EXPECT_EQ( Trace::IsRecording(), Trace::IsAvailable() );
+
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+        circuit.Tick( Component::TickMode::Parallel );
+    }
+    circuit.SetBufferCount( 0 );
+
+    Trace::Stop();
+    EXPECT_FALSE( Trace::IsRecording() );
+
+    circuit.Tick( Component::TickMode::Series );  // not recorded
+
+    std::stringstream out;
+    Trace::Write( out );
+    auto trace = out.str();
+
+    EXPECT_EQ( trace.find( "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" ), 0u );
+    EXPECT_EQ( trace.substr( trace.size() - 3 ), "]}\n" );
+
+    if ( !Trace::IsAvailable() )
+    {
+        EXPECT_EQ( count( trace, "\"ph\":\"B\"" ), 0 );
+        return;
+    }
+
+    // 8 circuit ticks, each processing 2 inverters
+    EXPECT_EQ( count( trace, "\"name\":\"Tick\"" ), 16 );
+    EXPECT_EQ( count( trace, "\"name\":\"WhenWorkingWithTrace::Inverter\"" ), 32 );
+    EXPECT_EQ( count( trace, "\"ph\":\"B\"" ), count( trace, "\"ph\":\"E\"" ) );
+
+    // each buffer is ticked by its own named thread
+    EXPECT_EQ( count( trace, "\"name\":\"CircuitThread 0\"" ), 1 );
+    EXPECT_EQ( count( trace, "\"name\":\"CircuitThread 1\"" ), 1 );
+    EXPECT_GT( count( trace, "\"buffer\":1" ), 0 );
+}
+
+TEST_F(WhenWorkingWithTrace, fullRingsKeepTheMostRecentEvents)
+{
+    if ( !Trace::IsAvailable() )
+    {
+        return;
+    }
+
+    Circuit circuit;
+    auto inverter = std::make_shared<Inverter>();
+    circuit.AddComponent( inverter );
+
+    Trace::Start( 6 );  // rounded up to 8, i.e. 2 ticks' worth of events
+    for ( int i = 0; i < 100; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+    Trace::Stop();
+
+    std::stringstream out;
+    Trace::Write( out );
+    auto trace = out.str();
+
+    EXPECT_EQ( count( trace, "\"name\":\"Tick\"" ), 4 );
+    EXPECT_EQ( count( trace, "\"ph\":\"B\"" ), count( trace, "\"ph\":\"E\"" ) );
+}
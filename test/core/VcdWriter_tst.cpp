@@ -0,0 +1,201 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/VcdWriter.h"
+
+#include "TestCircuits.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+/**
+ * @brief Unit tests for VcdWriter class
+ */
+
+
+class WhenWorkingWithVcdWriter : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path_ = testing::TempDir() + "scottcpu_VcdWriter_tst.vcd";
+    }
+
+    void TearDown() override
+    {
+        std::remove( path_.c_str() );
+    }
+
+    // outputs 1, 0, 1, 0, ... on output 0, and a constant 1 on output 1
+    class Toggle : public Component
+    {
+    public:
+        Toggle()
+        {
+            SetOutputCount(2);
+        }
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& outputs ) override
+        {
+            onebit out;
+            state_ = !state_;
+            out.value = state_;
+            outputs.SetValue( 0, out );
+            out.value = 1;
+            outputs.SetValue( 1, out );
+        }
+
+    private:
+        bool state_ = false;
+    };
+
+    std::string read() const
+    {
+        std::ifstream file( path_ );
+        std::stringstream text;
+        text << file.rdbuf();
+        return text.str();
+    }
+
+    // the value changes following the header
+    std::string changes() const
+    {
+        auto text = read();
+        auto end = text.find( "$dumpvars" );
+        end = text.find( "$end\n", end );
+        return end == std::string::npos ? "" : text.substr( end + 5 );
+    }
+
+    std::string path_;
+};
+
+TEST_F(WhenWorkingWithVcdWriter, headerDeclaresScopedSignals)
+{
+    VcdWriter writer;
+    EXPECT_EQ( writer.AddSignal( "alu.toggle" ), 0 );
+    EXPECT_EQ( writer.AddSignal( "alu.one" ), 1 );
+    EXPECT_EQ( writer.AddSignal( "floating" ), 2 );
+
+    ASSERT_TRUE( writer.Open( path_ ) );
+    EXPECT_TRUE( writer.IsOpen() );
+    EXPECT_EQ( writer.AddSignal( "late" ), -1 );
+    writer.Close();
+    EXPECT_FALSE( writer.IsOpen() );
+
+    EXPECT_EQ( read(),
+               "$version scottcpu $end\n"
+               "$timescale 1ns $end\n"
+               "$scope module circuit $end\n"
+               "$scope module alu $end\n"
+               "$var wire 1 \" one $end\n"
+               "$var wire 1 ! toggle $end\n"
+               "$upscope $end\n"
+               "$var wire 1 # floating $end\n"
+               "$upscope $end\n"
+               "$enddefinitions $end\n"
+               "$dumpvars\n"
+               "x!\n"
+               "x\"\n"
+               "x#\n"
+               "$end\n" );
+}
+
+TEST_F(WhenWorkingWithVcdWriter, onlyChangesAreRecorded)
+{
+    Circuit circuit;
+    auto toggle = std::make_shared<Toggle>();
+    auto writer = std::make_shared<VcdWriter>();
+    writer->AddSignal( "toggle" );
+    writer->AddSignal( "one" );
+    writer->AddSignal( "floating" );
+
+    circuit.AddComponent( toggle );
+    circuit.AddComponent( writer );
+    circuit.ConnectOutToIn( toggle, 0, writer, 0 );
+    circuit.ConnectOutToIn( toggle, 1, writer, 1 );
+
+    ASSERT_TRUE( writer->Open( path_ ) );
+    for ( int i = 0; i < 4; ++i )
+    {
+        circuit.Tick( Component::TickMode::Series );
+    }
+    writer->Flush();
+
+    EXPECT_EQ( writer->GetTickCount(), 4 );
+    EXPECT_EQ( changes(), "#0\n1!\n1\"\n#1\n0!\n#2\n1!\n#3\n0!\n" );
+
+    // "one" never changes again, so only "toggle" is recorded from here on
+    for ( int i = 0; i < 2; ++i )
+    {
+        circuit.Tick( Component::TickMode::Parallel );
+    }
+    writer->Close();
+
+    EXPECT_EQ( changes(), "#0\n1!\n1\"\n#1\n0!\n#2\n1!\n#3\n0!\n#4\n1!\n#5\n0!\n" );
+}
+
+TEST_F(WhenWorkingWithVcdWriter, eventDrivenTicksKeepTheCircuitsTime)
+{
+    // the writer is processed on every tick, not just those on which its input changes
+    Circuit circuit;
+    auto counter = std::make_shared<test::Counter>( 3 );
+    auto writer = std::make_shared<VcdWriter>();
+    writer->AddSignal( "bit2" );
+
+    circuit.AddComponent( counter );
+    circuit.AddComponent( writer );
+    circuit.ConnectOutToIn( counter, 2, writer, 0 );
+
+    ASSERT_TRUE( writer->Open( path_ ) );
+    for ( int i = 0; i < 12; ++i )
+    {
+        circuit.Tick( Component::TickMode::EventDriven );
+    }
+    writer->Close();
+
+    EXPECT_EQ( writer->GetTickCount(), 12 );
+    EXPECT_EQ( changes(), "#0\n0!\n#4\n1!\n#8\n0!\n" );
+}
+
+TEST_F(WhenWorkingWithVcdWriter, ticksWaitForRoomInAFullRing)
+{
+    Circuit circuit;
+    auto toggle = std::make_shared<Toggle>();
+    auto writer = std::make_shared<VcdWriter>( 4 );
+    writer->AddSignal( "toggle" );
+
+    circuit.AddComponent( toggle );
+    circuit.AddComponent( writer );
+    circuit.ConnectOutToIn( toggle, 0, writer, 0 );
+    circuit.SetBufferCount( 3 );
+
+    ASSERT_TRUE( writer->Open( path_ ) );
+    for ( int i = 0; i < 1000; ++i )
+    {
+        circuit.Tick( Component::TickMode::Parallel );
+    }
+    circuit.SetBufferCount( 0 );
+    writer->Close();
+
+    EXPECT_EQ( writer->GetTickCount(), 1000 );
+
+    // every tick changes "toggle", in order, despite ticking on 3 threads
+    std::stringstream expected;
+    for ( int i = 0; i < 1000; ++i )
+    {
+        expected << '#' << i << '\n' << ( i % 2 == 0 ? '1' : '0' ) << "!\n";
+    }
+    EXPECT_EQ( changes(), expected.str() );
+}
@@ -0,0 +1,198 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Gate.h"
+#include "core/SubCircuit.h"
+#include "core/WordAdapters.h"
+
+/**
+ * @brief Unit tests for BitSlice and BitConcat classes
+ */
+
+
+class WhenWorkingWithWordAdapters : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    // outputs a 16-bit word that counts up by 0x0101 every tick
+    class WordCounter : public Component
+    {
+    public:
+        WordCounter()
+        {
+            SetOutputCount(1);
+        }
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& outputs ) override
+        {
+            outputs.SetWord( 0, count_ );
+            count_ = ( count_ + 0x0101 ) & 0xFFFF;
+        }
+
+    private:
+        uint64_t count_ = 0x1200;
+    };
+
+    // records the word on its input on every tick
+    class WordProbe : public Component
+    {
+    public:
+        WordProbe()
+        {
+            SetInputCount(1);
+        }
+
+        std::vector<uint64_t> words_;
+
+    protected:
+        virtual void Process( SignalBus const& inputs, SignalBus& ) override
+        {
+            auto word = inputs.GetWord( 0 );
+            words_.push_back( word != nullptr ? *word : UINT64_MAX );
+        }
+    };
+
+    // counter -> high byte sliced into bits -> each bit inverted -> concatenated -> probe
+    static std::shared_ptr<WordProbe> buildCircuit( Circuit& circuit )
+    {
+        auto counter = std::make_shared<WordCounter>();
+        auto slice = std::make_shared<BitSlice>( 8, 8 );
+        auto concat = std::make_shared<BitConcat>( 8 );
+        auto probe = std::make_shared<WordProbe>();
+
+        circuit.AddComponent( counter );
+        circuit.AddComponent( slice );
+        circuit.AddComponent( concat );
+        circuit.AddComponent( probe );
+
+        circuit.ConnectOutToIn( counter, 0, slice, 0 );
+        for ( int i = 0; i < 8; ++i )
+        {
+            auto notGate = std::make_shared<NotGate>();
+            circuit.AddComponent( notGate );
+            circuit.ConnectOutToIn( slice, i, notGate, 0 );
+            circuit.ConnectOutToIn( notGate, 0, concat, i );
+        }
+        circuit.ConnectOutToIn( concat, 0, probe, 0 );
+
+        return probe;
+    }
+};
+
+TEST_F(WhenWorkingWithWordAdapters, wordsTravelThroughBitsInEveryTickMode)
+{
+    for ( auto mode : { Component::TickMode::Series, Component::TickMode::Parallel, Component::TickMode::EventDriven } )
+    {
+        Circuit circuit;
+        auto probe = buildCircuit( circuit );
+
+        for ( int i = 0; i < 4; ++i )
+        {
+            circuit.Tick( mode );
+        }
+
+        EXPECT_THAT( probe->words_, testing::ElementsAre( 0xED, 0xEC, 0xEB, 0xEA ) );
+    }
+}
+
+TEST_F(WhenWorkingWithWordAdapters, slicesAndConcatsReadMissingBitsAsZero)
+{
+    Circuit circuit;
+    auto bit = std::make_shared<NotGate>();  // unconnected, so always outputs 1
+    auto concat = std::make_shared<BitConcat>( 4 );
+    auto slice = std::make_shared<BitSlice>( 100, 10 );  // clamped to 64 bits
+    auto probe = std::make_shared<WordProbe>();
+
+    EXPECT_EQ( slice->GetWidth(), 64 );
+    EXPECT_EQ( slice->GetOffset(), 0 );
+    EXPECT_EQ( slice->GetOutputCount(), 64 );
+
+    circuit.AddComponent( bit );
+    circuit.AddComponent( concat );
+    circuit.AddComponent( probe );
+    circuit.ConnectOutToIn( bit, 0, concat, 2 );
+    circuit.ConnectOutToIn( concat, 0, probe, 0 );
+
+    circuit.Tick( Component::TickMode::Series );
+    EXPECT_THAT( probe->words_, testing::ElementsAre( 0x4 ) );
+}
+
+TEST_F(WhenWorkingWithWordAdapters, clonesKeepTheirWidthAndOffset)
+{
+    auto sub = std::make_shared<SubCircuit>( std::vector<std::string>{ "word" }, std::vector<std::string>{ "word" } );
+    auto slice = std::make_shared<BitSlice>( 4, 8 );
+    auto concat = std::make_shared<BitConcat>( 4 );
+    sub->AddComponent( slice );
+    sub->AddComponent( concat );
+    sub->ConnectInToIn( "word", slice, 0 );
+    for ( int i = 0; i < 4; ++i )
+    {
+        sub->ConnectOutToIn( slice, i, concat, 3 - i );  // reversed
+    }
+    sub->ConnectOutToOut( concat, 0, "word" );
+
+    Circuit circuit;
+    auto counter = std::make_shared<WordCounter>();
+    auto instance = sub->Instantiate();
+    auto probe = std::make_shared<WordProbe>();
+    ASSERT_NE( instance, nullptr );
+
+    circuit.AddComponent( counter );
+    circuit.AddComponent( instance );
+    circuit.AddComponent( probe );
+    circuit.ConnectOutToIn( counter, 0, instance, 0 );
+    circuit.ConnectOutToIn( instance, 0, probe, 0 );
+
+    circuit.Tick( Component::TickMode::Series );
+    circuit.Tick( Component::TickMode::Series );
+
+    // bits 8 to 11 of 0x1200 and 0x1301, reversed
+    EXPECT_THAT( probe->words_, testing::ElementsAre( 0x4, 0xC ) );
+}
+
+TEST_F(WhenWorkingWithWordAdapters, wordsAreSavedAndRestored)
+{
+    Circuit circuit;
+    buildCircuit( circuit );
+    circuit.Tick( Component::TickMode::Series );
+    auto state = circuit.SaveState();
+
+    Circuit copy;
+    auto probe = buildCircuit( copy );
+    copy.Compile();
+    EXPECT_TRUE( copy.RestoreState( state ) );
+    EXPECT_EQ( copy.SaveState(), state );
+
+    // a circuit with no words set yet has a smaller state, but restores just the same
+    Circuit fresh;
+    buildCircuit( fresh );
+    fresh.Compile();
+    auto emptyState = fresh.SaveState();
+    EXPECT_LT( emptyState.size(), state.size() );
+    EXPECT_TRUE( copy.RestoreState( emptyState ) );
+    EXPECT_EQ( copy.SaveState(), emptyState );
+    EXPECT_TRUE( copy.RestoreState( state ) );
+
+    // truncated word values
+    state.pop_back();
+    EXPECT_FALSE( copy.RestoreState( state ) );
+    EXPECT_TRUE( probe->words_.empty() );
+}
@@ -0,0 +1,201 @@
+/**
+ * Copyright (c) 2014-present, The scottcpu authors
+ *
+ * This source code is licensed as defined by the LICENSE file found in the
+ * root directory of this source tree.
+ *
+ * SPDX-License-Identifier: (Apache-2.0 OR GPL-2.0-only)
+ */
+
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+
+#include "core/Circuit.h"
+#include "core/Memory.h"
+#include "cpu/ReferenceCpu.h"
+
+/**
+ * @brief Unit tests for ReferenceCpu class
+ */
+
+
+class WhenWorkingWithReferenceCpu : public testing::Test
+{
+protected:
+    void SetUp() override
+    {
+    }
+
+    void TearDown() override
+    {
+    }
+
+    // outputs a constant address, with "enable" set, to read a memory
+    class Reader : public Component
+    {
+    public:
+        Reader( uint8_t address )
+            : address_( address )
+        {
+            SetOutputCount( 8 + 8 + 2 );
+        }
+
+    protected:
+        virtual void Process( SignalBus const&, SignalBus& outputs ) override
+        {
+            for ( int i = 0; i < GetOutputCount(); ++i )
+            {
+                onebit bit;
+                bit.value = i < 8 ? ( address_ >> i ) & 1 : i == GetOutputCount() - 1;
+                outputs.SetValue( i, bit );
+            }
+        }
+
+    private:
+        uint8_t address_;
+    };
+
+    // records its 8 inputs as a byte on every tick
+    class Probe : public Component
+    {
+    public:
+        Probe()
+        {
+            SetInputCount( 8 );
+        }
+
+        std::vector<int> values_;
+
+    protected:
+        virtual void Process( SignalBus const& inputs, SignalBus& ) override
+        {
+            int value = 0;
+            for ( int i = 0; i < 8; ++i )
+            {
+                auto bit = inputs.GetValue( i );
+                value |= ( bit != nullptr && bit->value ) << i;
+            }
+            values_.push_back( value );
+        }
+    };
+
+    // sums 10 + 9 + ... + 1 into R0, stores it at 0x80, then loops forever
+    static ReferenceCpu::State sumProgram()
+    {
+        ReferenceCpu::State state;
+        std::vector<uint8_t> program = {
+            0x20, 0x00,  //  0: DATA R0, 0
+            0x21, 0x0A,  //  2: DATA R1, 10
+            0x22, 0xFF,  //  4: DATA R2, -1
+            0x60,        //  6: CLF
+            0x84,        //  7: ADD R1, R0
+            0x60,        //  8: CLF
+            0x89,        //  9: ADD R2, R1
+            0x51, 0x0E,  // 10: JZ 14
+            0x40, 0x06,  // 12: JMP 6
+            0x23, 0x80,  // 14: DATA R3, 0x80
+            0x1C,        // 16: ST R3, R0
+            0x40, 0x11,  // 17: JMP 17
+        };
+        std::copy( program.begin(), program.end(), state.ram.begin() );
+        return state;
+    }
+
+    // executes a single ALU instruction on R0 = a, R1 = b
+    static ReferenceCpu::State alu( int op, uint8_t a, uint8_t b, bool carry = false )
+    {
+        ReferenceCpu::State state;
+        state.registers = { { a, b, 0, 0 } };
+        state.carry = carry;
+        state.ram[0] = (uint8_t)( 0x80 | ( op << 4 ) | ( 0 << 2 ) | 1 );
+
+        ReferenceCpu cpu;
+        cpu.SetState( state );
+        cpu.Step();
+        return cpu.GetState();
+    }
+};
+
+TEST_F(WhenWorkingWithReferenceCpu, programsRunToCompletion)
+{
+    ReferenceCpu cpu;
+    cpu.SetState( sumProgram() );
+    cpu.Run( 200 );
+
+    auto& state = cpu.GetState();
+    EXPECT_EQ( state.registers[0], 55 );
+    EXPECT_EQ( state.registers[1], 0 );
+    EXPECT_EQ( state.ram[0x80], 55 );
+    EXPECT_EQ( state.iar, 0x11 );
+    EXPECT_EQ( state.ir, 0x40 );
+}
+
+TEST_F(WhenWorkingWithReferenceCpu, aluInstructionsSetTheFlags)
+{
+    auto add = alu( 0, 0xF0, 0x20, true );
+    EXPECT_EQ( add.registers[1], 0x11 );
+    EXPECT_TRUE( add.carry );
+    EXPECT_TRUE( add.aLarger );
+    EXPECT_FALSE( add.zero );
+
+    auto shr = alu( 1, 0x03, 0, true );
+    EXPECT_EQ( shr.registers[1], 0x81 );
+    EXPECT_TRUE( shr.carry );
+
+    auto shl = alu( 2, 0x81, 0 );
+    EXPECT_EQ( shl.registers[1], 0x02 );
+    EXPECT_TRUE( shl.carry );
+
+    auto notA = alu( 3, 0xFF, 7 );
+    EXPECT_EQ( notA.registers[1], 0 );
+    EXPECT_TRUE( notA.zero );
+    EXPECT_FALSE( notA.carry );
+
+    EXPECT_EQ( alu( 4, 0x0C, 0x0A ).registers[1], 0x08 );
+    EXPECT_EQ( alu( 5, 0x0C, 0x0A ).registers[1], 0x0E );
+    EXPECT_EQ( alu( 6, 0x0C, 0x0A ).registers[1], 0x06 );
+
+    auto cmp = alu( 7, 5, 5 );
+    EXPECT_EQ( cmp.registers[1], 5 );
+    EXPECT_TRUE( cmp.equal );
+    EXPECT_FALSE( cmp.aLarger );
+    EXPECT_TRUE( cmp.zero );
+}
+
+TEST_F(WhenWorkingWithReferenceCpu, ramTransfersToAndFromAMemory)
+{
+    ReferenceCpu cpu;
+    cpu.SetState( sumProgram() );
+    cpu.Run( 200 );
+
+    // fast-forward the model, then hand its RAM over to a circuit
+    Circuit circuit;
+    auto reader = std::make_shared<Reader>( 0x80 );
+    auto ram = std::make_shared<Memory>( 8 );
+    auto probe = std::make_shared<Probe>();
+    circuit.AddComponent( reader );
+    circuit.AddComponent( ram );
+    circuit.AddComponent( probe );
+    for ( int i = 0; i < ram->GetInputCount(); ++i )
+    {
+        circuit.ConnectOutToIn( reader, i, ram, i );
+    }
+    for ( int i = 0; i < 8; ++i )
+    {
+        circuit.ConnectOutToIn( ram, i, probe, i );
+    }
+
+    ASSERT_TRUE( cpu.StoreRam( *ram ) );
+    circuit.Tick( Component::TickMode::Series );
+    EXPECT_THAT( probe->values_, testing::ElementsAre( 55 ) );
+
+    // and back
+    ReferenceCpu copy;
+    ASSERT_TRUE( copy.LoadRam( *ram ) );
+    EXPECT_EQ( copy.GetState().ram, cpu.GetState().ram );
+
+    // only a 256-byte memory will do
+    Memory small( 4 );
+    EXPECT_FALSE( cpu.StoreRam( small ) );
+    EXPECT_FALSE( copy.LoadRam( small ) );
+}